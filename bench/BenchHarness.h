@@ -0,0 +1,136 @@
+// ============================================================================
+// FILE: bench/BenchHarness.h
+// Description: Minimal benchmark harness: times a body over N operations
+//              (after warmup runs, repeated, keeping the median and the
+//              fastest run), counts heap allocations through a replaced
+//              global operator new, and writes every result as JSON and CSV
+//              so runs can be diffed between releases. Include from exactly
+//              one .cpp per program (it defines operator new/delete).
+// ============================================================================
+
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+#include "common.h"
+#include <algorithm>
+#include <new>
+#include <cstdlib>
+
+using BenchClock = std::chrono::steady_clock;
+
+// Results are written here so the optimizer keeps the timed loops
+static std::atomic<uint64_t> benchSink{0};
+
+// Every heap allocation in the program goes through here
+static std::atomic<uint64_t> benchAllocations{0};
+
+void* operator new(size_t size) {
+    benchAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+struct BenchResult {
+    std::string name;
+    size_t size;        // Roster size the benchmark ran against
+    uint64_t ops;
+    int runs;           // Timed runs; the figures below are per operation
+    double nsPerOp;     // Median run
+    double minNsPerOp;  // Fastest run
+    double opsPerSec;   // Median run
+    double allocsPerOp; // Median run
+};
+
+class BenchReporter {
+private:
+    std::vector<BenchResult> results;
+    std::string filter;  // Only run benchmarks whose name contains this
+    int warmups;         // Untimed runs first (caches, allocator, branch history)
+    int repetitions;     // Then this many timed runs
+
+public:
+    explicit BenchReporter(const std::string& nameFilter = "", int warmupRuns = 1, int timedRuns = 5)
+        : filter(nameFilter), warmups(std::max(warmupRuns, 0)), repetitions(std::max(timedRuns, 1)) {}
+
+    bool enabled(const std::string& name) const {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    }
+
+    // Run 'body' for the warmups, then time it for each repetition; every
+    // run performs 'ops' operations (so must be repeatable) and returns a
+    // value for the sink
+    template<typename F>
+    void run(const std::string& name, size_t size, uint64_t ops, F body) {
+        if (!enabled(name) || ops == 0) return;
+
+        for (int i = 0; i < warmups; ++i) benchSink += body();
+
+        std::vector<std::pair<double, uint64_t>> timed;  // (ns, allocations) per run
+        for (int i = 0; i < repetitions; ++i) {
+            uint64_t allocsBefore = benchAllocations.load();
+            auto start = BenchClock::now();
+            benchSink += body();
+            double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+            timed.emplace_back(ns, benchAllocations.load() - allocsBefore);
+        }
+        std::sort(timed.begin(), timed.end());
+        double ns = timed[timed.size() / 2].first;
+        uint64_t allocs = timed[timed.size() / 2].second;
+
+        BenchResult result{name, size, ops, repetitions, ns / ops, timed.front().first / ops,
+                           ops / (ns / 1e9), double(allocs) / ops};
+        results.push_back(result);
+        std::cout << std::left << std::setw(34) << name << std::setw(10) << size
+                  << std::right << std::fixed << std::setprecision(1) << std::setw(12) << result.nsPerOp
+                  << std::setw(12) << result.minNsPerOp
+                  << std::setprecision(0) << std::setw(14) << result.opsPerSec
+                  << std::setprecision(2) << std::setw(10) << result.allocsPerOp << std::endl;
+    }
+
+    void printHeader() const {
+        std::cout << std::left << std::setw(34) << "benchmark" << std::setw(10) << "size"
+                  << std::right << std::setw(12) << "ns/op" << std::setw(12) << "min ns/op"
+                  << std::setw(14) << "ops/sec" << std::setw(10) << "allocs/op" << std::endl;
+        std::cout << "(median of " << repetitions << " runs after " << warmups << " warmup)" << std::endl;
+    }
+
+    bool writeJSON(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) return false;
+        out << "{\n  \"timestamp\": \"" << getCurrentTimestamp() << "\",\n"
+            << "  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            out << (i ? ",\n" : "\n") << std::setprecision(17)
+                << "    {\"name\": \"" << r.name << "\", \"size\": " << r.size
+                << ", \"ops\": " << r.ops << ", \"runs\": " << r.runs
+                << ", \"ns_per_op\": " << r.nsPerOp << ", \"min_ns_per_op\": " << r.minNsPerOp
+                << ", \"ops_per_sec\": " << r.opsPerSec
+                << ", \"allocs_per_op\": " << r.allocsPerOp << "}";
+        }
+        out << "\n  ]\n}\n";
+        return static_cast<bool>(out);
+    }
+
+    bool writeCSV(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) return false;
+        out << "name,size,ops,runs,ns_per_op,min_ns_per_op,ops_per_sec,allocs_per_op\n"
+            << std::setprecision(17);
+        for (const BenchResult& r : results) {
+            out << r.name << "," << r.size << "," << r.ops << "," << r.runs << "," << r.nsPerOp << ","
+                << r.minNsPerOp << "," << r.opsPerSec << "," << r.allocsPerOp << "\n";
+        }
+        return static_cast<bool>(out);
+    }
+};
+
+#endif // BENCHHARNESS_H
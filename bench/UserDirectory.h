@@ -0,0 +1,104 @@
+// ============================================================================
+// FILE: bench/UserDirectory.h
+// Description: Bench-only baseline - the hash-indexed directory over
+//              shared_ptr<User> that SystemManager held before UserStore:
+//              O(1) lookup by employee ID and by (non-unique) full name
+// ============================================================================
+
+#ifndef USERDIRECTORY_H
+#define USERDIRECTORY_H
+
+#include "common.h"
+#include "User.h"
+#include <unordered_map>
+
+class UserDirectory {
+private:
+    // Primary index: employee ID -> user (IDs are unique)
+    std::unordered_map<std::string, std::shared_ptr<User>> byId;
+
+    // Secondary index: full name -> users with that name, in insertion order
+    std::unordered_map<std::string, std::vector<std::shared_ptr<User>>> byName;
+
+    void indexName(const std::shared_ptr<User>& user) {
+        byName[user->getName()].push_back(user);
+    }
+
+    void unindexName(const std::shared_ptr<User>& user) {
+        auto it = byName.find(user->getName());
+        if (it == byName.end()) return;
+
+        auto& bucket = it->second;
+        bucket.erase(std::remove(bucket.begin(), bucket.end(), user), bucket.end());
+        if (bucket.empty()) {
+            byName.erase(it);
+        }
+    }
+
+public:
+    // Rebuild both indexes from the user list (first occurrence of an ID wins)
+    void rebuild(const std::vector<std::shared_ptr<User>>& users) {
+        clear();
+        byId.reserve(users.size());
+        for (const auto& user : users) {
+            add(user);
+        }
+    }
+
+    // Keep the indexes in sync with roster changes
+    void add(const std::shared_ptr<User>& user) {
+        // Keep the first user registered under an ID, like the old linear scan did
+        byId.emplace(user->getId(), user);
+        indexName(user);
+    }
+
+    void remove(const std::shared_ptr<User>& user) {
+        auto it = byId.find(user->getId());
+        if (it != byId.end() && it->second == user) {
+            byId.erase(it);
+        }
+        unindexName(user);
+    }
+
+    // Rename a user and move it in the name index (use instead of User::setName)
+    void rename(const std::shared_ptr<User>& user, const std::string& newName) {
+        unindexName(user);
+        user->setName(newName);
+        indexName(user);
+    }
+
+    // Lookups, return nullptr if not found
+    std::shared_ptr<User> findById(const std::string& id) const {
+        auto it = byId.find(id);
+        return it != byId.end() ? it->second : nullptr;
+    }
+
+    // Oldest match
+    std::shared_ptr<User> findByName(const std::string& name) const {
+        auto it = byName.find(name);
+        return it != byName.end() ? it->second.front() : nullptr;
+    }
+
+    // Exact ID first, then exact name
+    std::shared_ptr<User> find(const std::string& searchTerm) const {
+        auto user = findById(searchTerm);
+        return user ? user : findByName(searchTerm);
+    }
+
+    // All users sharing a name (empty if none)
+    std::vector<std::shared_ptr<User>> findAllByName(const std::string& name) const {
+        auto it = byName.find(name);
+        return it != byName.end() ? it->second : std::vector<std::shared_ptr<User>>();
+    }
+
+    size_t size() const {
+        return byId.size();
+    }
+
+    void clear() {
+        byId.clear();
+        byName.clear();
+    }
+};
+
+#endif // USERDIRECTORY_H
@@ -0,0 +1,393 @@
+// ============================================================================
+// FILE: bench/badge_traffic.cpp
+// Description: Badge-traffic workloads for capacity planning. 'generate'
+//              writes a swipe trace from the roster in data/users.csv with a
+//              diurnal arrival curve, a floor mix, a clearance mix and hot
+//              employees; 'replay' runs a trace through findUser +
+//              Floor::attemptAccess, as fast as possible, at a fixed rate or
+//              at the trace's own timing (optionally sped up), and reports
+//              throughput and latency percentiles. Replay works on a copy of
+//              data/ in a badge_replay/ directory, removed at exit, so its
+//              audit segments and saves never reach the live data.
+//
+// Usage (run where data/users.csv lives, e.g. after main.exe --generate):
+//   badge_traffic.exe generate [--out FILE] [--swipes N] [--days D] [--seed S]
+//                     [--floors w1,w2,w3,w4] [--clearance w0,w1,w2,w3]
+//                     [--hot FRACTION:SHARE] [--curve w0,...,w23]
+//   badge_traffic.exe replay [--trace FILE] [--rate SWIPES_PER_SEC | --speedup FACTOR]
+//                     [--limit N] [--csv FILE]
+// ============================================================================
+
+#include "common.h"
+#include "DataManager.h"
+#include "LatencyHistogram.h"
+#include "SystemManager.h"
+#include <cstring>
+#include <filesystem>
+
+using BenchClock = std::chrono::steady_clock;
+
+static const char* REPLAY_DIR = "badge_replay";
+
+// --- Trace file: 64-byte header, then 32-byte swipes in time order ---
+
+struct TraceHeader {
+    char magic[8];           // "SCSTRACE"
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t recordCount;
+    uint64_t seed;
+    uint64_t durationSeconds;
+    char reserved[24];
+};
+
+struct TraceSwipe {
+    int64_t atMicros;        // Offset from the start of the trace
+    char floorId[8];         // Zero-padded
+    char employeeId[16];     // Zero-padded
+};
+
+static_assert(sizeof(TraceHeader) == 64, "TraceHeader must stay 64 bytes");
+static_assert(sizeof(TraceSwipe) == 32, "TraceSwipe must stay 32 bytes");
+
+static const char TRACE_MAGIC[8] = {'S', 'C', 'S', 'T', 'R', 'A', 'C', 'E'};
+
+// Office day: quiet nights, morning arrival peak, lunch, evening departures
+static const std::vector<double> DEFAULT_CURVE = {
+    1, 1, 1, 1, 1, 2, 6, 25, 60, 35, 20, 22, 40, 38, 20, 18, 25, 45, 20, 8, 4, 3, 2, 1
+};
+
+typedef std::map<std::string, std::string> Options;
+
+static Options parseOptions(int argc, char* argv[], int first) {
+    Options options;
+    for (int i = first; i + 1 < argc; i += 2) {
+        options[argv[i]] = argv[i + 1];
+    }
+    return options;
+}
+
+static std::string option(const Options& options, const std::string& name, const std::string& fallback) {
+    auto it = options.find(name);
+    return it != options.end() ? it->second : fallback;
+}
+
+static std::vector<double> parseWeights(const std::string& list) {
+    std::vector<double> weights;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        weights.push_back(std::stod(item));
+    }
+    return weights;
+}
+
+// --- generate ---
+
+// Employees of one clearance level; the first 'hot' of them (in shuffled
+// order) take 'hotShare' of the level's swipes
+struct ClearanceGroup {
+    std::vector<std::string> ids;
+    size_t hot = 0;
+};
+
+static int generate(const Options& options) {
+    std::string outPath = option(options, "--out", "trace.bin");
+    uint64_t swipes = std::stoull(option(options, "--swipes", "1000000"));
+    uint64_t days = std::stoull(option(options, "--days", "1"));
+    uint64_t seed = std::stoull(option(options, "--seed", "1"));
+    std::vector<double> floorWeights = parseWeights(option(options, "--floors", "50,30,15,5"));
+    std::vector<double> levelWeights = parseWeights(option(options, "--clearance", "40,30,20,10"));
+    std::vector<double> curve = options.count("--curve") ? parseWeights(options.at("--curve")) : DEFAULT_CURVE;
+    std::string hot = option(options, "--hot", "0.05:0.5");
+    double hotFraction = std::stod(hot.substr(0, hot.find(':')));
+    double hotShare = std::stod(hot.substr(hot.find(':') + 1));
+
+    if (curve.size() != 24 || levelWeights.size() != 4 || floorWeights.empty() || days == 0) {
+        std::cerr << "Need 24 curve weights, 4 clearance weights, at least one floor and one day" << std::endl;
+        return 1;
+    }
+
+    // Roster: IDs grouped by clearance level
+    std::ifstream roster(DATA_FILE);
+    if (!roster) {
+        std::cerr << "Could not open " << DATA_FILE << std::endl;
+        return 1;
+    }
+    DataManager parser;
+    std::vector<ClearanceGroup> groups(4);
+    std::string line;
+    std::getline(roster, line);  // Header
+    while (std::getline(roster, line)) {
+        auto fields = parser.parseCSVLine(line);
+        if (fields.size() < 7 || fields[6] != "USER") continue;
+        int level = std::stoi(fields[5]);
+        if (level >= 0 && level < 4) groups[level].ids.push_back(fields[0]);
+    }
+
+    std::mt19937_64 gen(seed);
+    for (size_t level = 0; level < 4; ++level) {
+        auto& group = groups[level];
+        std::shuffle(group.ids.begin(), group.ids.end(), gen);
+        group.hot = static_cast<size_t>(group.ids.size() * hotFraction);
+        if (group.ids.empty()) levelWeights[level] = 0;  // Nobody to swipe
+    }
+    std::discrete_distribution<size_t> pickLevel(levelWeights.begin(), levelWeights.end());
+    std::discrete_distribution<size_t> pickFloor(floorWeights.begin(), floorWeights.end());
+    std::bernoulli_distribution pickHot(hotShare);
+    if (std::all_of(levelWeights.begin(), levelWeights.end(), [](double w) { return w == 0; })) {
+        std::cerr << "No users in the roster" << std::endl;
+        return 1;
+    }
+
+    FILE* out = std::fopen(outPath.c_str(), "wb");
+    if (!out) {
+        std::cerr << "Could not open " << outPath << " for writing" << std::endl;
+        return 1;
+    }
+    TraceHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = 1;
+    header.recordSize = sizeof(TraceSwipe);
+    header.recordCount = swipes;
+    header.seed = seed;
+    header.durationSeconds = days * 86400;
+    std::fwrite(&header, sizeof(header), 1, out);
+
+    // Swipes per hour follow the curve (remainders carried so the total is
+    // exact); within an hour arrivals are uniform, sorted before writing
+    double curveTotal = 0;
+    for (double w : curve) curveTotal += w;
+    double carry = 0;
+    uint64_t written = 0;
+    std::vector<TraceSwipe> hour;
+    for (uint64_t h = 0; h < days * 24; ++h) {
+        double exact = swipes * (curve[h % 24] / curveTotal) / days + carry;
+        uint64_t n = h + 1 == days * 24 ? swipes - written : static_cast<uint64_t>(exact);
+        carry = exact - n;
+
+        std::uniform_int_distribution<int64_t> within(0, 3600LL * 1000000 - 1);
+        hour.assign(n, TraceSwipe());
+        for (auto& swipe : hour) {
+            std::memset(&swipe, 0, sizeof(swipe));
+            swipe.atMicros = static_cast<int64_t>(h) * 3600LL * 1000000 + within(gen);
+
+            const ClearanceGroup& group = groups[pickLevel(gen)];
+            size_t index;
+            if (group.hot > 0 && pickHot(gen)) {
+                index = std::uniform_int_distribution<size_t>(0, group.hot - 1)(gen);
+            } else {
+                index = std::uniform_int_distribution<size_t>(0, group.ids.size() - 1)(gen);
+            }
+            std::string floorId = "F" + std::to_string(pickFloor(gen) + 1);
+            std::strncpy(swipe.floorId, floorId.c_str(), sizeof(swipe.floorId) - 1);
+            std::strncpy(swipe.employeeId, group.ids[index].c_str(), sizeof(swipe.employeeId) - 1);
+        }
+        std::sort(hour.begin(), hour.end(), [](const TraceSwipe& a, const TraceSwipe& b) {
+            return a.atMicros < b.atMicros;
+        });
+        if (!hour.empty() && std::fwrite(hour.data(), sizeof(TraceSwipe), hour.size(), out) != hour.size()) {
+            std::cerr << "Write to " << outPath << " failed" << std::endl;
+            std::fclose(out);
+            return 1;
+        }
+        written += n;
+    }
+    std::fclose(out);
+
+    std::cout << "Wrote " << written << " swipes over " << days << " day(s) to " << outPath << std::endl;
+    return 0;
+}
+
+// --- replay ---
+
+static void printRow(const char* name, const LatencyHistogram& h) {
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << h.mean() / 1000.0;
+    const double percentiles[] = {50, 90, 99, 99.9, 99.99};
+    for (double p : percentiles) {
+        std::cout << std::setw(10) << h.valueAtPercentile(p) / 1000.0;
+    }
+    std::cout << std::setw(12) << h.max() / 1000.0 << std::endl;
+}
+
+// Percentile distribution, one line per non-empty bucket
+static bool writeDistribution(const std::string& path, const std::vector<std::pair<std::string, const LatencyHistogram*>>& all) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "histogram,value_ns,percentile,count\n";
+    for (const auto& named : all) {
+        const LatencyHistogram& h = *named.second;
+        uint64_t seen = 0;
+        for (size_t b = 0; b < h.bucketCount(); ++b) {
+            if (h.bucketTotal(b) == 0) continue;
+            seen += h.bucketTotal(b);
+            out << named.first << "," << std::min(h.bucketHighest(b), h.max()) << ","
+                << std::setprecision(6) << 100.0 * seen / h.count() << "," << h.bucketTotal(b) << "\n";
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+// Copy the data files into REPLAY_DIR/data (keeping their times, so the
+// snapshot still matches the CSV) and move there
+static bool enterScratch() {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::remove_all(REPLAY_DIR, ec);
+    fs::create_directories(fs::path(REPLAY_DIR) / "data", ec);
+    for (const std::string& file : {DATA_FILE, SNAPSHOT_FILE, JOURNAL_FILE, SITE_FILE, EXCEPTIONS_FILE}) {
+        if (ec || !fs::exists(file)) continue;
+        fs::copy_file(file, fs::path(REPLAY_DIR) / file, ec);
+        if (!ec) fs::last_write_time(fs::path(REPLAY_DIR) / file, fs::last_write_time(file), ec);
+    }
+    if (!ec) fs::current_path(REPLAY_DIR, ec);
+    if (ec) {
+        std::cerr << "Could not set up " << REPLAY_DIR << ": " << ec.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Swipe i is due i / rate seconds in (rate > 0), or its trace time divided
+// by speedup past the first swipe's (speedup > 0); otherwise right away
+static int replaySwipes(FILE* in, const TraceHeader& header, uint64_t total, double rate,
+                        double speedup, const std::string& csvPath) {
+    SystemManager system;
+    system.initialize();
+    const UserStore& users = system.getUsers();
+    // Trace floor IDs name floors or doors, both hash-indexed by the site
+    SiteModel& site = system.getSite();
+
+    LatencyHistogram lookup, access, swipe;
+    uint64_t granted = 0, denied = 0, unknown = 0;
+    std::vector<TraceSwipe> block(4096);
+    uint64_t done = 0;
+
+    // When paced, swipe latency counts from when the swipe was due, so a
+    // stall shows up in every swipe queued behind it
+    bool paced = rate > 0 || speedup > 0;
+    int64_t firstMicros = 0;
+    auto start = BenchClock::now();
+    while (done < total) {
+        size_t want = static_cast<size_t>(std::min<uint64_t>(block.size(), total - done));
+        size_t got = std::fread(block.data(), sizeof(TraceSwipe), want, in);
+        if (got == 0) break;
+
+        for (size_t i = 0; i < got; ++i, ++done) {
+            const TraceSwipe& rec = block[i];
+            auto due = BenchClock::now();
+            if (paced) {
+                if (done == 0) firstMicros = rec.atMicros;
+                double offsetNs = rate > 0 ? done * 1e9 / rate : (rec.atMicros - firstMicros) * 1e3 / speedup;
+                due = start + std::chrono::nanoseconds(static_cast<int64_t>(offsetNs));
+                if (due - BenchClock::now() > std::chrono::microseconds(200)) {
+                    std::this_thread::sleep_until(due - std::chrono::microseconds(100));
+                }
+                while (BenchClock::now() < due) {
+                }
+            }
+
+            std::string employeeId(rec.employeeId, strnlen(rec.employeeId, sizeof(rec.employeeId)));
+            std::string floorId(rec.floorId, strnlen(rec.floorId, sizeof(rec.floorId)));
+
+            auto t0 = BenchClock::now();
+            UserHandle user = system.findUser(employeeId);
+            auto t1 = BenchClock::now();
+            SiteId floor = site.findById(floorId);
+            if (user == NO_USER || floor == NO_SITE || site.getKind(floor) == SiteKind::BUILDING) {
+                ++unknown;
+            } else if (site.attemptAccess(floor, user, employeeId, std::string(users.getName(user)),
+                                          users.getClearanceLevel(user))) {
+                ++granted;
+            } else {
+                ++denied;
+            }
+            auto t2 = BenchClock::now();
+
+            lookup.record(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            if (user != NO_USER && floor != NO_SITE && site.getKind(floor) != SiteKind::BUILDING) {
+                access.record(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count());
+            }
+            swipe.record(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - due).count());
+        }
+    }
+    double seconds = std::chrono::duration<double>(BenchClock::now() - start).count();
+
+    std::ostringstream pacing;
+    if (rate > 0) pacing << " (target " << static_cast<uint64_t>(rate) << "/s)";
+    else if (speedup > 0) pacing << " (trace timing x" << speedup << ")";
+    else pacing << " (unthrottled)";
+    std::cout << "\n" << done << " swipes in " << std::fixed << std::setprecision(2) << seconds << " s: "
+              << std::setprecision(0) << done / seconds << " swipes/s" << pacing.str() << std::endl;
+    std::cout << "granted " << granted << ", denied " << denied << ", unknown " << unknown << std::endl;
+    std::cout << "trace covers " << header.durationSeconds / 3600.0 << " h: "
+              << std::setprecision(1) << header.recordCount / (header.durationSeconds / 3600.0)
+              << " swipes/h on average\n" << std::endl;
+
+    std::cout << std::left << std::setw(16) << "latency (us)" << std::right
+              << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p90"
+              << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "p99.99"
+              << std::setw(12) << "max" << std::endl;
+    printRow("findUser", lookup);
+    printRow("attemptAccess", access);
+    printRow("swipe", swipe);
+
+    if (!csvPath.empty() &&
+        !writeDistribution(csvPath, {{"findUser", &lookup}, {"attemptAccess", &access}, {"swipe", &swipe}})) {
+        std::cerr << "Could not write " << csvPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+static int replay(const Options& options) {
+    std::string tracePath = option(options, "--trace", "trace.bin");
+    double rate = std::stod(option(options, "--rate", "0"));
+    double speedup = std::stod(option(options, "--speedup", "0"));
+    uint64_t limit = std::stoull(option(options, "--limit", "0"));
+    std::string csvPath = option(options, "--csv", "");
+    if (rate < 0 || speedup < 0 || (rate > 0 && speedup > 0)) {
+        std::cerr << "Give at most one of --rate and --speedup, each above zero" << std::endl;
+        return 1;
+    }
+
+    FILE* in = std::fopen(tracePath.c_str(), "rb");
+    TraceHeader header;
+    if (!in || std::fread(&header, sizeof(header), 1, in) != 1 ||
+        std::memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.recordSize != sizeof(TraceSwipe)) {
+        std::cerr << "Not a swipe trace: " << tracePath << std::endl;
+        if (in) std::fclose(in);
+        return 1;
+    }
+    uint64_t total = limit ? std::min(limit, header.recordCount) : header.recordCount;
+
+    // The output path is relative to where we were started
+    if (!csvPath.empty()) csvPath = std::filesystem::absolute(csvPath).string();
+    std::filesystem::path home = std::filesystem::current_path();
+    if (!enterScratch()) {
+        std::fclose(in);
+        return 1;
+    }
+    int status = replaySwipes(in, header, total, rate, speedup, csvPath);
+    std::fclose(in);
+    std::filesystem::current_path(home);
+    std::filesystem::remove_all(REPLAY_DIR);
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << std::unitbuf;
+    std::string command = argc > 1 ? argv[1] : "";
+    try {
+        if (command == "generate") return generate(parseOptions(argc, argv, 2));
+        if (command == "replay") return replay(parseOptions(argc, argv, 2));
+    } catch (const std::exception& e) {
+        std::cerr << "Bad option value: " << e.what() << std::endl;
+        return 1;
+    }
+    std::cerr << "Usage: badge_traffic.exe generate|replay [options] (see the file header)" << std::endl;
+    return 1;
+}
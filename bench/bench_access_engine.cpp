@@ -0,0 +1,151 @@
+// ============================================================================
+// FILE: bench/bench_access_engine.cpp
+// Description: Decisions per second of AccessEngine::decideBatch against one
+//              Floor::attemptAccess call per swipe, with and without the
+//              audit log (writes an audit_bench/ directory, removed at exit),
+//              and small batches on a site with many floors
+// ============================================================================
+
+#include "common.h"
+#include "AccessEngine.h"
+#include <filesystem>
+
+using BenchClock = std::chrono::steady_clock;
+
+// Results are written here so the optimizer keeps the timed loops
+static volatile uint64_t benchSink;
+
+static const char* BENCH_DIR = "audit_bench";
+
+static double secondsSince(BenchClock::time_point start) {
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t userCount = 100000;
+    size_t swipes = argc > 1 ? std::stoul(argv[1]) : 4000000;
+    const size_t batchSize = 1024;
+    std::cout << std::unitbuf;
+
+    std::mt19937 gen(7);
+    UserStore users;
+    users.reserve(userCount);
+    for (size_t i = 0; i < userCount; ++i) {
+        users.add("EMP" + std::to_string(i), "Bench User", "bench@company.com", "0700000000",
+                  "CARD" + std::to_string(i + 1), intToClearanceLevel(static_cast<int>(gen() % 4)));
+    }
+    std::vector<Floor> floors;
+    floors.push_back(Floor("F1", "Ground Floor", ClearanceLevel::LEVEL_0, 1024));
+    floors.push_back(Floor("F2", "Office Floor", ClearanceLevel::LEVEL_1, 1024));
+    floors.push_back(Floor("F3", "Server Room", ClearanceLevel::LEVEL_2, 1024));
+    floors.push_back(Floor("F4", "Executive Suite", ClearanceLevel::LEVEL_3, 1024));
+
+    AccessEngine engine;
+    engine.rebuild(users, floors);
+
+    // Random swipes; a few handles past the end exercise the unknown path
+    std::vector<CardHandle> cards(swipes);
+    std::vector<FloorHandle> floorHandles(swipes);
+    for (size_t i = 0; i < swipes; ++i) {
+        cards[i] = static_cast<CardHandle>(gen() % (userCount + 16));
+        floorHandles[i] = static_cast<FloorHandle>(gen() % 5);
+    }
+
+    // Differential check: SIMD path against the scalar reference
+    for (size_t base = 0; base < swipes; base += batchSize) {
+        size_t n = std::min(batchSize, swipes - base);
+        if (engine.decideBatch(cards.data() + base, floorHandles.data() + base, n, 0) !=
+            engine.decideBatchScalar(cards.data() + base, floorHandles.data() + base, n, 0)) {
+            std::cerr << "decideBatch disagrees with the scalar path at swipe " << base << std::endl;
+            return 1;
+        }
+    }
+
+    // Per-call path only sees valid swipes (it takes a user and a Floor);
+    // cards were added in handle order, so a card handle is its user's
+    auto perCall = [&]() {
+        uint64_t granted = 0;
+        auto start = BenchClock::now();
+        for (size_t i = 0; i < swipes; ++i) {
+            if (cards[i] >= userCount || floorHandles[i] >= floors.size()) continue;
+            UserHandle user = cards[i];
+            granted += floors[floorHandles[i]].attemptAccess(user, std::string(users.getId(user)),
+                                                             std::string(users.getName(user)),
+                                                             users.getClearanceLevel(user));
+        }
+        benchSink = granted;
+        return swipes / secondsSince(start);
+    };
+
+    auto batched = [&](bool scalar) {
+        uint64_t granted = 0;
+        auto start = BenchClock::now();
+        for (size_t base = 0; base < swipes; base += batchSize) {
+            size_t n = std::min(batchSize, swipes - base);
+            auto mask = scalar
+                ? engine.decideBatchScalar(cards.data() + base, floorHandles.data() + base, n, 1700000000)
+                : engine.decideBatch(cards.data() + base, floorHandles.data() + base, n, 1700000000);
+            granted += mask[0];
+        }
+        benchSink = granted;
+        return swipes / secondsSince(start);
+    };
+
+    std::cout << std::left << std::setw(34) << "path" << "decisions/s" << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << std::setw(34) << "attemptAccess (per call)" << perCall() << std::endl;
+    std::cout << std::setw(34) << "decideBatch scalar" << batched(true) << std::endl;
+    std::cout << std::setw(34) << "decideBatch" << batched(false) << std::endl;
+
+    // Same again with every decision going to the audit log
+    std::filesystem::remove_all(BENCH_DIR);
+    {
+        AuditLog audit;
+        if (!audit.open(BENCH_DIR)) {
+            std::cerr << "Could not open " << BENCH_DIR << std::endl;
+            return 1;
+        }
+        for (auto& floor : floors) floor.setAuditLog(&audit);
+        engine.setAuditLog(&audit);
+
+        auto start = BenchClock::now();
+        perCall();
+        audit.flush();
+        double callRate = swipes / secondsSince(start);
+
+        start = BenchClock::now();
+        batched(false);
+        audit.flush();
+        double batchRate = swipes / secondsSince(start);
+
+        std::cout << std::setw(34) << "attemptAccess + audit" << callRate << std::endl;
+        std::cout << std::setw(34) << "decideBatch + bulk audit" << batchRate << std::endl;
+    }
+    std::filesystem::remove_all(BENCH_DIR);
+    engine.setAuditLog(nullptr);
+
+    // Reader-sized batches once the site has thousands of floors: a
+    // batch should cost what its swipes touch, not the whole floor table
+    const size_t extraFloors = 10000;
+    const size_t smallBatch = 16;
+    for (size_t f = 0; f < extraFloors; ++f) {
+        engine.addFloor("W" + std::to_string(f), intToClearanceLevel(static_cast<int>(f % 4)));
+    }
+    for (size_t base = 0; base + smallBatch <= swipes; base += smallBatch * 997) {
+        if (engine.decideBatch(cards.data() + base, floorHandles.data() + base, smallBatch, 0) !=
+            engine.decideBatchScalar(cards.data() + base, floorHandles.data() + base, smallBatch, 0)) {
+            std::cerr << "decideBatch disagrees with the scalar path on the wide site" << std::endl;
+            return 1;
+        }
+    }
+    uint64_t granted = 0;
+    auto start = BenchClock::now();
+    for (size_t base = 0; base + smallBatch <= swipes; base += smallBatch) {
+        granted += engine.decideBatch(cards.data() + base, floorHandles.data() + base,
+                                      smallBatch, 1700000000)[0];
+    }
+    benchSink = granted;
+    std::cout << std::setw(34) << "decideBatch, 10k floors, 16/batch" << swipes / secondsSince(start)
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,169 @@
+// ============================================================================
+// FILE: bench/bench_cache.cpp
+// Description: Multi-threaded get/put throughput of ShardedLRUCache against
+//              the plain LRUCache behind one mutex (the only safe way to share
+//              it), on a skewed key distribution; then hit rates of the
+//              eviction policies and checks of byte capacity, negative
+//              entries and invalidation
+// ============================================================================
+
+#include "common.h"
+#include "Cache.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+// Results are written here so the optimizer keeps the timed loops
+static std::atomic<uint64_t> benchSink{0};
+
+static const int CAPACITY = 4096;
+static const size_t KEY_SPACE = 16384;
+static const size_t OPS_PER_THREAD = 400000;
+
+// Skewed keys: most lookups hit a small hot set, like repeated searches
+static std::vector<std::string> makeKeys(unsigned seed) {
+    std::mt19937 gen(seed);
+    std::exponential_distribution<double> skew(1.0 / 2000.0);
+    std::vector<std::string> keys;
+    keys.reserve(OPS_PER_THREAD);
+    for (size_t i = 0; i < OPS_PER_THREAD; ++i) {
+        size_t k = static_cast<size_t>(skew(gen)) % KEY_SPACE;
+        keys.push_back("EMP" + std::to_string(k));
+    }
+    return keys;
+}
+
+// Each op: get, and put on a miss (the findUser pattern)
+template<typename Op>
+static double runThreads(size_t threads, const std::vector<std::vector<std::string>>& keys, Op op) {
+    std::vector<std::thread> workers;
+    auto start = BenchClock::now();
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            uint64_t sink = 0;
+            for (const auto& key : keys[t]) sink += op(key);
+            benchSink += sink;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(BenchClock::now() - start).count();
+    return threads * OPS_PER_THREAD / seconds;
+}
+
+// Hot keys mixed with one-off lookups (typos, unknown badges, scans)
+template<typename Policy>
+static double policyHitRate(const std::vector<std::string>& trace, size_t capacity) {
+    LRUCache<std::string, int, Policy> cache(capacity);
+    size_t hits = 0;
+    for (const auto& key : trace) {
+        if (cache.get(key)) {
+            ++hits;
+        } else {
+            cache.put(key, 1);
+        }
+    }
+    return double(hits) / trace.size();
+}
+
+static bool checkSemantics() {
+    // Byte capacity is never exceeded, whatever the key sizes
+    LRUCache<std::string, std::shared_ptr<int>, TinyLfuPolicy,
+             ByteWeigher<std::string, std::shared_ptr<int>>> bytes(64 * 1024);
+    std::mt19937 gen(3);
+    for (size_t i = 0; i < 100000; ++i) {
+        std::string key(1 + gen() % 200, static_cast<char>('a' + gen() % 26));
+        key += std::to_string(i % 5000);
+        if (!bytes.get(key)) bytes.put(key, std::make_shared<int>(1));
+        if (bytes.weight() > 64 * 1024) return false;
+    }
+
+    // A negative entry is a hit holding nullptr; invalidate() hides everything
+    ShardedLRUCache<std::string, std::shared_ptr<int>, 4, ClockPolicy> sharded(100);
+    sharded.put("missing", nullptr);
+    sharded.put("present", std::make_shared<int>(7));
+    auto miss = sharded.get("missing");
+    auto hit = sharded.get("present");
+    if (!miss || *miss != nullptr || !hit || **hit != 7) return false;
+    sharded.invalidate();
+    if (sharded.get("missing") || sharded.get("present")) return false;
+    sharded.put("present", std::make_shared<int>(8));
+    hit = sharded.get("present");
+    return hit && **hit == 8;
+}
+
+int main() {
+    std::cout << std::unitbuf;
+    if (!checkSemantics()) {
+        std::cerr << "Cache semantics check failed" << std::endl;
+        return 1;
+    }
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    size_t maxThreads = std::max<size_t>(8, cores);
+    std::cout << "hardware threads: " << cores << std::endl;
+
+    std::vector<std::vector<std::string>> keys;
+    for (size_t t = 0; t < maxThreads; ++t) keys.push_back(makeKeys(static_cast<unsigned>(t + 1)));
+
+    std::cout << std::left << std::setw(10) << "threads"
+              << std::setw(20) << "LRU+mutex ops/s"
+              << std::setw(20) << "sharded ops/s"
+              << std::setw(12) << "hit rate" << std::endl;
+
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        LRUCache<std::string, int> plain(CAPACITY);
+        std::mutex plainMutex;
+        double plainRate = runThreads(threads, keys, [&](const std::string& key) {
+            std::lock_guard<std::mutex> lock(plainMutex);
+            int* value = plain.get(key);
+            if (value) return *value;
+            plain.put(key, 1);
+            return 0;
+        });
+
+        ShardedLRUCache<std::string, int, 16> sharded(CAPACITY);
+        double shardedRate = runThreads(threads, keys, [&](const std::string& key) {
+            auto value = sharded.get(key);
+            if (value) return *value;
+            sharded.put(key, 1);
+            return 0;
+        });
+
+        CacheShardStats total = sharded.totalStats();
+        if (total.hits + total.misses != threads * OPS_PER_THREAD || total.size > CAPACITY) {
+            std::cerr << "Counter or capacity mismatch" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(10) << threads << std::fixed << std::setprecision(0)
+                  << std::setw(20) << plainRate
+                  << std::setw(20) << shardedRate
+                  << std::setprecision(3) << (double(total.hits) / (total.hits + total.misses))
+                  << std::endl;
+
+        if (threads == maxThreads) {
+            std::cout << "\nper-shard counters at " << threads << " threads:" << std::endl;
+            std::cout << std::left << std::setw(8) << "shard" << std::setw(12) << "hits"
+                      << std::setw(12) << "misses" << std::setw(12) << "evictions" << "size" << std::endl;
+            for (size_t i = 0; i < sharded.shardCount(); ++i) {
+                CacheShardStats one = sharded.shardStats(i);
+                std::cout << std::setw(8) << i << std::setw(12) << one.hits << std::setw(12) << one.misses
+                          << std::setw(12) << one.evictions << one.size << std::endl;
+            }
+        }
+    }
+
+    // Hit rates: 2000 hot keys (skewed) with every other lookup a key that
+    // is never asked for again
+    std::vector<std::string> trace;
+    std::mt19937 gen(11);
+    std::exponential_distribution<double> skew(1.0 / 300.0);
+    for (size_t i = 0; i < 400000; ++i) {
+        if (i % 2) trace.push_back("ONCE" + std::to_string(i));
+        else trace.push_back("EMP" + std::to_string(static_cast<size_t>(skew(gen)) % 2000));
+    }
+    std::cout << "\nhit rate, 1000 entries, half one-off keys:" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  LRU        " << policyHitRate<LruPolicy>(trace, 1000) << std::endl;
+    std::cout << "  CLOCK      " << policyHitRate<ClockPolicy>(trace, 1000) << std::endl;
+    std::cout << "  W-TinyLFU  " << policyHitRate<TinyLfuPolicy>(trace, 1000) << std::endl;
+    return 0;
+}
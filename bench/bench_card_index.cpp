@@ -0,0 +1,151 @@
+// ============================================================================
+// FILE: bench/bench_card_index.cpp
+// Description: Card ID -> holder lookups: the old scan over every user's
+//              card, an unordered_map, and CardIndex (frozen perfect hash,
+//              with and without pending changes in the overlay), and the
+//              flush worker's refreeze of a copy outside the lock
+// ============================================================================
+
+#include "common.h"
+#include "CardIndex.h"
+#include "User.h"
+#include <unordered_map>
+
+using BenchClock = std::chrono::steady_clock;
+
+// Run 'lookup' over all terms, return ns per lookup; 'found' counts hits
+template<typename F>
+static double timeLookups(const std::vector<std::string>& terms, F lookup, size_t& found) {
+    auto start = BenchClock::now();
+    for (const auto& term : terms) {
+        if (lookup(term) != NO_USER) ++found;
+    }
+    auto ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+    return ns / terms.size();
+}
+
+int main() {
+    const size_t sizes[] = {1000, 100000, 1000000};
+    std::mt19937 gen(42);
+
+    std::cout << std::left << std::setw(10) << "cards"
+              << std::setw(12) << "scan ns"
+              << std::setw(12) << "map ns"
+              << std::setw(12) << "frozen ns"
+              << std::setw(14) << "overlay ns"
+              << std::setw(12) << "freeze ms"
+              << "copy ms" << std::endl;
+
+    for (size_t count : sizes) {
+        std::vector<std::shared_ptr<User>> users;
+        std::vector<std::string> cardIds;
+        users.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            cardIds.push_back("CARD" + std::to_string(i + 1));
+            auto card = std::make_shared<Card>(cardIds.back(), ClearanceLevel::LEVEL_1);
+            users.push_back(std::make_shared<User>("EMP" + std::to_string(i), "Name",
+                                                   "bench@company.com", "0700000000", card));
+        }
+        cardIds.push_back("CARD_ADMIN");
+
+        std::unordered_map<std::string, UserHandle> map;
+        std::vector<CardEntry> entries;
+        for (size_t i = 0; i < count; ++i) {
+            map.emplace(cardIds[i], static_cast<UserHandle>(i));
+            entries.push_back({cardIds[i], static_cast<UserHandle>(i)});
+        }
+        map.emplace("CARD_ADMIN", ADMIN_USER);
+        entries.push_back({cardIds[count], ADMIN_USER});
+        entries.push_back({cardIds[0], 12345});  // Duplicate: first holder wins
+
+        CardIndex index;
+        auto buildStart = BenchClock::now();
+        index.build(entries);
+        double freezeMs = std::chrono::duration<double, std::milli>(BenchClock::now() - buildStart).count();
+
+        std::uniform_int_distribution<size_t> pick(0, count);
+        std::vector<std::string> hits(200000), misses(200000);
+        for (auto& term : hits) term = cardIds[pick(gen)];
+        for (size_t i = 0; i < misses.size(); ++i) misses[i] = "CARDX" + std::to_string(i);
+
+        // Old path, fewer queries at large sizes so the run stays short
+        std::vector<std::string> scanTerms(hits.begin(), hits.begin() + std::max<size_t>(20, 2000000 / count));
+        size_t scanFound = 0, mapFound = 0, frozenFound = 0, missFound = 0;
+        double scanNs = timeLookups(scanTerms, [&](const std::string& cardId) {
+            if (cardId == "CARD_ADMIN") return ADMIN_USER;
+            for (size_t i = 0; i < users.size(); ++i) {
+                if (users[i]->getCard()->getId() == cardId) return static_cast<UserHandle>(i);
+            }
+            return NO_USER;
+        }, scanFound);
+        double mapNs = timeLookups(hits, [&](const std::string& cardId) {
+            auto it = map.find(cardId);
+            return it == map.end() ? NO_USER : it->second;
+        }, mapFound);
+        double frozenNs = timeLookups(hits, [&](const std::string& cardId) {
+            return index.find(cardId);
+        }, frozenFound);
+        timeLookups(misses, [&](const std::string& cardId) { return index.find(cardId); }, missFound);
+
+        bool ok = scanFound == scanTerms.size() && mapFound == hits.size() &&
+                  frozenFound == hits.size() && missFound == 0 &&
+                  index.size() == count + 1 && index.find(cardIds[0]) == 0 &&
+                  index.find("CARD_ADMIN") == ADMIN_USER;
+        for (size_t i = 0; ok && i < count; i += 97) {
+            ok = index.find(cardIds[i]) == static_cast<UserHandle>(i);
+        }
+
+        // 1% churn: deletes and new cards wait in the overlay, then refreeze
+        for (size_t i = 0; i < count / 100; ++i) {
+            index.remove(cardIds[i * 50]);
+            index.add("CARDNEW" + std::to_string(i), static_cast<UserHandle>(count + i));
+        }
+        size_t overlayFound = 0;
+        double overlayNs = timeLookups(hits, [&](const std::string& cardId) {
+            return index.find(cardId);
+        }, overlayFound);
+        auto checkChurn = [&]() {
+            for (size_t i = 0; i < count / 100; ++i) {
+                if (index.find(cardIds[i * 50]) != NO_USER ||
+                    index.find("CARDNEW" + std::to_string(i)) != static_cast<UserHandle>(count + i)) {
+                    return false;
+                }
+            }
+            return index.size() == count + 1 && index.find(cardIds[1]) == 1;
+        };
+        ok = ok && checkChurn();
+
+        // Refreeze as the flush worker does: copy under the lock (the only
+        // part that holds it), freeze the copy, carry over later changes
+        auto copyStart = BenchClock::now();
+        CardIndex refrozen(index);
+        double copyMs = std::chrono::duration<double, std::milli>(BenchClock::now() - copyStart).count();
+        refrozen.freeze();
+        index.remove(cardIds[2]);
+        index.add("CARDLATE", static_cast<UserHandle>(2 * count));
+        refrozen.catchUp(index);
+        std::swap(index, refrozen);
+        ok = ok && index.pendingChanges() == 2 && index.find(cardIds[2]) == NO_USER &&
+             index.find("CARDLATE") == static_cast<UserHandle>(2 * count);
+        index.add(cardIds[2], 2);
+        index.remove("CARDLATE");
+        index.freeze();
+        ok = ok && index.pendingChanges() == 0 && checkChurn();
+
+        if (!ok) {
+            std::cerr << "Card lookup mismatch at " << count << " cards" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::left << std::setw(10) << count
+                  << std::setw(12) << scanNs
+                  << std::setw(12) << mapNs
+                  << std::setw(12) << frozenNs
+                  << std::setw(14) << overlayNs
+                  << std::setw(12) << freezeMs
+                  << copyMs << std::endl;
+    }
+
+    return 0;
+}
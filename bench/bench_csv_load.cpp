@@ -0,0 +1,88 @@
+// ============================================================================
+// FILE: bench/bench_csv_load.cpp
+// Description: Times DataManager::loadFromCSV against the old getline loader
+//              on a generated roster (run from a scratch directory: it writes
+//              data/users.csv relative to the working directory)
+// ============================================================================
+
+#include "common.h"
+#include "DataManager.h"
+#include "UserStore.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+// Previous loader: getline + parseCSVLine copies per field
+static void legacyLoad(DataManager& dm, std::vector<std::shared_ptr<User>>& users,
+                       std::shared_ptr<Admin>& admin) {
+    std::ifstream file(DATA_FILE);
+    std::string line;
+    std::getline(file, line);
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        auto fields = dm.parseCSVLine(line);
+        if (fields.size() < 7) continue;
+        auto card = std::make_shared<Card>(fields[4], intToClearanceLevel(std::stoi(fields[5])));
+        if (fields[6] == "ADMIN" && fields.size() >= 8) {
+            admin = std::make_shared<Admin>(fields[0], fields[1], fields[2], fields[3], card, fields[7]);
+        } else {
+            users.push_back(std::make_shared<User>(fields[0], fields[1], fields[2], fields[3], card));
+        }
+    }
+}
+
+static void writeRoster(size_t count) {
+    std::ofstream file(DATA_FILE);
+    file << "ID,Name,Email,Phone,CardID,ClearanceLevel,Type,Password\n";
+
+    // Extra trailing fields are dropped, never folded into the last one
+    file << "ADMIN,Admin User,admin@company.com,0712345678,CARD_ADMIN,3,ADMIN," << ADMIN_PASSWORD
+         << ",extra,fields\n";
+    file << "XTR,\"Extra, Quoted\",extra@company.com,0712345678,CARDX,1,USER,,more\n";
+    file << "XTR1,Extra Plain,extra1@company.com,0712345678,CARDX1,2,USER,x,y,z\n";
+    for (size_t i = 0; i < count; ++i) {
+        file << "EMP" << i << ",First" << (i % 977) << " Last" << (i % 1013)
+             << ",first" << i << ".last@company.com,07" << (10000000 + i % 89999999)
+             << ",CARD" << (i + 1) << "," << (i % 4) << ",USER\n";
+    }
+}
+
+template<typename F>
+static double timeMs(F load) {
+    auto start = BenchClock::now();
+    load();
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    std::cout << std::unitbuf;
+
+    system("mkdir -p data");
+    writeRoster(count);
+
+    DataManager dm;
+    std::vector<std::shared_ptr<User>> legacyUsers;
+    std::shared_ptr<Admin> legacyAdmin;
+
+    double legacyMs = timeMs([&]() { legacyLoad(dm, legacyUsers, legacyAdmin); });
+    UserStore store;
+    std::shared_ptr<Admin> storeAdmin;
+    double storeMs = timeMs([&]() { dm.loadFromCSV(store, storeAdmin); });
+
+    // Both loaders must produce the same roster
+    bool same = store.size() == legacyUsers.size() && legacyAdmin && storeAdmin &&
+                storeAdmin->toCSV() == legacyAdmin->toCSV();
+    for (size_t i = 0; same && i < legacyUsers.size(); ++i) {
+        same = store.toCSV(static_cast<UserHandle>(i)) == legacyUsers[i]->toCSV();
+    }
+    if (!same) {
+        std::cerr << "Loaded rosters differ" << std::endl;
+        return 1;
+    }
+
+    std::cout << count << " rows, " << std::thread::hardware_concurrency() << " threads" << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "getline loader: " << legacyMs << " ms" << std::endl
+              << "into UserStore: " << storeMs << " ms (the startup path)" << std::endl;
+    return 0;
+}
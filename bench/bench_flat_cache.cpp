@@ -0,0 +1,208 @@
+// ============================================================================
+// FILE: bench/bench_flat_cache.cpp
+// Description: Differential check of FlatLRUCache against LRUCache (LRU
+//              policy), then ns per get/put, heap allocations per op and,
+//              where perf events are available, hardware cache misses per op
+// ============================================================================
+
+#include "common.h"
+#include "Cache.h"
+#include "FlatLRUCache.h"
+#include <new>
+#include <cstdlib>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+using BenchClock = std::chrono::steady_clock;
+
+// Results are written here so the optimizer keeps the timed loops
+static std::atomic<uint64_t> benchSink{0};
+
+// Every heap allocation in the program goes through here
+static std::atomic<uint64_t> allocations{0};
+
+void* operator new(size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+// Last-level cache misses of this thread, or -1 if the kernel won't say
+class CacheMissCounter {
+private:
+    int fd = -1;
+
+public:
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    void start() {
+#ifdef __linux__
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    int64_t stop() {
+#ifdef __linux__
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        int64_t value = 0;
+        if (read(fd, &value, sizeof(value)) != sizeof(value)) return -1;
+        return value;
+#else
+        return -1;
+#endif
+    }
+};
+
+// Random get/put/erase/invalidate over a small key space; both caches must
+// agree on every result
+static bool differentialCheck() {
+    std::mt19937 gen(15);
+    const size_t capacities[] = {0, 1, 2, 7, 64};
+    for (size_t capacity : capacities) {
+        LRUCache<std::string, int> reference(capacity);
+        FlatLRUCache<std::string, int> flat(capacity);
+        for (int op = 0; op < 200000; ++op) {
+            std::string key = "K" + std::to_string(gen() % (capacity * 3 + 4));
+            int value = static_cast<int>(gen() % 1000);
+            unsigned kind = gen() % 100;
+            bool same = true;
+            if (kind < 50) {
+                int* a = reference.get(key);
+                int* b = flat.get(key);
+                same = (a == nullptr) == (b == nullptr) && (!a || *a == *b);
+            } else if (kind < 90) {
+                same = reference.put(key, value) == flat.put(key, value);
+            } else if (kind < 98) {
+                same = reference.erase(key) == flat.erase(key);
+            } else if (kind < 99) {
+                reference.invalidate();
+                flat.invalidate();
+            } else {
+                reference.clear();
+                flat.clear();
+            }
+            if (!same || reference.size() != flat.size()) {
+                std::cerr << "Mismatch at capacity " << capacity << ", op " << op << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+struct PhaseResult {
+    double nsPerOp;
+    double allocsPerOp;
+    int64_t misses;
+};
+
+template<typename F>
+static PhaseResult timePhase(const std::vector<std::string>& keys, F op) {
+    CacheMissCounter counter;
+    uint64_t allocsBefore = allocations;
+    counter.start();
+    auto start = BenchClock::now();
+    uint64_t sink = 0;
+    for (const auto& key : keys) sink += op(key);
+    double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+    int64_t misses = counter.stop();
+    benchSink += sink;
+    return {ns / keys.size(), double(allocations - allocsBefore) / keys.size(), misses};
+}
+
+static void printPhase(const char* impl, const char* phase, size_t capacity,
+                       const PhaseResult& r, size_t ops) {
+    std::cout << std::left << std::setw(10) << capacity << std::setw(8) << impl
+              << std::setw(6) << phase
+              << std::setw(10) << std::fixed << std::setprecision(1) << r.nsPerOp
+              << std::setw(12) << std::setprecision(3) << r.allocsPerOp;
+    if (r.misses < 0) std::cout << "n/a";
+    else std::cout << std::setprecision(2) << double(r.misses) / ops;
+    std::cout << std::endl;
+}
+
+// Fill from one skewed key stream (evicting as it goes), then look up
+// another: the findUser pattern split into its two halves
+template<typename Cache>
+static void runImpl(const char* impl, size_t capacity,
+                    const std::vector<std::string>& putKeys,
+                    const std::vector<std::string>& getKeys) {
+    Cache cache(capacity);
+    int value = 0;
+    PhaseResult puts = timePhase(putKeys, [&](const std::string& key) {
+        return cache.put(key, ++value);
+    });
+    PhaseResult gets = timePhase(getKeys, [&](const std::string& key) -> uint64_t {
+        int* found = cache.get(key);
+        return found ? *found : 0;
+    });
+    printPhase(impl, "put", capacity, puts, putKeys.size());
+    printPhase(impl, "get", capacity, gets, getKeys.size());
+}
+
+int main() {
+    std::cout << std::unitbuf;
+
+    if (!differentialCheck()) return 1;
+    std::cout << "differential check vs LRUCache: OK" << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(10) << "capacity" << std::setw(8) << "impl"
+              << std::setw(6) << "op" << std::setw(10) << "ns/op"
+              << std::setw(12) << "allocs/op" << "cache misses/op" << std::endl;
+
+    const size_t capacities[] = {1024, 65536, 1048576};
+    const size_t ops = 2000000;
+    for (size_t capacity : capacities) {
+        // Key space twice the capacity, skewed towards low numbers
+        std::mt19937 gen(static_cast<unsigned>(capacity));
+        std::exponential_distribution<double> skew(1.0 / capacity);
+        auto makeKeys = [&]() {
+            std::vector<std::string> keys;
+            keys.reserve(ops);
+            for (size_t i = 0; i < ops; ++i) {
+                keys.push_back("K" + std::to_string(static_cast<size_t>(skew(gen)) % (capacity * 2)));
+            }
+            return keys;
+        };
+        auto putKeys = makeKeys();
+        auto getKeys = makeKeys();
+
+        runImpl<LRUCache<std::string, int>>("map", capacity, putKeys, getKeys);
+        runImpl<FlatLRUCache<std::string, int>>("flat", capacity, putKeys, getKeys);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+// ============================================================================
+// FILE: bench/bench_metrics.cpp
+// Description: Cost of recording into the metrics registry - Counter::add
+//              and Histogram::observeNs against one shared atomic counter,
+//              as total calls per second from 1..8 threads (sharded cells
+//              should scale with cores, the shared atomic should not)
+// ============================================================================
+
+#include "common.h"
+#include "Metrics.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+static const uint64_t OPS_PER_THREAD = 20000000;
+
+// Million calls per second over 'threads' threads doing OPS_PER_THREAD each
+template<typename F>
+static double callsPerSecond(size_t threads, F op) {
+    std::vector<std::thread> workers;
+    auto start = BenchClock::now();
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (uint64_t i = 0; i < OPS_PER_THREAD; ++i) op(t, i);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(BenchClock::now() - start).count();
+    return threads * OPS_PER_THREAD / seconds / 1e6;
+}
+
+int main() {
+    std::cout << std::unitbuf;
+    MetricsRegistry registry;
+    Counter& counter = registry.counter("bench_total", "Bench counter");
+    Histogram& histogram = registry.histogram("bench_seconds", "Bench histogram");
+    std::atomic<uint64_t> shared{0};
+
+    std::cout << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << std::left << std::setw(10) << "threads" << std::setw(18) << "shared atomic"
+              << std::setw(18) << "Counter::add" << "Histogram::observe" << "  (M calls/s)" << std::endl;
+
+    for (size_t threads : {1, 2, 4, 8}) {
+        double sharedNs = callsPerSecond(threads, [&](size_t, uint64_t) {
+            shared.fetch_add(1, std::memory_order_relaxed);
+        });
+        double counterNs = callsPerSecond(threads, [&](size_t, uint64_t) { counter.add(); });
+        double histogramNs = callsPerSecond(threads, [&](size_t t, uint64_t i) {
+            histogram.observeNs(100 + (i & 0xFFFF) + t);
+        });
+        std::cout << std::left << std::setw(10) << threads << std::fixed << std::setprecision(2)
+                  << std::setw(18) << sharedNs << std::setw(18) << counterNs << histogramNs << std::endl;
+    }
+
+    // Nothing may be lost to races between shards
+    uint64_t expected = OPS_PER_THREAD * (1 + 2 + 4 + 8);
+    if (counter.value() != expected || histogram.count() != expected || shared != expected) {
+        std::cerr << "Lost updates: counter " << counter.value() << ", histogram "
+                  << histogram.count() << ", expected " << expected << std::endl;
+        return 1;
+    }
+    std::cout << "\nsingle thread: " << std::setprecision(1)
+              << 1000.0 / callsPerSecond(1, [&](size_t, uint64_t) { counter.add(); }) << " ns per Counter::add, "
+              << 1000.0 / callsPerSecond(1, [&](size_t, uint64_t i) { histogram.observeNs(100 + (i & 0xFFFF)); })
+              << " ns per Histogram::observeNs" << std::endl;
+
+    std::cout << "\nexport sample:" << std::endl;
+    std::ostringstream text;
+    registry.writePrometheus(text);
+    std::cout << text.str().substr(0, text.str().find("bench_seconds_bucket")) << "..." << std::endl;
+    return 0;
+}
@@ -0,0 +1,220 @@
+// ============================================================================
+// FILE: bench/bench_rcu.cpp
+// Description: Access-check throughput with 1..N reader threads while a
+//              writer keeps editing the tables: RcuCell-published versions
+//              against one mutex around a shared AccessEngine, and the same
+//              for findUser-style lookups in a published UserStore
+// ============================================================================
+
+#include "common.h"
+#include "AccessEngine.h"
+#include "RcuCell.h"
+#include "UserStore.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+// Results are written here so the optimizer keeps the timed loops
+static std::atomic<uint64_t> benchSink{0};
+
+static const size_t CARDS = 20000;
+static const size_t BATCH = 64;
+
+static AccessEngine makeEngine() {
+    AccessEngine engine;
+    for (size_t i = 0; i < CARDS; ++i) {
+        engine.addCard("CARD" + std::to_string(i + 1), "EMP" + std::to_string(i),
+                       intToClearanceLevel(static_cast<int>(i % 4)));
+    }
+    engine.addFloor("F1", ClearanceLevel::LEVEL_0);
+    engine.addFloor("F2", ClearanceLevel::LEVEL_1);
+    engine.addFloor("F3", ClearanceLevel::LEVEL_2);
+    engine.addFloor("F4", ClearanceLevel::LEVEL_3);
+    return engine;
+}
+
+// One access check as the server does it: resolve a card ID, then decide
+// a batch of swipes for that card
+static uint64_t checkAccess(const AccessEngine& engine, const std::string& cardId,
+                            const FloorHandle* floors) {
+    CardHandle card;
+    if (!engine.findCard(cardId, card)) return 0;
+    CardHandle cards[BATCH];
+    std::fill(cards, cards + BATCH, card);
+    return engine.decideBatch(cards, floors, BATCH, 0)[0];
+}
+
+// The admin edit: flip one card between revoked and re-added
+static void editEngine(AccessEngine& engine, size_t step) {
+    std::string cardId = "CARD" + std::to_string(1 + step % CARDS);
+    if (!engine.revokeCard(cardId)) {
+        engine.addCard(cardId, "EMP" + std::to_string(step % CARDS), ClearanceLevel::LEVEL_2);
+    }
+}
+
+static UserStore makeRoster() {
+    UserStore users;
+    for (size_t i = 0; i < CARDS; ++i) {
+        users.add("EMP" + std::to_string(i), "Name " + std::to_string(i), "bench@company.com",
+                  "0700000000", "CARD" + std::to_string(i + 1),
+                  intToClearanceLevel(static_cast<int>(i % 4)), false);
+    }
+    return users;
+}
+
+// findUser on one roster version: exact ID, then exact name
+static uint64_t lookupUser(const UserStore& users, const std::string& term) {
+    UserHandle user = users.findById(term);
+    if (user == NO_USER) user = users.findByName(term);
+    return user;
+}
+
+// The admin edit: rename one user
+static void editRoster(UserStore& users, size_t step) {
+    users.setName(static_cast<UserHandle>(step % CARDS), "Renamed " + std::to_string(step));
+}
+
+// Run readers over 'keys' for a fixed time alongside the writer, return
+// reads/s
+template<typename Read, typename Write>
+static double runMix(size_t readers, const std::string& keyPrefix, size_t keyBase, Read read,
+                     Write write, size_t& edits) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> checks{0};
+
+    std::vector<std::string> cardIds;
+    for (size_t i = 0; i < 1024; ++i) {
+        cardIds.push_back(keyPrefix + std::to_string(keyBase + (i * 7919) % CARDS));
+    }
+    FloorHandle floors[BATCH];
+    for (size_t i = 0; i < BATCH; ++i) floors[i] = static_cast<FloorHandle>(i % 4);
+
+    std::vector<std::thread> threads;
+    for (size_t r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            uint64_t local = 0, sink = 0;
+            size_t next = r * 131;
+            while (!stop.load(std::memory_order_relaxed)) {
+                sink += read(cardIds[next++ % cardIds.size()], floors);
+                ++local;
+            }
+            checks += local;
+            benchSink += sink;
+        });
+    }
+
+    edits = 0;
+    std::thread writer([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            write(edits++);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+
+    auto start = BenchClock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    stop = true;
+    for (auto& thread : threads) thread.join();
+    writer.join();
+    double seconds = std::chrono::duration<double>(BenchClock::now() - start).count();
+    return checks.load() / seconds;
+}
+
+int main() {
+    std::cout << std::unitbuf;
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "hardware threads: " << cores << std::endl;
+
+    std::cout << std::left << std::setw(10) << "readers"
+              << std::setw(18) << "mutex checks/s"
+              << std::setw(18) << "rcu checks/s"
+              << std::setw(14) << "rcu edits" << std::endl;
+
+    for (size_t readers = 1; readers <= std::max<size_t>(4, cores); readers *= 2) {
+        // Baseline: readers and the writer share one mutex
+        AccessEngine shared = makeEngine();
+        std::mutex sharedMutex;
+        size_t mutexEdits;
+        double mutexRate = runMix(readers, "CARD", 1,
+            [&](const std::string& cardId, const FloorHandle* floors) {
+                std::lock_guard<std::mutex> lock(sharedMutex);
+                return checkAccess(shared, cardId, floors);
+            },
+            [&](size_t step) {
+                std::lock_guard<std::mutex> lock(sharedMutex);
+                editEngine(shared, step);
+            }, mutexEdits);
+
+        // RCU: readers pin a version, the writer copies, edits and publishes
+        RcuCell<AccessEngine> cell;
+        cell.publish(std::unique_ptr<AccessEngine>(new AccessEngine(makeEngine())));
+        size_t rcuEdits;
+        double rcuRate = runMix(readers, "CARD", 1,
+            [&](const std::string& cardId, const FloorHandle* floors) {
+                auto engine = cell.read();
+                return checkAccess(*engine, cardId, floors);
+            },
+            [&](size_t step) {
+                cell.update([&](AccessEngine& engine) { editEngine(engine, step); });
+            }, rcuEdits);
+
+        // With no reader left every replaced version must be freed
+        cell.reclaim();
+        if (cell.pendingReclaim() != 0) {
+            std::cerr << "Replaced versions were not reclaimed" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(10) << readers << std::fixed << std::setprecision(0)
+                  << std::setw(18) << mutexRate
+                  << std::setw(18) << rcuRate
+                  << std::setw(14) << rcuEdits << std::endl;
+    }
+
+    // findUser: the roster is published whole after each edit, as
+    // SystemManager::publishUsers does
+    std::cout << std::endl << std::left << std::setw(10) << "readers"
+              << std::setw(18) << "mutex lookups/s"
+              << std::setw(18) << "rcu lookups/s"
+              << std::setw(14) << "rcu edits" << std::endl;
+
+    for (size_t readers = 1; readers <= std::max<size_t>(4, cores); readers *= 2) {
+        UserStore shared = makeRoster();
+        std::mutex sharedMutex;
+        size_t mutexEdits;
+        double mutexRate = runMix(readers, "EMP", 0,
+            [&](const std::string& term, const FloorHandle*) {
+                std::lock_guard<std::mutex> lock(sharedMutex);
+                return lookupUser(shared, term);
+            },
+            [&](size_t step) {
+                std::lock_guard<std::mutex> lock(sharedMutex);
+                editRoster(shared, step);
+            }, mutexEdits);
+
+        UserStore master = makeRoster();
+        RcuCell<UserStore> cell;
+        cell.publish(std::unique_ptr<UserStore>(new UserStore(master)));
+        size_t rcuEdits;
+        double rcuRate = runMix(readers, "EMP", 0,
+            [&](const std::string& term, const FloorHandle*) {
+                auto users = cell.read();
+                return lookupUser(*users, term);
+            },
+            [&](size_t step) {
+                editRoster(master, step);
+                cell.publish(std::unique_ptr<UserStore>(new UserStore(master)));
+            }, rcuEdits);
+
+        cell.reclaim();
+        if (cell.pendingReclaim() != 0 || lookupUser(*cell.read(), "EMP1") != 1) {
+            std::cerr << "Roster versions were not reclaimed or lookups broke" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(10) << readers << std::fixed << std::setprecision(0)
+                  << std::setw(18) << mutexRate
+                  << std::setw(18) << rcuRate
+                  << std::setw(14) << rcuEdits << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,257 @@
+// ============================================================================
+// FILE: bench/bench_roaring.cpp
+// Description: Per-floor allow/deny sets: RoaringBitmap against an
+//              unordered_set and a plain bit vector over the same handles
+//              (memory and membership tests), bulk set operations checked
+//              against sorted-vector results, and AccessEngine batches on
+//              floors with exceptions checked against Floor::isAuthorized
+// ============================================================================
+
+#include "common.h"
+#include "RoaringBitmap.h"
+#include "AccessEngine.h"
+#include <iterator>
+#include <unordered_set>
+
+using BenchClock = std::chrono::steady_clock;
+
+static std::vector<uint32_t> toVector(const RoaringBitmap& set) {
+    std::vector<uint32_t> values;
+    set.forEach([&](uint32_t value) { values.push_back(value); });
+    return values;
+}
+
+// Every handle below 'universe' with probability 'density', sorted
+static std::vector<uint32_t> sample(uint32_t universe, double density, std::mt19937& gen) {
+    std::bernoulli_distribution keep(density);
+    std::vector<uint32_t> values;
+    for (uint32_t v = 0; v < universe; ++v) {
+        if (keep(gen)) values.push_back(v);
+    }
+    return values;
+}
+
+static RoaringBitmap toRoaring(const std::vector<uint32_t>& values) {
+    RoaringBitmap set;
+    for (uint32_t v : values) set.add(v);
+    return set;
+}
+
+static double msSince(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+// Membership over probes: ns per test; 'found' counts hits
+template<typename F>
+static double timeContains(const std::vector<uint32_t>& probes, F contains, size_t& found) {
+    auto start = BenchClock::now();
+    for (uint32_t v : probes) found += contains(v);
+    return msSince(start) * 1e6 / probes.size();
+}
+
+static bool checkSetOps(uint32_t universe, std::mt19937& gen) {
+    const double densities[] = {0.0005, 0.02, 0.3, 0.9};
+    for (double da : densities) {
+        for (double db : densities) {
+            std::vector<uint32_t> a = sample(universe, da, gen), b = sample(universe, db, gen);
+            std::vector<uint32_t> expectUnion, expectAnd, expectMinus;
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectUnion));
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectAnd));
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectMinus));
+
+            RoaringBitmap ra = toRoaring(a), rb = toRoaring(b);
+            RoaringBitmap u = ra, n = ra, m = ra;
+            u.unionWith(rb);
+            n.intersectWith(rb);
+            m.subtract(rb);
+            if (toVector(u) != expectUnion || toVector(n) != expectAnd || toVector(m) != expectMinus ||
+                u.cardinality() != expectUnion.size() || u != toRoaring(expectUnion) ||
+                n != toRoaring(expectAnd) || m != toRoaring(expectMinus)) {
+                return false;
+            }
+
+            // Removing everything again leaves an empty set
+            for (uint32_t v : expectUnion) u.remove(v);
+            if (!u.empty() || u.cardinality() != 0) return false;
+        }
+    }
+    return true;
+}
+
+// Engine batches on floors with allow/deny lists against the per-floor rule
+static bool checkEngine(size_t userCount, std::mt19937& gen, double& batchNs, double& plainNs) {
+    UserStore users;
+    std::uniform_int_distribution<int> level(0, 3);
+    for (size_t i = 0; i < userCount; ++i) {
+        std::string n = std::to_string(i);
+        users.add("EMP" + n, "Name " + n, "bench@company.com", "0700000000", "CARD" + n,
+                  intToClearanceLevel(level(gen)), false);
+    }
+    users.remove(7);  // A deleted user on a list never gets a card
+
+    std::vector<Floor> floors;
+    floors.push_back(Floor("F1", "Ground Floor", ClearanceLevel::LEVEL_0));
+    floors.push_back(Floor("F2", "Office Floor", ClearanceLevel::LEVEL_1));
+    floors.push_back(Floor("F3", "Server Room", ClearanceLevel::LEVEL_2));
+    floors.push_back(Floor("F4", "Executive Suite", ClearanceLevel::LEVEL_3));
+
+    AccessEngine plain;
+    plain.rebuild(users, floors);
+
+    // F3: allow 1% below the level, then deny everyone at level 3 in bulk
+    RoaringBitmap allow = toRoaring(sample(static_cast<uint32_t>(userCount), 0.01, gen));
+    allow.add(7);
+    RoaringBitmap levelThree;
+    users.forEach([&](UserHandle user) {
+        if (users.getClearanceLevel(user) == ClearanceLevel::LEVEL_3) levelThree.add(user);
+    });
+    floors[2].allowUsers(allow);
+    floors[2].denyUsers(levelThree);
+    floors[0].denyUsers(toRoaring(sample(static_cast<uint32_t>(userCount), 0.001, gen)));
+
+    AccessEngine engine;
+    engine.rebuild(users, floors);
+
+    // Swipes by live users, by card handle (cards were added in handle order)
+    std::vector<UserHandle> swipers;
+    users.forEach([&](UserHandle user) { swipers.push_back(user); });
+    std::uniform_int_distribution<size_t> pickUser(0, swipers.size() - 1);
+    std::uniform_int_distribution<FloorHandle> pickFloor(0, 3);
+    const size_t swipes = 1 << 20;
+    std::vector<UserHandle> who(swipes);
+    std::vector<CardHandle> cards(swipes);
+    std::vector<FloorHandle> where(swipes);
+    for (size_t i = 0; i < swipes; ++i) {
+        size_t index = pickUser(gen);
+        who[i] = swipers[index];
+        cards[i] = static_cast<CardHandle>(index);
+        where[i] = pickFloor(gen);
+    }
+
+    auto start = BenchClock::now();
+    std::vector<uint64_t> fast = engine.decideBatch(cards.data(), where.data(), swipes, 0);
+    batchNs = msSince(start) * 1e6 / swipes;
+    start = BenchClock::now();
+    std::vector<uint64_t> base = plain.decideBatch(cards.data(), where.data(), swipes, 0);
+    plainNs = msSince(start) * 1e6 / swipes;
+
+    std::vector<uint64_t> scalar = engine.decideBatchScalar(cards.data(), where.data(), swipes, 0);
+    if (fast != scalar) return false;
+    for (size_t i = 0; i < swipes; ++i) {
+        bool granted = (fast[i / 64] >> (i % 64)) & 1;
+        if (granted != floors[where[i]].isAuthorized(who[i], users.getClearanceLevel(who[i]), 0)) {
+            return false;
+        }
+    }
+
+    // A revoked card drops off the allow list, and its stale handle is
+    // denied everywhere, level-0 floors included
+    UserHandle allowed = NO_USER;
+    floors[2].getAllowList().forEach([&](UserHandle user) {
+        if (allowed == NO_USER && users.contains(user) &&
+            users.getClearanceLevel(user) < ClearanceLevel::LEVEL_2) {
+            allowed = user;
+        }
+    });
+    CardHandle card;
+    if (allowed == NO_USER || !engine.findCard(std::string(users.getCardId(allowed)), card)) return false;
+    FloorHandle serverRoom = 2;
+    bool before = engine.decideBatchScalar(&card, &serverRoom, 1, 0)[0] & 1;
+    engine.revokeCard(std::string(users.getCardId(allowed)));
+    bool after = engine.decideBatchScalar(&card, &serverRoom, 1, 0)[0] & 1;
+    std::vector<CardHandle> stale(floors.size(), card);
+    std::vector<FloorHandle> everywhere = {0, 1, 2, 3};
+    bool anywhere = engine.decideBatch(stale.data(), everywhere.data(), stale.size(), 0)[0] != 0 ||
+                    engine.decideBatchScalar(stale.data(), everywhere.data(), stale.size(), 0)[0] != 0;
+    return before && !after && !anywhere;
+}
+
+int main() {
+    const uint32_t universe = 1000000;
+    const double densities[] = {0.0001, 0.001, 0.01, 0.1, 0.5};
+    std::mt19937 gen(42);
+
+    std::cout << "Membership over " << universe << " user handles" << std::endl;
+    std::cout << std::left << std::setw(10) << "density"
+              << std::setw(10) << "values"
+              << std::setw(14) << "roaring KB"
+              << std::setw(14) << "hashset KB"
+              << std::setw(14) << "bitvec KB"
+              << std::setw(12) << "roaring ns"
+              << std::setw(12) << "hashset ns"
+              << "bitvec ns" << std::endl;
+
+    std::uniform_int_distribution<uint32_t> probe(0, universe - 1);
+    std::vector<uint32_t> probes(1000000);
+    for (auto& v : probes) v = probe(gen);
+
+    for (double density : densities) {
+        std::vector<uint32_t> values = sample(universe, density, gen);
+        RoaringBitmap roaring = toRoaring(values);
+        std::unordered_set<uint32_t> hashset(values.begin(), values.end());
+        std::vector<bool> bitvec(universe, false);
+        for (uint32_t v : values) bitvec[v] = true;
+
+        // Node = next pointer + value, padded; plus the bucket array
+        size_t hashsetBytes = hashset.bucket_count() * sizeof(void*) + hashset.size() * 2 * sizeof(void*);
+        size_t bitvecBytes = universe / 8;
+
+        size_t roaringFound = 0, hashsetFound = 0, bitvecFound = 0;
+        double roaringNs = timeContains(probes, [&](uint32_t v) { return roaring.contains(v); }, roaringFound);
+        double hashsetNs = timeContains(probes, [&](uint32_t v) { return hashset.count(v) != 0; }, hashsetFound);
+        double bitvecNs = timeContains(probes, [&](uint32_t v) { return bool(bitvec[v]); }, bitvecFound);
+
+        if (roaringFound != hashsetFound || roaringFound != bitvecFound ||
+            roaring.cardinality() != values.size() || toVector(roaring) != values) {
+            std::cerr << "Membership mismatch at density " << density << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(10) << density
+                  << std::setw(10) << values.size()
+                  << std::setw(14) << std::fixed << std::setprecision(1) << roaring.memoryBytes() / 1024.0
+                  << std::setw(14) << hashsetBytes / 1024.0
+                  << std::setw(14) << bitvecBytes / 1024.0
+                  << std::setw(12) << roaringNs
+                  << std::setw(12) << hashsetNs
+                  << bitvecNs << std::endl;
+    }
+
+    // Bulk operations, the shape of "deny everyone at level N on a floor"
+    std::vector<uint32_t> denied = sample(universe, 0.02, gen);
+    std::vector<uint32_t> group = sample(universe, 0.25, gen);
+    RoaringBitmap deniedSet = toRoaring(denied), groupSet = toRoaring(group);
+
+    auto start = BenchClock::now();
+    const int rounds = 20;
+    for (int r = 0; r < rounds; ++r) {
+        RoaringBitmap next = deniedSet;
+        next.unionWith(groupSet);
+        next.subtract(deniedSet);
+    }
+    double roaringOpMs = msSince(start) / rounds;
+    start = BenchClock::now();
+    for (int r = 0; r < rounds; ++r) {
+        std::vector<uint32_t> merged, rest;
+        std::set_union(denied.begin(), denied.end(), group.begin(), group.end(), std::back_inserter(merged));
+        std::set_difference(merged.begin(), merged.end(), denied.begin(), denied.end(), std::back_inserter(rest));
+    }
+    double vectorOpMs = msSince(start) / rounds;
+    std::cout << std::setprecision(2);
+    std::cout << "\nunion + difference (20k and 250k handles): roaring " << roaringOpMs
+              << " ms, sorted vectors " << vectorOpMs << " ms" << std::endl;
+
+    if (!checkSetOps(200000, gen)) {
+        std::cerr << "Set operation mismatch" << std::endl;
+        return 1;
+    }
+
+    double batchNs = 0, plainNs = 0;
+    if (!checkEngine(200000, gen, batchNs, plainNs)) {
+        std::cerr << "Access decision mismatch with allow/deny lists" << std::endl;
+        return 1;
+    }
+    std::cout << "decideBatch per swipe: " << plainNs << " ns without lists, "
+              << batchNs << " ns with lists on 2 of 4 floors" << std::endl;
+    return 0;
+}
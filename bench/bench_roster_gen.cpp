@@ -0,0 +1,80 @@
+// ============================================================================
+// FILE: bench/bench_roster_gen.cpp
+// Description: Roster generator throughput per thread count, checking that
+//              every thread count writes the same bytes for the same seed
+//              and that the generated IDs are unique (writes into the
+//              working directory)
+// ============================================================================
+
+#include "common.h"
+#include "DataGenerator.h"
+#include <unordered_set>
+
+using BenchClock = std::chrono::steady_clock;
+
+// FNV-1a over the whole file
+static uint64_t fileHash(const std::string& path, size_t& bytes) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> buffer(1 << 20);
+    uint64_t hash = 1469598103934665603ULL;
+    bytes = 0;
+    while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {
+        for (std::streamsize i = 0; i < file.gcount(); ++i) {
+            hash = (hash ^ static_cast<unsigned char>(buffer[i])) * 1099511628211ULL;
+        }
+        bytes += file.gcount();
+    }
+    return hash;
+}
+
+static bool idsUnique(const std::string& path) {
+    std::ifstream file(path);
+    std::unordered_set<std::string> ids;
+    std::string line;
+    std::getline(file, line);  // Header
+    while (std::getline(file, line)) {
+        if (!ids.insert(line.substr(0, line.find(','))).second) {
+            std::cerr << "Duplicate ID in: " << line << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    uint64_t seed = argc > 2 ? std::stoull(argv[2]) : 42;
+    const std::string path = "bench_roster.csv";
+    std::cout << std::unitbuf;
+
+    std::cout << std::left << std::setw(10) << "threads" << std::setw(12) << "ms"
+              << std::setw(14) << "rows/sec" << "MB/s" << std::endl;
+
+    uint64_t expected = 0;
+    const size_t threadCounts[] = {1, 2, 4, 8};
+    for (size_t threads : threadCounts) {
+        auto start = BenchClock::now();
+        if (!generateRoster(path, count, seed, threads)) return 1;
+        double ms = std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+
+        size_t bytes = 0;
+        uint64_t hash = fileHash(path, bytes);
+        if (threads == 1) {
+            expected = hash;
+            if (!idsUnique(path)) return 1;
+        } else if (hash != expected) {
+            std::cerr << "Output with " << threads << " threads differs from 1 thread" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(10) << threads
+                  << std::setw(12) << std::fixed << std::setprecision(1) << ms
+                  << std::setw(14) << std::setprecision(0) << count / (ms / 1000.0)
+                  << std::setprecision(1) << bytes / (ms * 1000.0) << std::endl;
+    }
+
+    std::cout << count << " rows, seed " << seed << ", output hash " << std::hex << expected
+              << std::dec << " (same for every thread count)" << std::endl;
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,206 @@
+// ============================================================================
+// FILE: bench/bench_schedule.cpp
+// Description: Floor schedules: evaluating the rules on every swipe against
+//              the compiled minute-of-week table, incremental recompiles
+//              after single-rule edits against a full rebuild (checked
+//              minute by minute against direct rule evaluation), and
+//              AccessEngine batches on scheduled floors against Floor
+// ============================================================================
+
+#include "common.h"
+#include "AccessSchedule.h"
+#include "AccessEngine.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+// Direct evaluation: does the rule's window cover this minute of the week?
+static bool covers(const ScheduleRule& rule, uint32_t minute) {
+    uint32_t length = (rule.endMinute + MINUTES_PER_DAY - rule.startMinute) % MINUTES_PER_DAY;
+    if (length == 0) length = MINUTES_PER_DAY;
+    for (uint32_t day = 0; day < 7; ++day) {
+        if (!(rule.days & (1u << day))) continue;
+        uint32_t begin = day * MINUTES_PER_DAY + rule.startMinute;
+        if ((minute + MINUTES_PER_WEEK - begin) % MINUTES_PER_WEEK < length) return true;
+    }
+    return false;
+}
+
+static uint8_t evaluate(ClearanceLevel base, const std::vector<ScheduleRule>& rules, uint32_t minute) {
+    uint8_t level = static_cast<uint8_t>(clearanceLevelToInt(base));
+    for (const ScheduleRule& rule : rules) {
+        if (covers(rule, minute)) level = static_cast<uint8_t>(clearanceLevelToInt(rule.level));
+    }
+    return level;
+}
+
+static bool matchesRules(const AccessSchedule& schedule) {
+    for (uint32_t minute = 0; minute < MINUTES_PER_WEEK; ++minute) {
+        uint8_t level = static_cast<uint8_t>(clearanceLevelToInt(schedule.levelAt(minute)));
+        if (level != evaluate(schedule.getBaseLevel(), schedule.getRules(), minute)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static ScheduleRule randomRule(std::mt19937& gen) {
+    std::uniform_int_distribution<int> days(1, 0x7F), minute(0, MINUTES_PER_DAY - 1), level(0, 3);
+    ScheduleRule rule;
+    rule.days = static_cast<uint8_t>(days(gen));
+    rule.startMinute = static_cast<uint16_t>(minute(gen));
+    rule.endMinute = static_cast<uint16_t>(minute(gen));
+    rule.level = intToClearanceLevel(level(gen));
+    return rule;
+}
+
+static double msSince(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+static bool checkParsing() {
+    uint8_t days = 0;
+    uint16_t minute = 0;
+    bool ok = AccessSchedule::parseDays("Mon-Fri", days) && days == 0x1F &&
+              AccessSchedule::parseDays("sat, Sunday", days) && days == 0x60 &&
+              AccessSchedule::parseDays("Fri-Mon", days) && days == 0x71 &&
+              AccessSchedule::parseDays("all", days) && days == 0x7F &&
+              !AccessSchedule::parseDays("Funday", days) && !AccessSchedule::parseDays("", days) &&
+              AccessSchedule::parseTime("9:30", minute) && minute == 570 &&
+              AccessSchedule::parseTime("24:00", minute) && minute == 0 &&
+              !AccessSchedule::parseTime("25:00", minute) && !AccessSchedule::parseTime("12:60", minute) &&
+              !AccessSchedule::parseTime("1230", minute);
+
+    ScheduleRule rule{0x1F, 9 * 60, 17 * 60, ClearanceLevel::LEVEL_1};
+    ok = ok && AccessSchedule::describe(rule) == "Mon-Fri 09:00-17:00, level 1";
+    rule.days = 0x65;  // Mon, Wed, Sat, Sun
+    ok = ok && AccessSchedule::describe(rule) == "Mon,Wed,Sat,Sun 09:00-17:00, level 1";
+    return ok;
+}
+
+// The table only exists while the schedule has rules
+static bool checkLazyTable() {
+    AccessSchedule schedule(ClearanceLevel::LEVEL_1);
+    bool ok = schedule.getTable().empty() && matchesRules(schedule);
+    schedule.addRule({0x1F, 9 * 60, 17 * 60, ClearanceLevel::LEVEL_2});
+    ok = ok && schedule.getTable().size() == MINUTES_PER_WEEK && matchesRules(schedule);
+    schedule.setBaseLevel(ClearanceLevel::LEVEL_0);
+    schedule.removeRule(0);
+    return ok && schedule.getTable().empty() && matchesRules(schedule);
+}
+
+// Engine batches on scheduled floors against Floor::isAuthorized
+static bool checkEngine(std::mt19937& gen) {
+    UserStore users;
+    for (int i = 0; i < 4096; ++i) {
+        users.add("EMP" + std::to_string(i), "Name", "bench@company.com", "0700000000",
+                  "CARD" + std::to_string(i), intToClearanceLevel(i % 4));
+    }
+    std::vector<Floor> floors;
+    floors.push_back(Floor("F1", "Ground Floor", ClearanceLevel::LEVEL_0));
+    floors.push_back(Floor("F2", "Office Floor", ClearanceLevel::LEVEL_1));
+    floors.push_back(Floor("F3", "Server Room", ClearanceLevel::LEVEL_2));
+    floors.push_back(Floor("F4", "Executive Suite", ClearanceLevel::LEVEL_3));
+    floors[2].addScheduleRule({0x1F, 9 * 60, 17 * 60, ClearanceLevel::LEVEL_1});
+    floors[0].addScheduleRule({0x7F, 22 * 60, 6 * 60, ClearanceLevel::LEVEL_2});
+    floors[0].addScheduleRule({0x60, 0, 0, ClearanceLevel::LEVEL_3});
+
+    AccessEngine engine;
+    engine.rebuild(users, floors);
+
+    std::vector<CardHandle> cards(users.size() * floors.size());
+    std::vector<FloorHandle> where(cards.size());
+    for (size_t i = 0; i < cards.size(); ++i) {
+        cards[i] = static_cast<CardHandle>(i / floors.size());
+        where[i] = static_cast<FloorHandle>(i % floors.size());
+    }
+
+    std::uniform_int_distribution<int64_t> when(1700000000, 1700000000 + 7 * 86400);
+    for (int round = 0; round < 64; ++round) {
+        int64_t t = when(gen);
+        auto fast = engine.decideBatch(cards.data(), where.data(), cards.size(), t);
+        if (fast != engine.decideBatchScalar(cards.data(), where.data(), cards.size(), t)) return false;
+        for (size_t i = 0; i < cards.size(); ++i) {
+            bool expected = floors[where[i]].isAuthorized(
+                NO_USER, users.getClearanceLevel(cards[i]), t);
+            if (((fast[i / 64] >> (i % 64)) & 1) != expected) return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::mt19937 gen(42);
+
+    if (!checkParsing()) {
+        std::cerr << "Schedule parsing mismatch" << std::endl;
+        return 1;
+    }
+    if (!checkLazyTable()) {
+        std::cerr << "Schedule table allocated without rules" << std::endl;
+        return 1;
+    }
+
+    // Random single-rule edits, each checked against direct evaluation
+    AccessSchedule schedule(ClearanceLevel::LEVEL_2);
+    double incrementalMs = 0;
+    int edits = 0;
+    for (int step = 0; step < 300; ++step) {
+        size_t count = schedule.getRules().size();
+        std::uniform_int_distribution<size_t> pick(0, count ? count - 1 : 0);
+        int op = count < 4 ? 0 : static_cast<int>(gen() % 4);
+        auto start = BenchClock::now();
+        if (op == 0 || (op == 1 && count < 12)) {
+            schedule.addRule(randomRule(gen));
+        } else if (op == 1 || op == 2) {
+            schedule.replaceRule(pick(gen), randomRule(gen));
+        } else {
+            schedule.removeRule(pick(gen));
+        }
+        incrementalMs += msSince(start);
+        ++edits;
+        if (!matchesRules(schedule)) {
+            std::cerr << "Schedule table mismatch after edit " << step << std::endl;
+            return 1;
+        }
+    }
+    auto start = BenchClock::now();
+    const int rebuilds = 300;
+    for (int i = 0; i < rebuilds; ++i) {
+        schedule.setBaseLevel(intToClearanceLevel(i % 4));
+    }
+    double fullMs = msSince(start) / rebuilds;
+    if (!matchesRules(schedule)) {
+        std::cerr << "Schedule table mismatch after a full recompile" << std::endl;
+        return 1;
+    }
+
+    // Per-swipe cost: the table against walking the rules
+    std::uniform_int_distribution<uint32_t> minute(0, MINUTES_PER_WEEK - 1);
+    std::vector<uint32_t> probes(1000000);
+    for (auto& m : probes) m = minute(gen);
+
+    uint64_t tableSum = 0, ruleSum = 0;
+    start = BenchClock::now();
+    for (uint32_t m : probes) tableSum += clearanceLevelToInt(schedule.levelAt(m));
+    double tableNs = msSince(start) * 1e6 / probes.size();
+    start = BenchClock::now();
+    for (uint32_t m : probes) ruleSum += evaluate(schedule.getBaseLevel(), schedule.getRules(), m);
+    double ruleNs = msSince(start) * 1e6 / probes.size();
+    if (tableSum != ruleSum) {
+        std::cerr << "Schedule lookup mismatch" << std::endl;
+        return 1;
+    }
+
+    if (!checkEngine(gen)) {
+        std::cerr << "Access decision mismatch on scheduled floors" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Schedule with " << schedule.getRules().size() << " rules" << std::endl;
+    std::cout << std::left << std::setw(34) << "lookup: table (ns)" << tableNs << std::endl;
+    std::cout << std::setw(34) << "lookup: evaluate rules (ns)" << ruleNs << std::endl;
+    std::cout << std::setw(34) << "rule add/edit/remove (ms)" << incrementalMs / edits << std::endl;
+    std::cout << std::setw(34) << "base level change, full (ms)" << fullMs << std::endl;
+    return 0;
+}
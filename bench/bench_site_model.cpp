@@ -0,0 +1,282 @@
+// ============================================================================
+// FILE: bench/bench_site_model.cpp
+// Description: A 100k-door campus: hash lookups by ID and name against a
+//              linear scan, flattened door decisions against walking the
+//              tree on every swipe (checked door by door), policy
+//              re-flattening, and AccessEngine batches on door handles
+//              against SiteModel::isAuthorized
+// ============================================================================
+
+#include "common.h"
+#include "SiteModel.h"
+#include "AccessEngine.h"
+#include "UserStore.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+const int BUILDINGS = 10;
+const int FLOORS_PER_BUILDING = 10;
+const int ZONES_PER_FLOOR = 10;
+const int DOORS_PER_ZONE = 100;
+
+static double msSince(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+// Walk from the node up to its building, as an unflattened model would
+static uint8_t walkMinimum(const SiteModel& site, SiteId node) {
+    uint8_t level = 0;
+    for (; node != NO_SITE; node = site.getParent(node)) {
+        if (site.hasPolicy(node)) {
+            level = std::max(level, static_cast<uint8_t>(clearanceLevelToInt(site.getPolicy(node))));
+        }
+    }
+    return level;
+}
+
+static uint8_t walkRequired(const SiteModel& site, SiteId node, int64_t t) {
+    uint8_t scheduled = static_cast<uint8_t>(
+        clearanceLevelToInt(site.getFloor(node).getRequiredClearanceAt(t)));
+    return std::max(scheduled, walkMinimum(site, node));
+}
+
+static bool matchesWalk(const SiteModel& site) {
+    for (SiteId node = 0; node < site.nodeLimit(); ++node) {
+        if (!site.contains(node) || site.getKind(node) == SiteKind::BUILDING) continue;
+        if (clearanceLevelToInt(site.getMinimum(node)) != walkMinimum(site, node)) return false;
+    }
+    return true;
+}
+
+static SiteModel buildSite(std::vector<SiteId>& zones, std::vector<SiteId>& doors) {
+    SiteModel site;
+    int doorNumber = 0;
+    for (int b = 0; b < BUILDINGS; ++b) {
+        std::string bid = "B" + std::to_string(b);
+        SiteId building = site.addBuilding(bid, "Building " + std::to_string(b));
+        for (int f = 0; f < FLOORS_PER_BUILDING; ++f) {
+            std::string fid = bid + "F" + std::to_string(f);
+            SiteId floor = site.addFloor(building, fid, "Floor " + fid,
+                                         intToClearanceLevel(f % 3), 16);
+            for (int z = 0; z < ZONES_PER_FLOOR; ++z) {
+                std::string zid = fid + "Z" + std::to_string(z);
+                SiteId zone = site.addZone(floor, zid, "Zone " + zid);
+                zones.push_back(zone);
+                for (int d = 0; d < DOORS_PER_ZONE; ++d, ++doorNumber) {
+                    std::string did = "D" + std::to_string(doorNumber);
+                    doors.push_back(site.addDoor(zone, did, "Door " + std::to_string(doorNumber)));
+                }
+            }
+        }
+    }
+    return site;
+}
+
+int main() {
+    std::mt19937 gen(42);
+
+    auto start = BenchClock::now();
+    std::vector<SiteId> zones, doors;
+    SiteModel site = buildSite(zones, doors);
+    double buildMs = msSince(start);
+    if (site.doorCount() != doors.size() ||
+        site.floorCount() != static_cast<size_t>(BUILDINGS * FLOORS_PER_BUILDING)) {
+        std::cerr << "Site size mismatch" << std::endl;
+        return 1;
+    }
+
+    // Policies at every level of the tree, and a schedule on one floor
+    std::uniform_int_distribution<size_t> anyZone(0, zones.size() - 1), anyDoor(0, doors.size() - 1);
+    std::uniform_int_distribution<int> level(0, 3);
+    site.setPolicy(site.findById("B3"), ClearanceLevel::LEVEL_1);
+    for (int i = 0; i < 100; ++i) site.setPolicy(zones[anyZone(gen)], intToClearanceLevel(level(gen)));
+    for (int i = 0; i < 1000; ++i) site.setPolicy(doors[anyDoor(gen)], intToClearanceLevel(level(gen)));
+    site.getFloor(site.findById("B0F0")).addScheduleRule({0x7F, 22 * 60, 6 * 60, ClearanceLevel::LEVEL_3});
+    if (!matchesWalk(site)) {
+        std::cerr << "Flattened minimum mismatch" << std::endl;
+        return 1;
+    }
+
+    // Re-flattening after policy edits: one zone, then a whole building
+    start = BenchClock::now();
+    const int zoneEdits = 1000;
+    for (int i = 0; i < zoneEdits; ++i) {
+        SiteId zone = zones[anyZone(gen)];
+        if (i % 2) site.clearPolicy(zone);
+        else site.setPolicy(zone, intToClearanceLevel(level(gen)));
+    }
+    double zoneEditUs = msSince(start) * 1000 / zoneEdits;
+    start = BenchClock::now();
+    const int buildingEdits = 20;
+    for (int i = 0; i < buildingEdits; ++i) {
+        site.setPolicy(site.findById("B5"), intToClearanceLevel(i % 4));
+    }
+    double buildingEditMs = msSince(start) / buildingEdits;
+    if (!matchesWalk(site)) {
+        std::cerr << "Flattened minimum mismatch after edits" << std::endl;
+        return 1;
+    }
+
+    // Lookups: hash indexes against scanning every node
+    std::vector<std::string> ids, names;
+    for (int i = 0; i < 1000000; ++i) {
+        size_t door = anyDoor(gen);
+        ids.push_back("D" + std::to_string(door));
+        names.push_back("Door " + std::to_string(door));
+    }
+    uint64_t idSum = 0, nameSum = 0, scanSum = 0;
+    start = BenchClock::now();
+    for (const auto& id : ids) idSum += site.findById(id);
+    double idNs = msSince(start) * 1e6 / ids.size();
+    start = BenchClock::now();
+    for (const auto& name : names) nameSum += site.findByName(name, SiteKind::DOOR);
+    double nameNs = msSince(start) * 1e6 / names.size();
+    const size_t scans = 1000;
+    start = BenchClock::now();
+    for (size_t i = 0; i < scans; ++i) {
+        for (SiteId node = 0; node < site.nodeLimit(); ++node) {
+            if (site.getId(node) == ids[i]) {
+                scanSum += node;
+                break;
+            }
+        }
+    }
+    double scanNs = msSince(start) * 1e6 / scans;
+    uint64_t expected = 0;
+    for (size_t i = 0; i < scans; ++i) expected += site.findById(ids[i]);
+    if (idSum != nameSum || scanSum != expected) {
+        std::cerr << "Site lookup mismatch" << std::endl;
+        return 1;
+    }
+
+    // Decisions at a door: flattened against walking the tree
+    std::vector<SiteId> probes(1000000);
+    std::vector<uint8_t> levels(probes.size());
+    for (size_t i = 0; i < probes.size(); ++i) {
+        probes[i] = doors[anyDoor(gen)];
+        levels[i] = static_cast<uint8_t>(level(gen));
+    }
+    int64_t t = 1700000000;
+    uint64_t flatGranted = 0, walkGranted = 0;
+    start = BenchClock::now();
+    for (size_t i = 0; i < probes.size(); ++i) {
+        flatGranted += site.isAuthorized(probes[i], NO_USER, intToClearanceLevel(levels[i]), t);
+    }
+    double flatNs = msSince(start) * 1e6 / probes.size();
+    start = BenchClock::now();
+    for (size_t i = 0; i < probes.size(); ++i) {
+        walkGranted += levels[i] >= walkRequired(site, probes[i], t);
+    }
+    double walkNs = msSince(start) * 1e6 / probes.size();
+    if (flatGranted != walkGranted) {
+        std::cerr << "Door decision mismatch" << std::endl;
+        return 1;
+    }
+
+    // Engine batches on door handles, with allow/deny lists on one floor
+    UserStore users;
+    for (int i = 0; i < 4096; ++i) {
+        std::string n = std::to_string(i);
+        users.add("EMP" + n, "Name " + n, "bench@company.com", "0700000000", "CARD" + n,
+                  intToClearanceLevel(level(gen)), false);
+    }
+    Floor& listed = site.getFloor(site.findById("B1F2"));
+    RoaringBitmap allow, deny;
+    for (UserHandle user = 0; user < 4096; user += 7) allow.add(user);
+    for (UserHandle user = 3; user < 4096; user += 11) deny.add(user);
+    listed.allowUsers(allow);
+    listed.denyUsers(deny);
+    // Half of B1F2's zones lead to it, so the lists get exercised; one of
+    // them sits above the floor's level, which the allow list must not lift
+    site.setPolicy(site.findById("B1F2Z0"), ClearanceLevel::LEVEL_3);
+    for (int z = 0; z < ZONES_PER_FLOOR; z += 2) {
+        SiteId zone = site.findById("B1F2Z" + std::to_string(z));
+        site.forEachDoor(zone, [&](SiteId door) { probes.push_back(door); });
+    }
+
+    AccessEngine engine;
+    start = BenchClock::now();
+    engine.rebuild(users, site);
+    double rebuildMs = msSince(start);
+
+    const size_t swipes = 1 << 16;
+    std::uniform_int_distribution<UserHandle> anyUser(0, 4095);
+    std::uniform_int_distribution<size_t> anyProbe(0, probes.size() - 1);
+    std::vector<CardHandle> cards(swipes);
+    std::vector<FloorHandle> where(swipes);
+    std::vector<UserHandle> holders(swipes);
+    std::vector<SiteId> at(swipes);
+    for (size_t i = 0; i < swipes; ++i) {
+        holders[i] = anyUser(gen);
+        at[i] = probes[anyProbe(gen)];
+        if (!engine.findCard(std::string(users.getCardId(holders[i])), cards[i]) ||
+            !engine.findFloor(site.getId(at[i]), where[i])) {
+            std::cerr << "Engine is missing a card or door" << std::endl;
+            return 1;
+        }
+    }
+    std::uniform_int_distribution<int64_t> when(1700000000, 1700000000 + 7 * 86400);
+    double batchNs = 0;
+    size_t heldByMinimum = 0;
+    for (int round = 0; round < 16; ++round) {
+        t = when(gen);
+        start = BenchClock::now();
+        auto fast = engine.decideBatch(cards.data(), where.data(), swipes, t);
+        batchNs += msSince(start) * 1e6 / swipes / 16;
+        if (fast != engine.decideBatchScalar(cards.data(), where.data(), swipes, t)) {
+            std::cerr << "Engine fast/scalar mismatch on doors" << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < swipes; ++i) {
+            // Reference: the allow list lifts only the floor's scheduled
+            // level, the minimums up the tree always apply, deny wins
+            const Floor& floor = site.getFloor(at[i]);
+            uint8_t held = static_cast<uint8_t>(clearanceLevelToInt(users.getClearanceLevel(holders[i])));
+            bool allowed = floor.getAllowList().contains(holders[i]);
+            bool floorOk = held >= clearanceLevelToInt(floor.getRequiredClearanceAt(t)) || allowed;
+            bool minimumOk = held >= walkMinimum(site, at[i]);
+            bool expectedBit = floorOk && minimumOk && !floor.getDenyList().contains(holders[i]);
+            heldByMinimum += allowed && !minimumOk;
+            if (site.isAuthorized(at[i], holders[i], users.getClearanceLevel(holders[i]), t) !=
+                expectedBit) {
+                std::cerr << "Site decision mismatch at door " << site.getId(at[i]) << std::endl;
+                return 1;
+            }
+            if (((fast[i / 64] >> (i % 64)) & 1) != expectedBit) {
+                std::cerr << "Engine decision mismatch at door " << site.getId(at[i]) << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    if (heldByMinimum == 0) {
+        std::cerr << "No allowed swipe ran into a minimum" << std::endl;
+        return 1;
+    }
+
+    // A removed door is unknown to readers: never granted
+    std::string gone = site.getId(at[0]);
+    engine.removeDoor(gone);
+    FloorHandle stale;
+    auto afterRemove = engine.decideBatchScalar(&cards[0], &where[0], 1, t);
+    if (engine.findFloor(gone, stale) || (afterRemove[0] & 1)) {
+        std::cerr << "Removed door still decides" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Site: " << BUILDINGS << " buildings, " << site.floorCount() << " floors, "
+              << zones.size() << " zones, " << site.doorCount() << " doors" << std::endl;
+    std::cout << std::left << std::setw(34) << "build site (ms)" << buildMs << std::endl;
+    std::cout << std::setw(34) << "engine rebuild (ms)" << rebuildMs << std::endl;
+    std::cout << std::setw(34) << "findById (ns)" << idNs << std::endl;
+    std::cout << std::setw(34) << "findByName (ns)" << nameNs << std::endl;
+    std::cout << std::setw(34) << "linear scan by ID (ns)" << scanNs << std::endl;
+    std::cout << std::setw(34) << "door decision: flattened (ns)" << flatNs << std::endl;
+    std::cout << std::setw(34) << "door decision: walk tree (ns)" << walkNs << std::endl;
+    std::cout << std::setw(34) << "engine batch per swipe (ns)" << batchNs << std::endl;
+    std::cout << std::setprecision(2);
+    std::cout << std::setw(34) << "zone policy edit (us)" << zoneEditUs << std::endl;
+    std::cout << std::setw(34) << "building policy edit (ms)" << buildingEditMs << std::endl;
+    return 0;
+}
@@ -0,0 +1,266 @@
+// ============================================================================
+// FILE: bench/bench_suite.cpp
+// Description: Benchmark suite over the core hot paths, each run against
+//              generated rosters of several sizes; results go to the console
+//              and to JSON/CSV files (see 'make bench-report')
+//
+// Usage: bench_suite.exe [--sizes 1000,10000,...] [--json FILE] [--csv FILE]
+//                        [--dir SCRATCH] [--filter NAME] [--warmup N] [--reps N]
+// The roster files are written under the scratch directory, never data/.
+// Each benchmark runs --warmup times untimed, then --reps times; the median
+// and fastest runs are reported.
+// ============================================================================
+
+#include "BenchHarness.h"
+#include "AccessEngine.h"
+#include "Cache.h"
+#include "DataManager.h"
+#include "SiteModel.h"
+#include "SystemManager.h"
+#include "UserStore.h"
+#include "Validator.h"
+#include <filesystem>
+
+// Per-benchmark op counts are capped so the large rosters stay quick
+static const uint64_t MAX_LOOKUPS = 200000;
+static const uint64_t MAX_SWIPES = 1000000;
+static const size_t SWIPE_BATCH = 1024;  // Swipes per AccessEngine::decideBatch call
+
+static std::vector<size_t> parseSizes(const std::string& list) {
+    std::vector<size_t> sizes;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) sizes.push_back(std::stoul(item));
+    }
+    return sizes;
+}
+
+// Roster in the DATA_FILE format, with IDs from the same EMP base so
+// generateUniqueId has to search past all of them
+static void writeRoster(size_t count) {
+    std::ofstream file(DATA_FILE);
+    file << "ID,Name,Email,Phone,CardID,ClearanceLevel,Type,Password\n";
+    file << "ADMIN,Admin User,admin@company.com,0712345678,CARD_ADMIN,3,ADMIN," << ADMIN_PASSWORD << "\n";
+    for (size_t i = 0; i < count; ++i) {
+        file << "EMP" << (i ? std::to_string(i) : "") << ",First" << (i % 977) << " Last" << (i % 1013)
+             << ",first" << i << ".last@company.com,07" << (10000000 + i % 89999999)
+             << ",CARD" << (i + 1) << "," << (i % 4) << ",USER\n";
+    }
+}
+
+static std::vector<std::string> readLines(size_t limit) {
+    std::ifstream file(DATA_FILE);
+    std::vector<std::string> lines;
+    std::string line;
+    std::getline(file, line);  // Header
+    while (lines.size() < limit && std::getline(file, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static void runSize(BenchReporter& bench, size_t count) {
+    std::filesystem::remove_all("data");
+    std::filesystem::create_directories("data");
+    writeRoster(count);
+    std::mt19937 gen(static_cast<unsigned>(count));
+
+    // --- CSV persistence (into the UserStore, as at startup) ---
+    std::shared_ptr<Admin> admin;
+    std::vector<std::string> hitTerms, missTerms;
+    {
+        UserStore store;
+        DataManager dm;
+        bench.run("DataManager::loadFromCSV/row", count, count + 1, [&]() {
+            store.clear();
+            dm.loadFromCSV(store, admin);
+            return store.size();
+        });
+        bench.run("DataManager::saveToCSV/row", count, count + 1, [&]() {
+            return static_cast<uint64_t>(dm.saveToCSV(store, admin));
+        });
+
+        auto lines = readLines(MAX_LOOKUPS);
+        bench.run("DataManager::parseCSVLine", count, lines.size(), [&]() {
+            uint64_t fields = 0;
+            for (const auto& line : lines) fields += dm.parseCSVLine(line).size();
+            return fields;
+        });
+
+        // Every call allocates a new EMP<n>, past the whole roster
+        uint64_t idOps = std::min<uint64_t>(count, MAX_LOOKUPS);
+        bench.run("DataManager::generateUniqueId", count, idOps, [&]() {
+            uint64_t length = 0;
+            for (uint64_t i = 0; i < idOps; ++i) length += dm.generateUniqueId("Employee").size();
+            return length;
+        });
+        if (store.size() == 0) {
+            std::cerr << "Roster of " << count << " failed to load" << std::endl;
+            return;
+        }
+
+        // Nobody was removed, so every handle below the limit is a live user
+        std::uniform_int_distribution<UserHandle> pick(0, static_cast<UserHandle>(store.handleLimit() - 1));
+
+        // --- Validator ---
+        std::vector<std::string> emails, phones;
+        for (UserHandle user = 0; user < std::min<uint64_t>(store.handleLimit(), MAX_SWIPES); ++user) {
+            emails.emplace_back(store.getEmail(user));
+            phones.emplace_back(store.getPhone(user));
+        }
+        bench.run("Validator::validateEmail", count, emails.size(), [&]() {
+            uint64_t valid = 0;
+            for (const auto& email : emails) valid += Validator::validateEmail(email);
+            return valid;
+        });
+        bench.run("Validator::validatePhone", count, phones.size(), [&]() {
+            uint64_t valid = 0;
+            for (const auto& phone : phones) valid += Validator::validatePhone(phone);
+            return valid;
+        });
+
+        // --- Swipes on the default site: one at a time through SiteModel
+        // (the menu path, no audit log) and in batches through AccessEngine
+        // (the server path) ---
+        SiteModel site = SiteModel::defaultSite();
+        AccessEngine engine;
+        engine.rebuild(store, site);
+        std::vector<SiteId> points;
+        std::vector<FloorHandle> pointHandles;
+        for (size_t number = 1; number <= site.floorCount(); ++number) {
+            FloorHandle handle;
+            points.push_back(site.floorAt(number));
+            if (engine.findFloor(site.getId(points.back()), handle)) pointHandles.push_back(handle);
+        }
+        std::vector<UserHandle> who;
+        std::vector<SiteId> where;
+        std::vector<CardHandle> cards;
+        std::vector<FloorHandle> floors;
+        for (uint64_t i = 0; i < MAX_SWIPES; ++i) {
+            UserHandle user = pick(gen);
+            size_t point = gen() % points.size();
+            CardHandle card;
+            if (!engine.findCard(std::string(store.getCardId(user)), card)) continue;
+            who.push_back(user);
+            where.push_back(points[point]);
+            cards.push_back(card);
+            floors.push_back(pointHandles[point]);
+        }
+        bench.run("SiteModel::attemptAccess", count, who.size(), [&]() {
+            uint64_t granted = 0;
+            for (size_t i = 0; i < who.size(); ++i) {
+                UserHandle user = who[i];
+                granted += site.attemptAccess(where[i], user, std::string(store.getId(user)),
+                                              std::string(store.getName(user)),
+                                              store.getClearanceLevel(user));
+            }
+            return granted;
+        });
+        int64_t now = std::time(nullptr);
+        bench.run("AccessEngine::decideBatch", count, cards.size(), [&]() {
+            uint64_t granted = 0;
+            for (size_t base = 0; base < cards.size(); base += SWIPE_BATCH) {
+                size_t n = std::min<size_t>(SWIPE_BATCH, cards.size() - base);
+                granted += engine.decideBatch(cards.data() + base, floors.data() + base, n, now)[0];
+            }
+            return granted;
+        });
+
+        // --- SystemManager's user cache (same type and budget), skewed IDs ---
+        std::exponential_distribution<double> skew(10.0 / store.size());
+        std::vector<std::string> cacheKeys;
+        std::vector<UserHandle> cacheValues;
+        for (uint64_t i = 0; i < MAX_LOOKUPS; ++i) {
+            UserHandle user = static_cast<UserHandle>(static_cast<size_t>(skew(gen)) % store.handleLimit());
+            cacheKeys.emplace_back(store.getId(user));
+            cacheValues.push_back(user);
+        }
+        ShardedLRUCache<std::string, UserHandle, 8, TinyLfuPolicy,
+                        ByteWeigher<std::string, UserHandle>> cache(CACHE_SIZE);
+        bench.run("UserCache::put", count, cacheKeys.size(), [&]() {
+            for (size_t i = 0; i < cacheKeys.size(); ++i) cache.put(cacheKeys[i], cacheValues[i]);
+            return cache.size();
+        });
+        bench.run("UserCache::get", count, cacheKeys.size(), [&]() {
+            uint64_t hits = 0;
+            for (const auto& key : cacheKeys) hits += cache.get(key).has_value();
+            return hits;
+        });
+        bench.run("UserCache::get+put", count, cacheKeys.size(), [&]() {
+            uint64_t hits = 0;
+            cache.clear();
+            for (size_t i = 0; i < cacheKeys.size(); ++i) {
+                if (cache.get(cacheKeys[i])) ++hits;
+                else cache.put(cacheKeys[i], cacheValues[i]);
+            }
+            return hits;
+        });
+
+        for (uint64_t i = 0; i < MAX_LOOKUPS; ++i) {
+            hitTerms.emplace_back(store.getId(pick(gen)));
+            missTerms.push_back("NOBODY" + std::to_string(i));
+        }
+    }
+    admin.reset();  // The store above is gone too; SystemManager loads its own
+
+    // --- SystemManager::findUser on the saved roster (snapshot start) ---
+    {
+        SystemManager system;
+        system.initialize();
+        bench.run("SystemManager::findUser/hit", count, hitTerms.size(), [&]() {
+            uint64_t found = 0;
+            for (const auto& term : hitTerms) found += system.findUser(term) != NO_USER;
+            return found;
+        });
+        bench.run("SystemManager::findUser/miss", count, missTerms.size(), [&]() {
+            uint64_t found = 0;
+            for (const auto& term : missTerms) found += system.findUser(term) != NO_USER;
+            return found;
+        });
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << std::unitbuf;
+    std::vector<size_t> sizes = {1000, 10000, 100000, 1000000, 10000000};
+    std::string jsonPath, csvPath, filter;
+    std::string scratch = "bench_scratch";
+    int warmups = 1, repetitions = 5;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--sizes") sizes = parseSizes(argv[i + 1]);
+        else if (flag == "--json") jsonPath = argv[i + 1];
+        else if (flag == "--csv") csvPath = argv[i + 1];
+        else if (flag == "--dir") scratch = argv[i + 1];
+        else if (flag == "--filter") filter = argv[i + 1];
+        else if (flag == "--warmup") warmups = std::stoi(argv[i + 1]);
+        else if (flag == "--reps") repetitions = std::stoi(argv[i + 1]);
+        else {
+            std::cerr << "Unknown option " << flag << std::endl;
+            return 1;
+        }
+    }
+
+    // Output paths are relative to where we were started, not the scratch dir
+    if (!jsonPath.empty()) jsonPath = std::filesystem::absolute(jsonPath).string();
+    if (!csvPath.empty()) csvPath = std::filesystem::absolute(csvPath).string();
+    std::filesystem::create_directories(scratch);
+    std::filesystem::current_path(scratch);
+
+    BenchReporter bench(filter, warmups, repetitions);
+    bench.printHeader();
+    for (size_t count : sizes) {
+        runSize(bench, count);
+    }
+
+    if (!jsonPath.empty() && !bench.writeJSON(jsonPath)) {
+        std::cerr << "Could not write " << jsonPath << std::endl;
+        return 1;
+    }
+    if (!csvPath.empty() && !bench.writeCSV(csvPath)) {
+        std::cerr << "Could not write " << csvPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
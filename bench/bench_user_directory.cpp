@@ -0,0 +1,103 @@
+// ============================================================================
+// FILE: bench/bench_user_directory.cpp
+// Description: Compares UserDirectory lookups against the old linear scan
+//              that SystemManager::findUser used on a cache miss
+// ============================================================================
+
+#include "common.h"
+#include "User.h"
+#include "UserDirectory.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+// Old findUser miss path: walk the whole roster
+static std::shared_ptr<User> scanFind(const std::vector<std::shared_ptr<User>>& users,
+                                      const std::string& searchTerm) {
+    for (const auto& user : users) {
+        if (user->getId() == searchTerm || user->getName() == searchTerm) {
+            return user;
+        }
+    }
+    return nullptr;
+}
+
+static std::vector<std::shared_ptr<User>> makeUsers(size_t count) {
+    std::vector<std::shared_ptr<User>> users;
+    users.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string id = "EMP" + std::to_string(i);
+        std::string name = "First" + std::to_string(i % 5000) + " Last" + std::to_string(i / 5000);
+        auto card = std::make_shared<Card>("CARD" + std::to_string(i + 1),
+                                           intToClearanceLevel(static_cast<int>(i % 4)));
+        users.push_back(std::make_shared<User>(id, name, "bench@company.com", "0700000000", card));
+    }
+    return users;
+}
+
+// Run 'lookup' over all terms and return ns per lookup
+template<typename F>
+static double timeLookups(const std::vector<std::string>& terms, F lookup, size_t& found) {
+    auto start = BenchClock::now();
+    for (const auto& term : terms) {
+        if (lookup(term)) ++found;
+    }
+    auto ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+    return ns / terms.size();
+}
+
+int main() {
+    const size_t sizes[] = {1000, 100000, 1000000};
+    std::mt19937 gen(42);
+
+    std::cout << std::left << std::setw(10) << "users"
+              << std::setw(12) << "kind"
+              << std::setw(16) << "scan ns/op"
+              << std::setw(16) << "index ns/op"
+              << "speedup" << std::endl;
+
+    for (size_t count : sizes) {
+        auto users = makeUsers(count);
+        UserDirectory directory;
+        directory.rebuild(users);
+
+        // Fewer scan queries at large sizes so the run stays short
+        size_t scanQueries = std::max<size_t>(20, 20000000 / count);
+        size_t indexQueries = 200000;
+        std::uniform_int_distribution<size_t> pick(0, count - 1);
+
+        auto makeTerms = [&](size_t n, int kind) {
+            std::vector<std::string> terms;
+            for (size_t i = 0; i < n; ++i) {
+                if (kind == 0) terms.push_back(users[pick(gen)]->getId());
+                else if (kind == 1) terms.push_back(users[pick(gen)]->getName());
+                else terms.push_back("MISSING" + std::to_string(i));
+            }
+            return terms;
+        };
+
+        const char* kinds[] = {"id", "name", "miss"};
+        for (int kind = 0; kind < 3; ++kind) {
+            auto scanTerms = makeTerms(scanQueries, kind);
+            auto indexTerms = makeTerms(indexQueries, kind);
+
+            size_t scanFound = 0, indexFound = 0;
+            double scanNs = timeLookups(scanTerms,
+                [&](const std::string& t) { return scanFind(users, t); }, scanFound);
+            double indexNs = timeLookups(indexTerms,
+                [&](const std::string& t) { return directory.find(t); }, indexFound);
+
+            if (kind < 2 && (scanFound != scanQueries || indexFound != indexQueries)) {
+                std::cerr << "Lookup mismatch at " << count << " users" << std::endl;
+                return 1;
+            }
+
+            std::cout << std::left << std::setw(10) << count
+                      << std::setw(12) << kinds[kind]
+                      << std::setw(16) << std::fixed << std::setprecision(1) << scanNs
+                      << std::setw(16) << indexNs
+                      << std::setprecision(0) << (scanNs / indexNs) << "x" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+// ============================================================================
+// FILE: bench/bench_user_search.cpp
+// Description: Roster search: ranked top-k from the trie/trigram index
+//              against scoring every user, checked query by query against
+//              that brute force, before and after a run of incremental
+//              creates, renames and deletes
+// ============================================================================
+
+#include "common.h"
+#include "UserSearch.h"
+#include "DataGenerator.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+static const std::vector<std::string> FIRST = {
+    "Noah", "Oliver", "Elijah", "William", "James", "Benjamin", "Lucas", "Henry", "Mason",
+    "Michael", "Ethan", "Daniel", "Jacob", "Logan", "Jackson", "Jack", "Owen", "Samuel",
+    "Joseph", "David", "John", "Luke", "Isaac", "Ryan", "Thomas", "Olivia", "Emma", "Ava",
+    "Sophia", "Isabella", "Charlotte", "Amelia", "Mia", "Harper", "Evelyn", "Emily", "Sofia",
+    "Ella", "Madison", "Grace", "Chloe", "Riley", "Lily", "Nora", "Zoe", "Hannah", "Skylar",
+    "Naomi", "Elena", "Ruby", "Alice", "Claire", "Lucy", "Violet", "Anna", "Leah"
+};
+
+static const std::vector<std::string> LAST = {
+    "Smith", "Johnson", "Williams", "Brown", "Jones", "Garcia", "Rodriguez", "Martinez",
+    "Hernandez", "Lopez", "Miller", "Wilson", "Moore", "Taylor", "Anderson", "Thomas",
+    "Jackson", "Martin", "Lee", "Perez", "White", "Harris", "Clark", "Lewis", "Young",
+    "Hall", "Walker", "Allen", "Sanchez", "Kelly", "Baker", "King", "Wright", "Hill",
+    "Scott", "Green", "Adams", "Nelson", "Carter", "Mitchell", "Roberts", "Turner",
+    "Phillips", "Campbell", "Parker", "Evans", "Edwards", "Stewart", "Collins", "Davis"
+};
+
+static std::string lower(const std::string& text) {
+    std::string out(text);
+    for (char& c : out) c = static_cast<char>(::tolower(static_cast<unsigned char>(c)));
+    return out;
+}
+
+// Roster rows in the generator's shape: ID from the first name, email from both
+static void addUser(UserStore& users, std::mt19937& gen, std::unordered_map<std::string, size_t>& serial) {
+    const std::string& first = FIRST[gen() % FIRST.size()];
+    const std::string& last = LAST[gen() % LAST.size()];
+    std::string base = first.substr(0, 3);
+    for (char& c : base) c = static_cast<char>(::toupper(static_cast<unsigned char>(c)));
+    size_t n = serial[base]++;
+    std::string id = n ? base + std::to_string(n) : base;
+    users.add(id, first + " " + last, lower(first) + "." + lower(last) + "@company.com",
+              "0700000000", "CARD" + std::to_string(users.handleLimit()),
+              intToClearanceLevel(static_cast<int>(gen() % 4)), false);
+}
+
+// Reference: score every user, keep the k best
+static std::vector<SearchHit> bruteForce(const UserStore& users, const std::string& query, size_t k) {
+    std::vector<std::string> words = UserSearch::queryWords(query);
+    std::vector<SearchHit> hits;
+    if (words.empty()) return hits;
+    users.forEach([&](UserHandle user) {
+        uint32_t score;
+        if (UserSearch::score(users, user, words, score)) hits.push_back({user, score});
+    });
+    auto better = [](const SearchHit& a, const SearchHit& b) {
+        return a.score != b.score ? a.score < b.score : a.user < b.user;
+    };
+    size_t keep = std::min(k, hits.size());
+    std::partial_sort(hits.begin(), hits.begin() + keep, hits.end(), better);
+    hits.resize(keep);
+    return hits;
+}
+
+static bool sameHits(const std::vector<SearchHit>& a, const std::vector<SearchHit>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].user != b[i].user || a[i].score != b[i].score) return false;
+    }
+    return true;
+}
+
+static double msSince(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t k = SEARCH_RESULT_LIMIT;
+    std::mt19937 gen(42);
+
+    if (UserSearch::boundedDistance("philips", "phillips", 2) != 1 ||
+        UserSearch::boundedDistance("willaims", "williams", 2) != 2 ||
+        UserSearch::boundedDistance("kitten", "sitting", 2) != 3 ||
+        UserSearch::boundedDistance("", "abc", 5) != 3) {
+        std::cerr << "Edit distance mismatch" << std::endl;
+        return 1;
+    }
+
+    UserStore users;
+    users.reserve(count);
+    std::unordered_map<std::string, size_t> serial;
+    for (size_t i = 0; i < count; ++i) addUser(users, gen, serial);
+
+    UserSearch index;
+    auto start = BenchClock::now();
+    index.rebuild(users);
+    double rebuildMs = msSince(start);
+
+    const std::vector<std::string> queries = {
+        "Soph", "Philips", "sofia th", "SOF12", "sophia.ph", "Willaims", "s", "jon smith",
+        "emma wilson", "Hanah Parkr", "zzzz", "lucas 77", "thomas thomas"
+    };
+
+    // Each query: index against brute force, timed and checked
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Users: " << users.size() << ", terms: " << index.termCount()
+              << ", trie nodes: " << index.nodeCount() << ", index: " << index.memoryBytes() / (1024.0 * 1024.0) << " MB"
+              << ", rebuild: " << rebuildMs << " ms" << std::endl;
+    std::cout << std::left << std::setw(16) << "query" << std::setw(8) << "hits"
+              << std::setw(14) << "index (us)" << std::setw(14) << "scan (ms)" << "best match" << std::endl;
+    double worstUs = 0;
+    for (const auto& query : queries) {
+        const int reps = 20;
+        std::vector<SearchHit> hits;
+        start = BenchClock::now();
+        for (int r = 0; r < reps; ++r) hits = index.search(users, query, k);
+        double us = msSince(start) * 1000 / reps;
+        worstUs = std::max(worstUs, us);
+
+        start = BenchClock::now();
+        std::vector<SearchHit> expected = bruteForce(users, query, k);
+        double scanMs = msSince(start);
+        if (!sameHits(hits, expected)) {
+            std::cerr << "Search mismatch for '" << query << "'" << std::endl;
+            return 1;
+        }
+        std::cout << std::setw(16) << ("'" + query + "'") << std::setw(8) << hits.size()
+                  << std::setw(14) << us << std::setw(14) << scanMs
+                  << (hits.empty() ? std::string("-") : std::string(users.getName(hits[0].user)))
+                  << std::endl;
+    }
+
+    // Incremental upkeep: creates, renames, email changes and deletes
+    const int ops = 20000;
+    std::uniform_int_distribution<UserHandle> anyUser(0, static_cast<UserHandle>(users.handleLimit() - 1));
+    start = BenchClock::now();
+    for (int i = 0; i < ops; ++i) {
+        UserHandle user = anyUser(gen);
+        switch (i % 4) {
+        case 0:
+            addUser(users, gen, serial);
+            index.add(users, static_cast<UserHandle>(users.handleLimit() - 1));
+            break;
+        case 1:
+            if (!users.contains(user)) break;
+            index.remove(users, user);
+            users.setName(user, FIRST[gen() % FIRST.size()] + " " + LAST[gen() % LAST.size()]);
+            index.add(users, user);
+            break;
+        case 2:
+            if (!users.contains(user)) break;
+            index.remove(users, user);
+            users.setEmail(user, "user" + std::to_string(i) + "@company.com");
+            index.add(users, user);
+            break;
+        default:
+            if (!users.contains(user)) break;
+            index.remove(users, user);
+            users.remove(user);
+            break;
+        }
+    }
+    double updateUs = msSince(start) * 1000 / ops;
+
+    UserSearch fresh;
+    fresh.rebuild(users);
+    for (const auto& query : queries) {
+        std::vector<SearchHit> hits = index.search(users, query, k);
+        if (!sameHits(hits, bruteForce(users, query, k)) || !sameHits(hits, fresh.search(users, query, k))) {
+            std::cerr << "Search mismatch for '" << query << "' after updates" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << std::setprecision(2);
+    std::cout << "\nSlowest query: " << worstUs << " us (top " << k << ")" << std::endl;
+    std::cout << "Index update (create/rename/email/delete): " << updateUs << " us" << std::endl;
+    return 0;
+}
@@ -0,0 +1,191 @@
+// ============================================================================
+// FILE: bench/bench_user_store.cpp
+// Description: Heap bytes per user and full-scan / lookup speed of the
+//              UserStore arena against the shared_ptr<User> roster plus
+//              UserDirectory that SystemManager used to hold, and what
+//              compact() gives back after churn
+// ============================================================================
+
+#include "common.h"
+#include "User.h"
+#include "UserDirectory.h"
+#include "UserStore.h"
+#include <malloc.h>
+
+using BenchClock = std::chrono::steady_clock;
+
+// Bytes currently allocated from the heap, malloc overhead included
+static size_t heapInUse() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+// Generator-like rows: names repeat across the roster, emails don't
+struct Row {
+    std::string id, name, email, phone, cardId;
+    ClearanceLevel level;
+};
+
+static Row makeRow(size_t i) {
+    std::string first = "First" + std::to_string(i % 400);
+    std::string last = "Last" + std::to_string(i % 997);
+    return {"EMP" + std::to_string(i), first + " " + last,
+            first + "." + last + std::to_string(i) + "@company.com",
+            "07" + std::to_string(10000000 + i % 90000000),
+            "CARD" + std::to_string(i + 1), intToClearanceLevel(static_cast<int>(i % 4))};
+}
+
+template<typename F>
+static double timeMs(F body) {
+    auto start = BenchClock::now();
+    body();
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+int main() {
+    const size_t sizes[] = {100000, 1000000};
+    std::mt19937 gen(42);
+
+    std::cout << std::left << std::setw(10) << "users"
+              << std::setw(12) << "layout"
+              << std::setw(14) << "bytes/user"
+              << std::setw(12) << "scan ms"
+              << std::setw(14) << "id ns/op"
+              << "name ns/op" << std::endl;
+
+    for (size_t count : sizes) {
+        std::uniform_int_distribution<size_t> pick(0, count - 1);
+        std::vector<size_t> probes(200000);
+        for (auto& p : probes) p = pick(gen);
+        std::vector<Row> probeRows;
+        for (size_t p : probes) probeRows.push_back(makeRow(p));
+
+        // --- Old layout: one User + Card per row, plus the directory maps ---
+        uint64_t oldSum = 0;
+        double oldBytes, oldScan, oldIdNs, oldNameNs;
+        {
+            size_t before = heapInUse();
+            std::vector<std::shared_ptr<User>> users;
+            users.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                Row row = makeRow(i);
+                auto card = std::make_shared<Card>(row.cardId, row.level);
+                users.push_back(std::make_shared<User>(row.id, row.name, row.email, row.phone, card));
+            }
+            UserDirectory directory;
+            directory.rebuild(users);
+            oldBytes = double(heapInUse() - before) / count;
+
+            // What listUsers / publishAccessTables / saves touch per user
+            oldScan = timeMs([&]() {
+                for (const auto& user : users) {
+                    oldSum += user->getCard()->getClearanceLevelInt() + user->getId().size() +
+                              user->getEmail().size();
+                }
+            });
+
+            size_t found = 0;
+            oldIdNs = timeMs([&]() {
+                for (const auto& row : probeRows) found += directory.findById(row.id) != nullptr;
+            }) * 1e6 / probeRows.size();
+            oldNameNs = timeMs([&]() {
+                for (const auto& row : probeRows) found += directory.findByName(row.name) != nullptr;
+            }) * 1e6 / probeRows.size();
+            if (found != 2 * probeRows.size()) {
+                std::cerr << "UserDirectory lookup mismatch at " << count << " users" << std::endl;
+                return 1;
+            }
+        }
+
+        // --- UserStore: records + pooled strings + flat indexes ---
+        uint64_t newSum = 0;
+        double newBytes, newScan, newIdNs, newNameNs;
+        double compactMs, churnedMb, compactedMb;
+        {
+            size_t before = heapInUse();
+            UserStore store;
+            store.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                Row row = makeRow(i);
+                store.add(row.id, row.name, row.email, row.phone, row.cardId, row.level, false);
+            }
+            newBytes = double(heapInUse() - before) / count;
+
+            newScan = timeMs([&]() {
+                store.forEach([&](UserHandle user) {
+                    newSum += clearanceLevelToInt(store.getClearanceLevel(user)) +
+                              store.getId(user).size() + store.getEmail(user).size();
+                });
+            });
+
+            // Same answers as the directory: the handle of the first user
+            // with that ID / name (handles follow row order here)
+            size_t found = 0;
+            newIdNs = timeMs([&]() {
+                for (size_t i = 0; i < probeRows.size(); ++i) {
+                    found += store.findById(probeRows[i].id) == probes[i];
+                }
+            }) * 1e6 / probeRows.size();
+            newNameNs = timeMs([&]() {
+                for (const auto& row : probeRows) {
+                    UserHandle user = store.findByName(row.name);
+                    found += user != NO_USER && store.getName(user) == row.name;
+                }
+            }) * 1e6 / probeRows.size();
+            if (found != 2 * probeRows.size() || store.findById("MISSING") != NO_USER ||
+                store.findByName("Nobody Here") != NO_USER) {
+                std::cerr << "UserStore lookup mismatch at " << count << " users" << std::endl;
+                return 1;
+            }
+
+            // Churn: half the users leave, a quarter get a new email;
+            // compact() must keep every survivor, in order, under its ID
+            for (size_t i = 0; i < count; i += 2) store.remove(static_cast<UserHandle>(i));
+            for (size_t i = 1; i < count; i += 4) {
+                store.setEmail(static_cast<UserHandle>(i), "moved" + std::to_string(i) + "@company.com");
+            }
+            store.drainChanges([](UserHandle, bool) {});
+            churnedMb = store.memoryBytes() / 1e6;
+            bool due = store.needsCompaction();
+            std::vector<UserHandle> remap;
+            compactMs = timeMs([&]() { remap = store.compact(); });
+            compactedMb = store.memoryBytes() / 1e6;
+
+            bool ok = due && store.size() == count / 2 && store.handleLimit() == store.size();
+            for (size_t i = 0; ok && i < count; i += 7) {
+                Row row = makeRow(i);
+                std::string email = i % 4 == 1 ? "moved" + std::to_string(i) + "@company.com" : row.email;
+                ok = (i % 2 == 0) ? remap[i] == NO_USER && store.findById(row.id) == NO_USER
+                                  : remap[i] == static_cast<UserHandle>(i / 2) &&
+                                        store.findById(row.id) == remap[i] &&
+                                        store.getName(remap[i]) == row.name &&
+                                        store.getEmail(remap[i]) == email;
+            }
+            if (!ok) {
+                std::cerr << "UserStore compaction mismatch at " << count << " users" << std::endl;
+                return 1;
+            }
+        }
+
+        if (oldSum != newSum) {
+            std::cerr << "Scan mismatch at " << count << " users" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::fixed;
+        std::cout << std::left << std::setw(10) << count << std::setw(12) << "shared_ptr"
+                  << std::setw(14) << std::setprecision(0) << oldBytes
+                  << std::setw(12) << std::setprecision(2) << oldScan
+                  << std::setw(14) << std::setprecision(1) << oldIdNs << oldNameNs << std::endl;
+        std::cout << std::left << std::setw(10) << count << std::setw(12) << "UserStore"
+                  << std::setw(14) << std::setprecision(0) << newBytes
+                  << std::setw(12) << std::setprecision(2) << newScan
+                  << std::setw(14) << std::setprecision(1) << newIdNs << newNameNs << std::endl;
+        std::cout << "  memory " << std::setprecision(1) << (oldBytes / newBytes) << "x smaller, scan "
+                  << (oldScan / newScan) << "x faster" << std::endl;
+        std::cout << "  after churn " << churnedMb << " MB, compact() " << compactMs << " ms -> "
+                  << compactedMb << " MB" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+// ============================================================================
+// FILE: bench/bench_validator.cpp
+// Description: Checks the hand-written email/phone validators against the
+//              original std::regex patterns, then measures throughput
+// ============================================================================
+
+#include "common.h"
+#include "Validator.h"
+#include <regex>
+
+using BenchClock = std::chrono::steady_clock;
+
+// Results are written here so the optimizer keeps the timed loops
+static volatile uint64_t benchSink;
+
+// Reference implementations: the regex versions Validator used to run
+static bool regexEmail(const std::string& email) {
+    std::regex emailPattern(R"(^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}$)");
+    return std::regex_match(email, emailPattern);
+}
+
+static bool regexPhone(const std::string& phone) {
+    std::regex phonePattern(R"(^(07\d{8}|\+467\d{8})$)");
+    return std::regex_match(phone, phonePattern);
+}
+
+// Random strings over an alphabet biased towards the interesting characters
+static std::string randomString(std::mt19937& gen, const std::string& alphabet, size_t maxLen) {
+    std::uniform_int_distribution<size_t> len(0, maxLen);
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    std::string s(len(gen), ' ');
+    for (auto& ch : s) ch = alphabet[pick(gen)];
+    return s;
+}
+
+// Mutate one character of a valid value
+static std::string mutate(std::mt19937& gen, std::string s, const std::string& alphabet) {
+    if (s.empty()) return s;
+    std::uniform_int_distribution<size_t> pos(0, s.size() - 1);
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    std::uniform_int_distribution<int> op(0, 2);
+    switch (op(gen)) {
+        case 0: s[pos(gen)] = alphabet[pick(gen)]; break;
+        case 1: s.erase(pos(gen), 1); break;
+        default: s.insert(s.begin() + pos(gen), alphabet[pick(gen)]); break;
+    }
+    return s;
+}
+
+static bool differential(const std::vector<std::string>& emails, const std::vector<std::string>& phones) {
+    size_t mismatches = 0;
+    for (const auto& e : emails) {
+        if (Validator::validateEmail(e) != regexEmail(e)) {
+            if (++mismatches < 10) std::cerr << "email mismatch: \"" << e << "\"" << std::endl;
+        }
+    }
+    for (const auto& p : phones) {
+        if (Validator::validatePhone(p) != regexPhone(p)) {
+            if (++mismatches < 10) std::cerr << "phone mismatch: \"" << p << "\"" << std::endl;
+        }
+    }
+
+    // Batch masks must agree with the scalar calls
+    auto emailMask = Validator::validateEmails(emails);
+    for (size_t i = 0; i < emails.size(); ++i) {
+        if (((emailMask[i / 64] >> (i % 64)) & 1) != Validator::validateEmail(emails[i])) ++mismatches;
+    }
+    auto phoneMask = Validator::validatePhones(phones);
+    for (size_t i = 0; i < phones.size(); ++i) {
+        if (((phoneMask[i / 64] >> (i % 64)) & 1) != Validator::validatePhone(phones[i])) ++mismatches;
+    }
+
+    std::cout << "differential: " << emails.size() << " emails, " << phones.size()
+              << " phones, " << mismatches << " mismatches" << std::endl;
+    return mismatches == 0;
+}
+
+template<typename F>
+static double nsPerOp(const std::vector<std::string>& values, size_t rounds, F check) {
+    size_t valid = 0;
+    auto start = BenchClock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        for (const auto& v : values) valid += check(v);
+    }
+    auto ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+    benchSink = valid;
+    return ns / (values.size() * rounds);
+}
+
+template<typename F>
+static double nsPerOpBatch(const std::vector<std::string>& values, size_t rounds, F check) {
+    uint64_t bits = 0;
+    auto start = BenchClock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        for (uint64_t word : check(values)) bits ^= word;
+    }
+    auto ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+    benchSink = bits;
+    return ns / (values.size() * rounds);
+}
+
+int main() {
+    std::mt19937 gen(7);
+    const std::string emailAlphabet = "abcXYZ09._%+-@@..#! ";
+    const std::string phoneAlphabet = "0123456789+7704 a";
+
+    std::vector<std::string> emails = {
+        "", "@", "a@b.cc", "a@b.c", "@b.cc", "a@.cc", "a@b..cc", "a@b.c1", "a@@b.cc",
+        "a.b@c-d.ef", "a@b.cc.", "a@b.cc.d", "a@b.cc.dd", "first.last@company.com",
+        "x@y.z9z", "x@-.ab", "x@y.ab\n", "\xc3\xa5@b.cc", "a@b\xc3\xa5.cc", "a@b.c\xc3\xa5",
+        "abcdefgh@ijklmnop.qrstuvwx", "abcdefg@hijklmn.op", "a@bcdefghijklmno.p9rstuvw",
+    };
+    std::vector<std::string> phones = {
+        "", "07", "0712345678", "071234567", "07123456789", "+46712345678",
+        "+4671234567", "+46612345678", "0812345678", "07123a5678", "07/2345678",
+        "07:2345678", "+467123456789", "+46712345\xff" "78",
+    };
+
+    for (int i = 0; i < 20000; ++i) {
+        std::string name = randomString(gen, "abcdefghij", 8) + " " + randomString(gen, "klmnopqrst", 8);
+        std::string email = Validator::generateEmail(name);
+        emails.push_back(email);
+        emails.push_back(mutate(gen, email, emailAlphabet));
+        emails.push_back(randomString(gen, emailAlphabet, 12));
+
+        std::string phone = (i % 2) ? Validator::generatePhone() : "+467" + Validator::generatePhone().substr(2);
+        phones.push_back(phone);
+        phones.push_back(mutate(gen, phone, phoneAlphabet));
+        phones.push_back(randomString(gen, phoneAlphabet, 13));
+    }
+
+    if (!differential(emails, phones)) {
+        return 1;
+    }
+
+    std::cout << std::left << std::setw(10) << "field"
+              << std::setw(14) << "regex ns/op"
+              << std::setw(14) << "scalar ns/op"
+              << "batch ns/op" << std::endl;
+
+    double re = nsPerOp(emails, 1, regexEmail);
+    double sc = nsPerOp(emails, 50, Validator::validateEmail);
+    double ba = nsPerOpBatch(emails, 50, Validator::validateEmails);
+    std::cout << std::left << std::fixed << std::setprecision(1) << std::setw(10) << "email"
+              << std::setw(14) << re << std::setw(14) << sc << ba << std::endl;
+
+    re = nsPerOp(phones, 1, regexPhone);
+    sc = nsPerOp(phones, 50, Validator::validatePhone);
+    ba = nsPerOpBatch(phones, 50, Validator::validatePhones);
+    std::cout << std::left << std::setw(10) << "phone"
+              << std::setw(14) << re << std::setw(14) << sc << ba << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+// ============================================================================
+// FILE: bench/load_client.cpp
+// Description: Load generator for "main.exe --serve". Opens several
+//              connections, keeps a window of pipelined requests in flight on
+//              each and reports throughput and p50/p99/p99.9 latency
+//
+// Usage: load_client.exe [socket] [connections] [window] [requests/conn] [cards]
+//        (defaults: data/access.sock 4 64 100000 1000; cards are CARD1..N)
+// ============================================================================
+
+#include "common.h"
+#include "AccessServer.h"
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using BenchClock = std::chrono::steady_clock;
+
+struct ClientResult {
+    std::vector<uint64_t> latencyNs;
+    size_t outcomes[4] = {0, 0, 0, 0};  // Indexed by AccessResult
+    bool ok = true;
+};
+
+static int connectTo(const std::string& path) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent <= 0) return false;
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+static void runClient(const std::string& path, size_t window, size_t total, size_t cards,
+                      unsigned seed, ClientResult& result) {
+    int fd = connectTo(path);
+    if (fd < 0) {
+        result.ok = false;
+        return;
+    }
+
+    std::mt19937 gen(seed);
+    std::vector<AccessRequest> requests(total);
+    for (size_t i = 0; i < total; ++i) {
+        std::memset(&requests[i], 0, sizeof(AccessRequest));
+        requests[i].requestId = static_cast<uint32_t>(i);
+        std::string floorId = "F" + std::to_string(1 + gen() % 4);
+        std::string cardId = "CARD" + std::to_string(1 + gen() % cards);
+        std::memcpy(requests[i].floorId, floorId.data(), floorId.size());
+        std::memcpy(requests[i].cardId, cardId.data(), cardId.size());
+    }
+
+    std::vector<BenchClock::time_point> sentAt(total);
+    result.latencyNs.reserve(total);
+
+    size_t sent = 0, received = 0;
+    std::vector<char> pending;  // Partial response bytes
+    char buffer[64 * 1024];
+
+    while (received < total) {
+        // Top the window up with one write
+        size_t room = window - (sent - received);
+        size_t batch = std::min(room, total - sent);
+        if (batch > 0) {
+            auto now = BenchClock::now();
+            for (size_t i = 0; i < batch; ++i) sentAt[sent + i] = now;
+            if (!sendAll(fd, reinterpret_cast<const char*>(&requests[sent]), batch * sizeof(AccessRequest))) {
+                result.ok = false;
+                break;
+            }
+            sent += batch;
+        }
+
+        ssize_t got = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (got <= 0) {
+            result.ok = false;
+            break;
+        }
+        auto now = BenchClock::now();
+        pending.insert(pending.end(), buffer, buffer + got);
+
+        size_t complete = pending.size() / sizeof(AccessResponse);
+        for (size_t i = 0; i < complete; ++i) {
+            AccessResponse response;
+            std::memcpy(&response, pending.data() + i * sizeof(AccessResponse), sizeof(response));
+            if (response.requestId != received || response.result > ACCESS_UNKNOWN_FLOOR) {
+                result.ok = false;  // Out of order or garbage
+                break;
+            }
+            result.latencyNs.push_back(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - sentAt[received]).count()));
+            ++result.outcomes[response.result];
+            ++received;
+        }
+        if (!result.ok) break;
+        pending.erase(pending.begin(), pending.begin() + complete * sizeof(AccessResponse));
+    }
+
+    ::close(fd);
+}
+
+static double percentileUs(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[index] / 1000.0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : SERVER_SOCKET;
+    size_t connections = argc > 2 ? std::stoul(argv[2]) : 4;
+    size_t window = argc > 3 ? std::stoul(argv[3]) : 64;
+    size_t perConnection = argc > 4 ? std::stoul(argv[4]) : 100000;
+    size_t cards = argc > 5 ? std::stoul(argv[5]) : 1000;
+    if (connections == 0 || window == 0 || cards == 0) {
+        std::cerr << "connections, window and cards must be at least 1" << std::endl;
+        return 1;
+    }
+
+    std::vector<ClientResult> results(connections);
+    std::vector<std::thread> clients;
+    auto start = BenchClock::now();
+    for (size_t c = 0; c < connections; ++c) {
+        clients.emplace_back(runClient, path, window, perConnection, cards,
+                             static_cast<unsigned>(c + 1), std::ref(results[c]));
+    }
+    for (auto& client : clients) client.join();
+    double seconds = std::chrono::duration<double>(BenchClock::now() - start).count();
+
+    std::vector<uint64_t> all;
+    size_t outcomes[4] = {0, 0, 0, 0};
+    for (const auto& result : results) {
+        if (!result.ok) {
+            std::cerr << "A connection failed (is the server running on " << path << "?)" << std::endl;
+            return 1;
+        }
+        all.insert(all.end(), result.latencyNs.begin(), result.latencyNs.end());
+        for (int i = 0; i < 4; ++i) outcomes[i] += result.outcomes[i];
+    }
+    std::sort(all.begin(), all.end());
+
+    std::cout << "requests:      " << all.size() << " over " << connections
+              << " connections, window " << window << std::endl;
+    std::cout << "outcomes:      " << outcomes[ACCESS_GRANTED] << " granted, "
+              << outcomes[ACCESS_DENIED] << " denied, "
+              << outcomes[ACCESS_UNKNOWN_CARD] << " unknown card, "
+              << outcomes[ACCESS_UNKNOWN_FLOOR] << " unknown floor" << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "throughput:    " << (all.size() / seconds) << " requests/s" << std::endl;
+    std::cout << std::setprecision(1);
+    std::cout << "latency p50:   " << percentileUs(all, 50) << " us" << std::endl;
+    std::cout << "latency p99:   " << percentileUs(all, 99) << " us" << std::endl;
+    std::cout << "latency p99.9: " << percentileUs(all, 99.9) << " us" << std::endl;
+    return 0;
+}
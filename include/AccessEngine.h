@@ -0,0 +1,157 @@
+// ============================================================================
+// FILE: AccessEngine.h
+// Description: Batch access decisions over a structure-of-arrays clearance
+//              table (one byte per card, one per floor), compared 16 swipes
+//              at a time with SSE2 where available. Scheduled floors take
+//              their level for the batch's minute from their compiled
+//              table, and floors with allow/deny lists get those applied
+//              to the batch result afterwards. Doors are decided as their
+//              floor with the door's own minimum on top
+// ============================================================================
+
+#ifndef ACCESSENGINE_H
+#define ACCESSENGINE_H
+
+#include "common.h"
+#include "User.h"
+#include "Floor.h"
+#include "UserStore.h"
+#include "AuditLog.h"
+#include "RoaringBitmap.h"
+#include "SiteModel.h"
+#include "CardIndex.h"
+#include <unordered_map>
+
+// Dense indexes into the engine's tables, handed out by addCard/addFloor
+typedef uint32_t CardHandle;
+typedef uint32_t FloorHandle;
+
+// Set on handles that name a door; the low bits index the door tables
+const FloorHandle DOOR_HANDLE = 0x80000000u;
+
+class AccessEngine {
+private:
+    // Clearance table, indexed by handle
+    std::vector<uint8_t> cardClearance;
+    RoaringBitmap revokedCards;  // Handles of revoked cards, which never match
+    std::vector<uint8_t> floorClearance;
+    std::vector<uint8_t> floorMinimum;  // Building policy over the floor (see SiteModel)
+
+    // Doors by index: the floor each is on, and the door's minimum
+    std::vector<FloorHandle> doorFloor;
+    std::vector<uint8_t> doorMinimum;
+
+    // Per floor: its schedule table (MINUTES_PER_WEEK levels), empty when
+    // the floor has no scheduled windows and floorClearance applies
+    std::vector<std::vector<uint8_t>> floorSchedule;
+    size_t scheduledFloors;
+
+    // Pre-padded audit fields so a batch builds records without formatting
+    std::vector<AuditRecord> cardAudit;   // employeeId filled in
+    std::vector<AuditRecord> floorAudit;  // floorId filled in
+    std::vector<AuditRecord> doorAudit;   // floorId = the door's ID
+
+    // Per floor: its scs_access_total series (doors count as their floor)
+    std::vector<Counter*> floorGranted;
+    std::vector<Counter*> floorDenied;
+
+    // A floor's allow/deny lists by card handle (see Floor)
+    struct FloorExceptions {
+        RoaringBitmap allow;
+        RoaringBitmap deny;
+    };
+    std::vector<FloorExceptions> floorExceptions;  // Indexed by floor handle
+    size_t exceptionFloors;  // Floors with a non-empty list (0 = skip the pass)
+
+    CardIndex cardByCardId;  // Holds card handles; frozen by rebuild, so one probe
+    std::unordered_map<std::string, FloorHandle> floorByFloorId;  // Doors too
+
+    AuditLog* auditLog;  // Not owned, may be null
+
+    // Forget every card, floor and door
+    void reset();
+
+    // addCard without refreezing the card index (bulk loads freeze once)
+    CardHandle insertCard(const std::string& cardId, const std::string& employeeId,
+                          ClearanceLevel level);
+
+    // Register a floor with its schedule and allow/deny lists
+    FloorHandle loadFloor(const Floor& floor, const UserStore& users);
+
+    // Floor a floor or door handle belongs to (unknown: past the floor table)
+    FloorHandle floorOf(FloorHandle handle) const;
+
+    // Look up both levels for a run of swipes (unknown handles never match),
+    // and the floor each swipe is on (doors resolved); minute is the
+    // batch's minute of the week, only read for floors that have a
+    // schedule table
+    void gatherLevels(const CardHandle* cards, const FloorHandle* floors, size_t count,
+                      uint32_t minute, uint8_t* cardLevels, uint8_t* floorLevels,
+                      FloorHandle* swipeFloors) const;
+
+    // Apply the floors' allow/deny lists to decided bits (granted = bit i).
+    // An allowed card skips the floor's own level but still needs the
+    // building's and the door's minimum
+    bool applyExceptions(CardHandle card, FloorHandle floor, bool granted) const;
+
+public:
+    AccessEngine();
+
+    // Register cards and floors; adding an existing ID updates its level
+    CardHandle addCard(const std::string& cardId, const std::string& employeeId,
+                       ClearanceLevel level);
+    FloorHandle addFloor(const std::string& floorId, ClearanceLevel level);
+
+    // Register a door on a registered floor; adding an existing ID moves or
+    // updates it. Door handles have DOOR_HANDLE set, and findFloor returns
+    // them for door IDs, so readers name doors the way they name floors
+    FloorHandle addDoor(const std::string& doorId, FloorHandle floor, ClearanceLevel minimum);
+
+    // Forget a door (its swipes become unknown); false if it wasn't known
+    bool removeDoor(const std::string& doorId);
+
+    // Forget a card (its swipes become unknown, even on level-0 floors);
+    // false if it wasn't known
+    bool revokeCard(const std::string& cardId);
+
+    // Load every user's card and every floor, replacing what was there
+    // (with the floors' schedules and allow/deny lists)
+    void rebuild(const UserStore& users, const std::vector<Floor>& floors);
+    void rebuild(const UserStore& users, const SiteModel& site);
+
+    void setCardClearance(CardHandle card, ClearanceLevel level);
+    void setFloorClearance(FloorHandle floor, ClearanceLevel level);
+    void setFloorMinimum(FloorHandle floor, ClearanceLevel level);
+
+    // Copy a floor's schedule table (the floor must be registered)
+    bool setFloorSchedule(const Floor& floor);
+
+    // Copy a floor's allow/deny lists, mapping its user handles to the
+    // users' cards; false if the floor isn't registered
+    bool setFloorExceptions(const Floor& floor, const UserStore& users);
+
+    // Handle lookups, return false if the ID is unknown (findFloor also
+    // finds doors)
+    bool findCard(const std::string& cardId, CardHandle& handle) const;
+    bool findFloor(const std::string& floorId, FloorHandle& handle) const;
+
+    size_t cardCount() const;
+    size_t floorCount() const;
+    size_t doorCount() const;
+
+    // Audit every decided swipe in bulk (nullptr turns it off)
+    void setAuditLog(AuditLog* log);
+
+    // Decide swipe i = (cards[i], floors[i]) for count swipes, all at
+    // epochSeconds: bit i of the result (word i / 64, bit i % 64) is set
+    // when access is granted. Outcomes are counted per floor, and with an
+    // audit log set, the batch is appended to it in one call.
+    std::vector<uint64_t> decideBatch(const CardHandle* cards, const FloorHandle* floors,
+                                      size_t count, int64_t epochSeconds) const;
+
+    // Same decisions without SIMD or auditing (reference for the fast path)
+    std::vector<uint64_t> decideBatchScalar(const CardHandle* cards, const FloorHandle* floors,
+                                            size_t count, int64_t epochSeconds) const;
+};
+
+#endif // ACCESSENGINE_H
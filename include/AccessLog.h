@@ -0,0 +1,52 @@
+// ============================================================================
+// FILE: AccessLog.h
+// Description: Bounded per-floor access history - fixed-size records in a
+//              ring buffer, names and timestamps resolved only for display
+// ============================================================================
+
+#ifndef ACCESSLOG_H
+#define ACCESSLOG_H
+
+#include "common.h"
+#include "UserStore.h"
+#include <functional>
+
+// Employee ID and name behind a roster handle, looked up for display only
+// (empty strings if the handle names nobody)
+typedef std::function<std::pair<std::string, std::string>(UserHandle)> UserLookup;
+
+class AccessLog {
+private:
+    std::vector<AccessRecord> records;  // Ring buffer, oldest at 'head' once full
+    size_t head;                        // Next slot to overwrite when full
+    size_t capacity;                    // Retention cap (0 = keep nothing)
+
+public:
+    // Constructor
+    explicit AccessLog(size_t maxRecords = ACCESS_HISTORY_LIMIT);
+
+    // Record one swipe by a roster handle (NO_USER if the caller has none),
+    // overwriting the oldest record when the log is full
+    void record(UserHandle user, bool authorized, int64_t epochSeconds);
+
+    // Change the retention cap, keeping the newest records
+    void setCapacity(size_t maxRecords);
+    size_t getCapacity() const;
+
+    // Number of records retained
+    size_t size() const;
+
+    // i-th retained record, oldest first
+    const AccessRecord& at(size_t index) const;
+
+    // Follow the roster's handles through a compaction (old -> new);
+    // records of users it dropped show as unknown
+    void remapUsers(const std::vector<UserHandle>& remap);
+
+    // Print oldest first, resolving each user once through lookup
+    void display(const UserLookup& lookup) const;
+
+    void clear();
+};
+
+#endif // ACCESSLOG_H
@@ -0,0 +1,71 @@
+// ============================================================================
+// FILE: AccessSchedule.h
+// Description: Time windows for a floor's clearance level, compiled into a
+//              table with one entry per minute of the week, so checking a
+//              swipe is one index and one compare. Editing a rule only
+//              recompiles the minutes that rule covers
+// ============================================================================
+
+#ifndef ACCESSSCHEDULE_H
+#define ACCESSSCHEDULE_H
+
+#include "common.h"
+
+// One recurring window, e.g. Mon-Fri 09:00-17:00 at level 1
+struct ScheduleRule {
+    uint8_t days;           // Bit d set = the window opens on day d (0 = Monday)
+    uint16_t startMinute;   // Minute of the day the window opens
+    uint16_t endMinute;     // Minute it closes, exclusive (<= start: runs past midnight)
+    ClearanceLevel level;   // Minimum clearance inside the window
+};
+
+class AccessSchedule {
+private:
+    ClearanceLevel baseLevel;         // Applies outside every window
+    std::vector<ScheduleRule> rules;  // Later rules win where windows overlap
+    std::vector<uint8_t> table;       // Effective level per minute of the week,
+                                      // allocated only while there are rules
+
+    // Call fn(begin, end) for each run of minutes of the week a rule covers
+    template<typename F>
+    static void forEachSpan(const ScheduleRule& rule, F fn);
+
+    // Widen [begin, end) to take in every minute a rule covers
+    static void extendToRule(const ScheduleRule& rule, uint32_t& begin, uint32_t& end);
+
+    // Recompute table[begin, end) from the base level and the rules
+    // (allocating or freeing the table as rules come and go)
+    void recompile(uint32_t begin, uint32_t end);
+
+public:
+    explicit AccessSchedule(ClearanceLevel base = ClearanceLevel::LEVEL_0);
+
+    // The level outside every window (recompiles the whole table)
+    ClearanceLevel getBaseLevel() const;
+    void setBaseLevel(ClearanceLevel level);
+
+    // Rule edits; index is a position in getRules()
+    const std::vector<ScheduleRule>& getRules() const;
+    void addRule(const ScheduleRule& rule);
+    bool replaceRule(size_t index, const ScheduleRule& rule);
+    bool removeRule(size_t index);
+
+    // Effective minimum clearance at a minute of the week or a point in time
+    ClearanceLevel levelAt(uint32_t minute) const;
+    ClearanceLevel levelAtTime(int64_t epochSeconds) const;
+
+    // The compiled table (MINUTES_PER_WEEK levels), empty without rules
+    const std::vector<uint8_t>& getTable() const;
+
+    // Minute of the week in local time, 0 = Monday 00:00
+    static uint32_t minuteOfWeek(int64_t epochSeconds);
+
+    // Rule text, e.g. "Mon-Fri 09:00-17:00, level 1"
+    static std::string describe(const ScheduleRule& rule);
+
+    // Parse "Mon-Fri", "Sat,Sun", "all" and "HH:MM" (24:00 = midnight)
+    static bool parseDays(const std::string& text, uint8_t& days);
+    static bool parseTime(const std::string& text, uint16_t& minute);
+};
+
+#endif // ACCESSSCHEDULE_H
@@ -0,0 +1,87 @@
+// ============================================================================
+// FILE: AccessServer.h
+// Description: Headless badge-reader server on a Unix domain socket. One
+//              epoll thread watches the sockets, a fixed worker pool decides
+//              the pipelined requests of a connection as one batch
+// ============================================================================
+
+#ifndef ACCESSSERVER_H
+#define ACCESSSERVER_H
+
+#include "common.h"
+#include "AccessEngine.h"
+#include "RcuCell.h"
+#include <condition_variable>
+#include <deque>
+#include <unordered_set>
+
+// Wire format (host byte order, fixed size, any number in flight):
+//   request   32 bytes  client -> server
+//   response   8 bytes  server -> client, in request order
+// Strings are NUL-padded.
+struct AccessRequest {
+    uint32_t requestId;   // Echoed back in the response
+    char floorId[8];
+    char cardId[20];
+};
+
+struct AccessResponse {
+    uint32_t requestId;
+    uint8_t result;       // AccessResult
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(AccessRequest) == 32, "AccessRequest must stay 32 bytes");
+static_assert(sizeof(AccessResponse) == 8, "AccessResponse must stay 8 bytes");
+
+enum AccessResult : uint8_t {
+    ACCESS_DENIED = 0,
+    ACCESS_GRANTED = 1,
+    ACCESS_UNKNOWN_CARD = 2,
+    ACCESS_UNKNOWN_FLOOR = 3
+};
+
+class AccessServer {
+private:
+    struct Connection;
+
+    const RcuCell<AccessEngine>& tables;  // Current version pinned per batch
+    std::string socketPath;
+    size_t workerCount;
+
+    int listenFd;
+    int epollFd;
+    std::vector<std::thread> workers;
+
+    // Connections with input waiting; each is queued at most once at a time
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<Connection*> ready;
+    std::unordered_set<Connection*> connections;  // Every open connection
+    bool stopping;
+
+    void acceptConnections();
+    void workerLoop();
+
+    // Read, decide and answer everything available; false once the peer is gone
+    bool serviceConnection(Connection& conn);
+    void decideRequests(const AccessRequest* requests, size_t count,
+                        std::vector<AccessResponse>& responses);
+    bool rearm(Connection& conn);
+
+public:
+    AccessServer(const RcuCell<AccessEngine>& accessTables, const std::string& path, size_t threads);
+    ~AccessServer();
+
+    AccessServer(const AccessServer&) = delete;
+    AccessServer& operator=(const AccessServer&) = delete;
+
+    // Serve until stop() or SIGINT/SIGTERM; returns false if the socket
+    // could not be set up
+    bool run();
+
+    // Ask run() to return (safe from any thread)
+    static void stop();
+};
+
+#endif // ACCESSSERVER_H
@@ -15,13 +15,16 @@ private:
 
 public:
     // Constructor
-    Admin(const std::string& adminId, const std::string& adminName,
-          const std::string& adminEmail, const std::string& adminPhone,
-          std::shared_ptr<Card> adminCard, const std::string& adminPassword);
+    Admin(std::string adminId, std::string adminName,
+          std::string adminEmail, std::string adminPhone,
+          std::shared_ptr<Card> adminCard, std::string adminPassword);
 
     // Password verification
     bool verifyPassword(const std::string& inputPassword) const;
 
+    // Stored password (for persistence only)
+    const std::string& getPassword() const;
+
     // Override toCSV to include password
     std::string toCSV() const override;
 };
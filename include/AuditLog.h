@@ -0,0 +1,135 @@
+// ============================================================================
+// FILE: AuditLog.h
+// Description: Durable, append-only binary audit log of access attempts.
+//              Records are group-committed by a writer thread into fixed-size
+//              segment files; readers map the segments read-only
+// ============================================================================
+
+#ifndef AUDITLOG_H
+#define AUDITLOG_H
+
+#include "common.h"
+#include <condition_variable>
+#include <functional>
+
+// One access attempt, 32 bytes, strings NUL-padded (longer IDs are cut)
+struct AuditRecord {
+    int64_t epochSeconds;
+    char floorId[8];
+    char employeeId[15];
+    uint8_t authorized;  // 1 = granted, 0 = denied
+};
+
+static_assert(sizeof(AuditRecord) == 32, "AuditRecord must stay 32 bytes");
+
+AuditRecord makeAuditRecord(const std::string& floorId, const std::string& employeeId,
+                            bool authorized, int64_t epochSeconds);
+std::string auditFloorId(const AuditRecord& rec);
+std::string auditEmployeeId(const AuditRecord& rec);
+
+// On-disk segment (host byte order):
+//   AuditSegmentHeader   64 bytes
+//   AuditRecord          up to recordCapacity records
+// The newest segment is open (sealed = 0) and its record count is implied by
+// the file size. When it fills up, recordCount and the checksum over all its
+// records are written into the header and a new segment is started.
+struct AuditSegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t segmentNumber;
+    uint64_t recordCapacity;
+    uint64_t recordCount;  // Only valid once sealed
+    uint64_t checksum;     // Only valid once sealed
+    uint32_t sealed;
+    uint32_t reserved[3];
+};
+
+static_assert(sizeof(AuditSegmentHeader) == 64, "AuditSegmentHeader must stay 64 bytes");
+
+const uint32_t AUDIT_VERSION = 1;
+
+// Checksum over a run of records, chainable across calls
+uint64_t auditChecksum(const AuditRecord* records, size_t count,
+                       uint64_t seed = 14695981039346656037ULL);
+
+class AuditLog {
+private:
+    std::string directory;
+    size_t segmentRecords;   // Records per segment
+
+    // Writer side (only the writer thread touches these after open)
+    std::FILE* segment;
+    uint64_t segmentNumber;
+    uint64_t segmentCount;   // Records in the open segment
+    uint64_t segmentSum;     // Running checksum of the open segment
+
+    // Hand-off between appenders and the writer
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;   // Wakes the writer
+    std::condition_variable commitCondition;  // Wakes flush() and throttled appenders
+    std::vector<AuditRecord> pending;
+    uint64_t appended;    // Records handed to append so far
+    uint64_t committed;   // Records written and synced so far
+    uint64_t flushTarget; // Highest count a flush() is waiting for
+    bool stopping;
+    bool failed;
+    std::thread writer;
+
+    bool openSegment(uint64_t number);
+    bool resumeSegment(const std::string& path, uint64_t number);
+    bool sealSegment();
+    bool writeRecords(const AuditRecord* records, size_t count);
+    void writerLoop();
+
+public:
+    explicit AuditLog(size_t recordsPerSegment = AUDIT_SEGMENT_RECORDS);
+    ~AuditLog();
+
+    AuditLog(const AuditLog&) = delete;
+    AuditLog& operator=(const AuditLog&) = delete;
+
+    // Open (or create) the log in a directory and start the writer thread.
+    // Continues the newest segment if it was not sealed.
+    bool open(const std::string& dir);
+
+    // Stop the writer after committing everything queued
+    void close();
+
+    bool isOpen() const;
+
+    // Queue records; they reach disk with the next group commit. Blocks only
+    // when the writer has fallen AUDIT_MAX_PENDING records behind.
+    void append(const AuditRecord& record);
+    void append(const AuditRecord* records, size_t count);
+
+    // Wait until everything appended so far is written and synced
+    bool flush();
+
+    // Path of a segment file in dir
+    static std::string segmentPath(const std::string& dir, uint64_t number);
+};
+
+// Reads a log directory segment by segment through read-only mappings
+class AuditReader {
+private:
+    std::vector<std::string> segments;  // Oldest first
+    size_t corruptSegments;
+
+public:
+    AuditReader();
+
+    // Find the segment files, returns false if the directory is missing
+    bool open(const std::string& dir);
+
+    size_t segmentCount() const;
+
+    // Sealed segments whose checksum did not match (skipped by forEach)
+    size_t corruptCount() const;
+
+    // Call fn(const AuditRecord&) for every record, oldest first; returns
+    // the number of records visited
+    size_t forEach(const std::function<void(const AuditRecord&)>& fn);
+};
+
+#endif // AUDITLOG_H
@@ -1,72 +1,585 @@
 // ============================================================================
 // FILE: Cache.h
-// Description: Template-based LRU cache for recent user searches
+// Description: Template-based cache for recent user searches with pluggable
+//              eviction (LRU, CLOCK, W-TinyLFU), entry- or byte-sized
+//              capacity and O(1) generation-based invalidation, plus a
+//              thread-safe variant striped across independently locked shards
 // ============================================================================
 
 #ifndef CACHE_H
 #define CACHE_H
 
 #include "common.h"
-#include <list>
+#include "Metrics.h"
 #include <unordered_map>
+#include <optional>
+#include <functional>
+
+// ---------------------------------------------------------------------------
+// Weighers: how much of the capacity an entry uses
+// ---------------------------------------------------------------------------
+
+// Every entry counts as 1 (capacity = number of entries)
+template<typename K, typename V>
+struct EntryCountWeigher {
+    size_t operator()(const K&, const V&) const { return 1; }
+};
+
+// Approximate heap bytes of an entry (capacity = bytes)
+inline size_t cacheFootprint(const std::string& s) {
+    return sizeof(std::string) + (s.capacity() > 15 ? s.capacity() + 1 : 0);
+}
+
+template<typename T>
+size_t cacheFootprint(const T&) {
+    return sizeof(T);
+}
 
-// LRU Cache template for storing recently searched items
 template<typename K, typename V>
+struct ByteWeigher {
+    size_t operator()(const K& key, const V& value) const {
+        // Slot bookkeeping plus the index node, roughly
+        const size_t overhead = 64;
+        return overhead + cacheFootprint(key) + cacheFootprint(value);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Eviction policies. A policy only sees slot numbers (and key hashes); the
+// cache asks it which slot to evict next.
+// ---------------------------------------------------------------------------
+
+const uint32_t CACHE_NIL = UINT32_MAX;
+
+// Intrusive doubly-linked recency list over slot numbers
+class SlotList {
+private:
+    std::vector<uint32_t> prev;
+    std::vector<uint32_t> next;
+    uint32_t head;   // Most recent
+    uint32_t tail;   // Least recent
+    size_t count;
+
+public:
+    SlotList() : head(CACHE_NIL), tail(CACHE_NIL), count(0) {}
+
+    void resize(size_t slots) {
+        prev.resize(slots, CACHE_NIL);
+        next.resize(slots, CACHE_NIL);
+    }
+
+    void pushFront(uint32_t slot) {
+        prev[slot] = CACHE_NIL;
+        next[slot] = head;
+        if (head != CACHE_NIL) prev[head] = slot;
+        head = slot;
+        if (tail == CACHE_NIL) tail = slot;
+        ++count;
+    }
+
+    void unlink(uint32_t slot) {
+        if (prev[slot] != CACHE_NIL) next[prev[slot]] = next[slot];
+        else head = next[slot];
+        if (next[slot] != CACHE_NIL) prev[next[slot]] = prev[slot];
+        else tail = prev[slot];
+        --count;
+    }
+
+    void moveToFront(uint32_t slot) {
+        if (head == slot) return;
+        unlink(slot);
+        pushFront(slot);
+    }
+
+    uint32_t back() const { return tail; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void clear() {
+        head = tail = CACHE_NIL;
+        count = 0;
+    }
+};
+
+// Least recently used
+class LruPolicy {
+private:
+    SlotList order;
+
+public:
+    void resize(size_t slots) { order.resize(slots); }
+    void onInsert(uint32_t slot, size_t) { order.pushFront(slot); }
+    void onHit(uint32_t slot, size_t) { order.moveToFront(slot); }
+    void onMiss(size_t) {}
+    void onErase(uint32_t slot) { order.unlink(slot); }
+    uint32_t victim() { return order.back(); }
+    void clear() { order.clear(); }
+};
+
+// CLOCK (second chance): a hit only sets a reference bit; the hand sweeps
+// the slots and evicts the first one not referenced since its last pass
+class ClockPolicy {
+private:
+    std::vector<uint8_t> referenced;
+    std::vector<uint8_t> present;
+    size_t hand = 0;
+
+public:
+    void resize(size_t slots) {
+        referenced.resize(slots, 0);
+        present.resize(slots, 0);
+    }
+    void onInsert(uint32_t slot, size_t) {
+        present[slot] = 1;
+        referenced[slot] = 0;
+    }
+    void onHit(uint32_t slot, size_t) { referenced[slot] = 1; }
+    void onMiss(size_t) {}
+    void onErase(uint32_t slot) { present[slot] = 0; }
+
+    uint32_t victim() {
+        // The cache only asks when it holds at least one entry
+        while (true) {
+            if (hand >= present.size()) hand = 0;
+            size_t slot = hand++;
+            if (!present[slot]) continue;
+            if (referenced[slot]) {
+                referenced[slot] = 0;
+                continue;
+            }
+            return static_cast<uint32_t>(slot);
+        }
+    }
+
+    void clear() {
+        std::fill(referenced.begin(), referenced.end(), 0);
+        std::fill(present.begin(), present.end(), 0);
+        hand = 0;
+    }
+};
+
+// Count-min sketch of recent key frequencies (4-bit counters, 4 rows),
+// halved periodically so old popularity fades
+class FrequencySketch {
+private:
+    std::vector<uint8_t> counters;  // 4 rows of 'width' counters
+    size_t width = 0;               // Power of two
+    size_t additions = 0;
+    size_t sampleSize = 0;          // Additions between halvings
+
+    size_t indexOf(size_t hash, int row) const {
+        uint64_t h = (static_cast<uint64_t>(hash) + row) * 0x9E3779B97F4A7C15ULL;
+        return row * width + static_cast<size_t>((h ^ (h >> 29)) & (width - 1));
+    }
+
+public:
+    void ensureCapacity(size_t entries) {
+        // ~8 counters per entry per row keep collision noise well below a
+        // popular key's count over a sample of ~10 additions per entry
+        size_t wanted = 64;
+        while (wanted < entries * 8) wanted <<= 1;
+        if (wanted <= width) return;
+        width = wanted;
+        counters.assign(4 * width, 0);
+        additions = 0;
+        sampleSize = width + width / 4;
+    }
+
+    void increment(size_t hash) {
+        if (width == 0) return;
+        for (int row = 0; row < 4; ++row) {
+            uint8_t& c = counters[indexOf(hash, row)];
+            if (c < 15) ++c;
+        }
+        if (++additions >= sampleSize) {
+            for (auto& c : counters) c >>= 1;
+            additions /= 2;
+        }
+    }
+
+    uint8_t estimate(size_t hash) const {
+        if (width == 0) return 0;
+        uint8_t best = 15;
+        for (int row = 0; row < 4; ++row) {
+            best = std::min(best, counters[indexOf(hash, row)]);
+        }
+        return best;
+    }
+
+    void clear() {
+        std::fill(counters.begin(), counters.end(), 0);
+        additions = 0;
+    }
+};
+
+// W-TinyLFU: new entries land in a small LRU window (~1% of entries). The
+// entry pushed out of the window joins the main region's probation list as
+// the admission candidate; at eviction time it only stays if the sketch says
+// it is requested more often than probation's oldest entry, so one-off
+// lookups and scans can't flush the popular entries. A hit in probation
+// moves an entry to the protected list (up to 80% of the entries).
+class TinyLfuPolicy {
+private:
+    enum Region : uint8_t { WINDOW, PROBATION, PROTECTED };
+
+    SlotList window;
+    SlotList probation;
+    SlotList protectedList;
+    std::vector<uint8_t> region;
+    std::vector<size_t> hashes;
+    uint32_t candidate = CACHE_NIL;  // Last entry moved out of the window
+    FrequencySketch sketch;
+
+    size_t entries() const {
+        return window.size() + probation.size() + protectedList.size();
+    }
+
+    void move(uint32_t slot, SlotList& from, SlotList& to, Region where) {
+        from.unlink(slot);
+        region[slot] = where;
+        to.pushFront(slot);
+    }
+
+public:
+    void resize(size_t slots) {
+        window.resize(slots);
+        probation.resize(slots);
+        protectedList.resize(slots);
+        region.resize(slots, WINDOW);
+        hashes.resize(slots, 0);
+        sketch.ensureCapacity(slots);
+    }
+
+    void onInsert(uint32_t slot, size_t hash) {
+        hashes[slot] = hash;
+        region[slot] = WINDOW;
+        window.pushFront(slot);  // The access was counted by the miss
+        if (window.size() > std::max<size_t>(1, entries() / 100)) {
+            candidate = window.back();
+            move(candidate, window, probation, PROBATION);
+        }
+    }
+
+    void onHit(uint32_t slot, size_t hash) {
+        sketch.increment(hash);
+        if (slot == candidate) candidate = CACHE_NIL;
+        if (region[slot] == WINDOW) {
+            window.moveToFront(slot);
+        } else if (region[slot] == PROTECTED) {
+            protectedList.moveToFront(slot);
+        } else {
+            move(slot, probation, protectedList, PROTECTED);
+            if (protectedList.size() > entries() * 4 / 5) {
+                move(protectedList.back(), protectedList, probation, PROBATION);
+            }
+        }
+    }
+
+    void onMiss(size_t hash) { sketch.increment(hash); }
+
+    void onErase(uint32_t slot) {
+        if (slot == candidate) candidate = CACHE_NIL;
+        if (region[slot] == WINDOW) window.unlink(slot);
+        else if (region[slot] == PROBATION) probation.unlink(slot);
+        else protectedList.unlink(slot);
+    }
+
+    uint32_t victim() {
+        if (probation.empty()) {
+            return protectedList.empty() ? window.back() : protectedList.back();
+        }
+        uint32_t incumbent = probation.back();
+        if (candidate == CACHE_NIL || candidate == incumbent) return incumbent;
+
+        // The candidate is admitted only if it is the more frequent of the two
+        uint32_t loser = sketch.estimate(hashes[candidate]) > sketch.estimate(hashes[incumbent])
+                             ? incumbent : candidate;
+        candidate = CACHE_NIL;
+        return loser;
+    }
+
+    void clear() {
+        window.clear();
+        probation.clear();
+        protectedList.clear();
+        candidate = CACHE_NIL;
+        sketch.clear();
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Cache
+// ---------------------------------------------------------------------------
+
+// Cache template for storing recently searched items. Capacity is in
+// Weigher units (entries by default). Entries put before the last
+// invalidate() are dropped when next seen, so invalidation is O(1).
+template<typename K, typename V, typename Policy = LruPolicy,
+         typename Weigher = EntryCountWeigher<K, V>>
 class LRUCache {
 private:
-    int capacity;
-    std::list<std::pair<K, V>> cacheList;  // Most recent at front
-    std::unordered_map<K, typename std::list<std::pair<K, V>>::iterator> cacheMap;
+    struct Entry {
+        K key;
+        V value;
+        size_t weight;
+        uint64_t generation;
+    };
+
+    size_t capacity;
+    size_t used;          // Sum of entry weights
+    uint64_t generation;  // Bumped by invalidate()
+    std::vector<std::optional<Entry>> slots;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<K, uint32_t> cacheMap;
+    Policy policy;
+    Weigher weigher;
+    const CacheMetrics* metrics;  // Optional registry counters (not owned)
+
+    void eraseSlot(uint32_t slot) {
+        policy.onErase(slot);
+        used -= slots[slot]->weight;
+        cacheMap.erase(slots[slot]->key);
+        slots[slot].reset();
+        freeSlots.push_back(slot);
+    }
+
+    uint32_t allocateSlot() {
+        if (!freeSlots.empty()) {
+            uint32_t slot = freeSlots.back();
+            freeSlots.pop_back();
+            return slot;
+        }
+        slots.emplace_back();
+        policy.resize(slots.size());
+        return static_cast<uint32_t>(slots.size() - 1);
+    }
 
 public:
     // Constructor
-    explicit LRUCache(int cap) : capacity(cap) {}
+    explicit LRUCache(size_t cap, Weigher w = Weigher())
+        : capacity(cap), used(0), generation(0), weigher(w), metrics(nullptr) {}
+
+    // Report hits, misses and evictions into these counters (null = off)
+    void setMetrics(const CacheMetrics* m) {
+        metrics = m;
+    }
 
-    // Get value from cache, returns nullptr if not found
+    // Get value from cache, returns nullptr if not found. The pointer is
+    // valid until the next put/clear.
     V* get(const K& key) {
+        size_t hash = std::hash<K>()(key);
         auto it = cacheMap.find(key);
         if (it == cacheMap.end()) {
+            policy.onMiss(hash);
+            if (metrics && metrics->misses) metrics->misses->add();
             return nullptr;  // Cache miss
         }
 
-        // Move to front (most recently used)
-        cacheList.splice(cacheList.begin(), cacheList, it->second);
-        return &(it->second->second);
+        uint32_t slot = it->second;
+        if (slots[slot]->generation != generation) {
+            eraseSlot(slot);  // Put before the last invalidate()
+            policy.onMiss(hash);
+            if (metrics && metrics->misses) metrics->misses->add();
+            return nullptr;
+        }
+
+        policy.onHit(slot, hash);
+        if (metrics && metrics->hits) metrics->hits->add();
+        return &slots[slot]->value;
     }
 
-    // Put key-value pair in cache
-    void put(const K& key, const V& value) {
+    // Put key-value pair in cache, returns how many entries were evicted
+    // to make room. An entry heavier than the whole capacity isn't cached.
+    size_t put(const K& key, const V& value) {
+        size_t weight = weigher(key, value);
+        size_t hash = std::hash<K>()(key);
+
         auto it = cacheMap.find(key);
-        
         if (it != cacheMap.end()) {
-            // Update existing entry and move to front
-            it->second->second = value;
-            cacheList.splice(cacheList.begin(), cacheList, it->second);
-            return;
+            eraseSlot(it->second);  // Re-inserted below with the new weight
         }
+        if (weight > capacity) return 0;
 
-        // Add new entry at front
-        if (cacheList.size() >= static_cast<size_t>(capacity)) {
-            // Remove least recently used (back)
-            auto last = cacheList.back();
-            cacheMap.erase(last.first);
-            cacheList.pop_back();
+        size_t evicted = 0;
+        while (used + weight > capacity && !cacheMap.empty()) {
+            eraseSlot(policy.victim());
+            ++evicted;
         }
 
-        cacheList.emplace_front(key, value);
-        cacheMap[key] = cacheList.begin();
+        uint32_t slot = allocateSlot();
+        slots[slot] = Entry{key, value, weight, generation};
+        cacheMap.emplace(key, slot);
+        used += weight;
+        policy.onInsert(slot, hash);
+        if (evicted && metrics && metrics->evictions) metrics->evictions->add(evicted);
+        return evicted;
+    }
+
+    // Drop a single key
+    bool erase(const K& key) {
+        auto it = cacheMap.find(key);
+        if (it == cacheMap.end()) return false;
+        eraseSlot(it->second);
+        return true;
+    }
+
+    // Make every current entry invisible (they are reclaimed lazily)
+    void invalidate() {
+        ++generation;
     }
 
     // Clear cache
     void clear() {
-        cacheList.clear();
+        slots.clear();
+        freeSlots.clear();
         cacheMap.clear();
+        policy.clear();
+        used = 0;
     }
 
-    // Get size
+    // Get size (entries, including ones invalidated but not yet dropped)
     size_t size() const {
-        return cacheList.size();
+        return cacheMap.size();
+    }
+
+    // Capacity used, in Weigher units
+    size_t weight() const {
+        return used;
+    }
+};
+
+// Per-shard counters of a ShardedLRUCache
+struct CacheShardStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t size = 0;
+    size_t weight = 0;
+};
+
+// Thread-safe cache: keys are striped by hash across Shards independent
+// LRUCaches, each behind its own mutex, so threads touching different
+// shards never contend. Eviction is decided per shard.
+template<typename K, typename V, size_t Shards = 8, typename Policy = LruPolicy,
+         typename Weigher = EntryCountWeigher<K, V>>
+class ShardedLRUCache {
+private:
+    static_assert(Shards > 0, "ShardedLRUCache needs at least one shard");
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        LRUCache<K, V, Policy, Weigher> cache;
+        CacheShardStats stats;
+
+        Shard(size_t cap, const Weigher& w) : cache(cap, w) {}
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    Shard& shardFor(const K& key) const {
+        // Mix the hash so shard choice doesn't reuse the low bits the
+        // shard's own hash table buckets by
+        uint64_t h = static_cast<uint64_t>(std::hash<K>()(key));
+        h = (h ^ (h >> 32)) * 0x9E3779B97F4A7C15ULL;
+        return *shards[(h >> 32) % Shards];
+    }
+
+public:
+    // Total capacity (Weigher units) is split evenly, at least 1 per shard
+    explicit ShardedLRUCache(size_t cap, Weigher w = Weigher()) {
+        size_t perShard = std::max<size_t>(1, (cap + Shards - 1) / Shards);
+        for (size_t i = 0; i < Shards; ++i) {
+            shards.emplace_back(new Shard(perShard, w));
+        }
+    }
+
+    // Get a copy of the cached value (a pointer into the cache would not
+    // survive another thread's put), std::nullopt if not found
+    std::optional<V> get(const K& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        V* value = shard.cache.get(key);
+        if (!value) {
+            ++shard.stats.misses;
+            return std::nullopt;
+        }
+        ++shard.stats.hits;
+        return *value;
+    }
+
+    // Put key-value pair in its shard
+    void put(const K& key, const V& value) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.stats.evictions += shard.cache.put(key, value);
+    }
+
+    bool erase(const K& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.cache.erase(key);
+    }
+
+    // Report every shard's hits, misses and evictions into these counters
+    void setMetrics(const CacheMetrics* m) {
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->cache.setMetrics(m);
+        }
+    }
+
+    // Make every entry put so far invisible, O(shards)
+    void invalidate() {
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->cache.invalidate();
+        }
+    }
+
+    // Clear every shard (counters are kept)
+    void clear() {
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->cache.clear();
+        }
+    }
+
+    // Get size (sum over shards, each read under its own lock)
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            total += shard->cache.size();
+        }
+        return total;
+    }
+
+    static constexpr size_t shardCount() {
+        return Shards;
+    }
+
+    // Counters of one shard, and summed over all shards
+    CacheShardStats shardStats(size_t index) const {
+        const Shard& shard = *shards[index];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        CacheShardStats result = shard.stats;
+        result.size = shard.cache.size();
+        result.weight = shard.cache.weight();
+        return result;
+    }
+
+    CacheShardStats totalStats() const {
+        CacheShardStats total;
+        for (size_t i = 0; i < Shards; ++i) {
+            CacheShardStats one = shardStats(i);
+            total.hits += one.hits;
+            total.misses += one.misses;
+            total.evictions += one.evictions;
+            total.size += one.size;
+            total.weight += one.weight;
+        }
+        return total;
     }
 };
 
-#endif // CACHE_H
\ No newline at end of file
+#endif // CACHE_H
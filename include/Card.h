@@ -15,10 +15,10 @@ private:
 
 public:
     // Constructor
-    Card(const std::string& cardId, ClearanceLevel level);
+    Card(std::string cardId, ClearanceLevel level);
 
     // Getters
-    std::string getId() const;
+    const std::string& getId() const;
     ClearanceLevel getClearanceLevel() const;
     int getClearanceLevelInt() const;
 
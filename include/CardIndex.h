@@ -0,0 +1,77 @@
+// ============================================================================
+// FILE: CardIndex.h
+// Description: Card ID -> holder index for reader-driven lookups. The card
+//              set is frozen into an immutable perfect-hash table (one probe
+//              per lookup); changes made since sit in a small overlay until
+//              the next freeze
+// ============================================================================
+
+#ifndef CARDINDEX_H
+#define CARDINDEX_H
+
+#include "common.h"
+#include "UserStore.h"
+#include <string_view>
+#include <unordered_map>
+
+// Holder of the admin's card (the admin is not in the UserStore)
+const UserHandle ADMIN_USER = NO_USER - 1;
+
+struct CardEntry {
+    std::string_view cardId;
+    UserHandle holder;
+};
+
+class CardIndex {
+private:
+    // Frozen table: FNV-1a picks a bucket, the bucket's seed picks the slot.
+    // Seeds are found at freeze time so that no two cards share a slot.
+    struct Slot {
+        StringPool::Ref cardId;
+        UserHandle holder;  // NO_USER = empty slot
+    };
+    std::vector<uint32_t> seeds;  // One per bucket
+    std::vector<Slot> slots;
+    StringPool keys;              // Card IDs of the frozen table
+    size_t frozenCount;
+
+    // Changed since the last freeze; NO_USER marks a removed card
+    std::unordered_map<std::string, UserHandle> changes;
+    size_t liveCount;
+
+    UserHandle findFrozen(std::string_view cardId) const;
+
+public:
+    CardIndex();
+
+    // Replace the whole index with these cards and freeze it. A card ID
+    // listed twice keeps its first holder.
+    void build(const std::vector<CardEntry>& entries);
+
+    // Incremental changes, kept in the overlay until the next freeze
+    void add(const std::string& cardId, UserHandle holder);
+    void remove(const std::string& cardId);
+
+    // Holder of a card, NO_USER if nobody holds it
+    UserHandle find(const std::string& cardId) const;
+
+    // Fold the overlay into a new frozen table
+    void freeze();
+
+    // For a copy of 'live' frozen while live kept changing: bring over the
+    // changes made since the copy was taken (into this overlay). Entries the
+    // copy already has are skipped, so this costs O(live's overlay).
+    void catchUp(const CardIndex& live);
+
+    // Follow the roster's handles through a compaction (old -> new);
+    // ADMIN_USER stays as it is
+    void remapHolders(const std::vector<UserHandle>& remap);
+
+    // True once the overlay is big enough that refreezing pays off
+    bool needsFreeze() const;
+
+    size_t size() const;
+    size_t pendingChanges() const;
+};
+
+#endif // CARDINDEX_H
@@ -0,0 +1,46 @@
+// ============================================================================
+// FILE: ChangeJournal.h
+// Description: Append-only journal of roster changes made since the CSV file
+//              was last rewritten
+// ============================================================================
+
+#ifndef CHANGEJOURNAL_H
+#define CHANGEJOURNAL_H
+
+#include "common.h"
+
+// One line per record:
+//   U,<row in users.csv format>   user created or changed (upsert by ID)
+//   D,<employee ID>               user deleted
+// A line without its trailing newline was torn by a crash: read() ignores it
+// and cuts it off, so the next append starts on a fresh line.
+struct JournalRecord {
+    bool isDelete;
+    std::string payload;  // CSV row (upsert) or employee ID (delete)
+};
+
+class ChangeJournal {
+private:
+    std::string path;
+    size_t records;  // Complete records currently in the file
+    bool torn;       // The file may end mid-line (a write failed)
+
+public:
+    // Constructor
+    explicit ChangeJournal(const std::string& journalPath);
+
+    // Append a batch of changes, in the order they were made, as one
+    // write synced to the device; returns false on I/O error
+    bool append(const std::vector<JournalRecord>& changes);
+
+    // Read all complete records in order, dropping a torn last line
+    std::vector<JournalRecord> read();
+
+    // Empty the journal (after the CSV file has been rewritten)
+    void truncate();
+
+    // Number of records in the journal
+    size_t size() const;
+};
+
+#endif // CHANGEJOURNAL_H
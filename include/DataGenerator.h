@@ -6,7 +6,15 @@
 #include "Admin.h"
 #include "DataManager.h"
 
-// Generate 1000 users and 1 admin with randomized names
+// Generate INITIAL_USER_COUNT users and 1 admin with randomized names
 void generateInitialData();
 
-#endif
\ No newline at end of file
+// Write the admin and 'userCount' users to 'path' in the DATA_FILE format.
+// The same seed always gives the same file, whatever the thread count
+// (0 = one per hardware thread): every chunk of ROSTER_CHUNK_ROWS rows has
+// its own random stream. Chunks are streamed to the file in order, so
+// memory use doesn't grow with userCount. Returns false on I/O errors.
+bool generateRoster(const std::string& path, size_t userCount, uint64_t seed,
+                    size_t threads = 0);
+
+#endif
@@ -10,23 +10,83 @@
 #include "User.h"
 #include "Admin.h"
 #include "Floor.h"
+#include "IdAllocator.h"
+#include "UserSnapshot.h"
+#include "UserStore.h"
+#include "ChangeJournal.h"
+
+// One entry of a floor's allow or deny list, as kept in EXCEPTIONS_FILE
+// (by employee ID, since user handles only last for one run)
+struct FloorException {
+    std::string floorId;
+    std::string userId;
+    bool allowed;  // false = denied
+};
 
 class DataManager {
 private:
     std::mutex dataMutex;  // Mutex for thread-safe operations
+    IdAllocator idAllocator;  // Employee IDs in use, rebuilt on load
+    std::shared_ptr<const UserSnapshot> unreservedIds;  // Snapshot whose IDs aren't in idAllocator yet
+    const UserStore* unreservedStore;  // Same for a store loaded from CSV (the caller keeps it alive)
+    std::vector<std::string> deferredReleases;  // IDs released while either was pending
+    ChangeJournal journal;    // Changes since DATA_FILE was last rewritten
+
+    // Move the IDs of a lazily loaded snapshot or store into the allocator
+    void reservePendingIds();
 
 public:
-    // Load users and admin from CSV file
-    void loadFromCSV(std::vector<std::shared_ptr<User>>& users,
-                     std::shared_ptr<Admin>& admin);
+    // Constructor
+    DataManager();
+
+    // Load users and admin from CSV file (memory-mapped, parsed in parallel).
+    // Extra fields past the password are ignored. The loaded IDs go into
+    // the allocator only when one is first needed, so 'users' must outlive
+    // this DataManager's ID calls.
+    void loadFromCSV(UserStore& users, std::shared_ptr<Admin>& admin);
+
+    // Save users and admin to CSV file and regenerate the snapshot (thread-safe).
+    // Returns false if the CSV could not be written; the old file is kept.
+    bool saveToCSV(const UserStore& users, const std::shared_ptr<Admin>& admin);
+
+    // Map the binary snapshot if it is up to date with the CSV file,
+    // returns nullptr otherwise
+    std::shared_ptr<UserSnapshot> openSnapshot();
+
+    // Write the binary snapshot for the current CSV file
+    void saveSnapshot(const UserStore& users, const std::shared_ptr<Admin>& admin);
+
+    // Append changed rows (User::toCSV format) and deleted IDs to the
+    // journal, in the order given
+    bool appendToJournal(const std::vector<JournalRecord>& changes);
+
+    // Journal records to replay on top of the loaded CSV/snapshot
+    std::vector<JournalRecord> readJournal();
+
+    // True once the journal is large enough that rewriting the CSV pays off
+    bool journalNeedsCompaction(size_t userCount) const;
+
+    // Rewrite CSV + snapshot from the full roster and empty the journal
+    void compact(const UserStore& users, const std::shared_ptr<Admin>& admin);
+
+    // Replace EXCEPTIONS_FILE with these entries (thread-safe). Returns
+    // false if it could not be written; the old file is kept.
+    bool saveFloorExceptions(const std::vector<FloorException>& exceptions);
+
+    // Entries of EXCEPTIONS_FILE, empty if there is none
+    std::vector<FloorException> loadFloorExceptions();
+
+    // Drop the journal (e.g. when a fresh data file is generated)
+    void clearJournal();
+
+    // Generate unique employee ID with suffix if needed (amortized O(1))
+    std::string generateUniqueId(const std::string& baseName);
 
-    // Save users and admin to CSV file (thread-safe)
-    void saveToCSV(const std::vector<std::shared_ptr<User>>& users,
-                   const std::shared_ptr<Admin>& admin);
+    // Return an employee ID to the pool (call when a user is deleted)
+    void releaseId(const std::string& id);
 
-    // Generate unique employee ID with suffix if needed
-    std::string generateUniqueId(const std::string& baseName,
-                                  const std::vector<std::shared_ptr<User>>& users);
+    // Mark an ID as taken (users restored from the journal)
+    void reserveId(const std::string& id);
 
     // Parse CSV line
     std::vector<std::string> parseCSVLine(const std::string& line);
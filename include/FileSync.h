@@ -0,0 +1,25 @@
+// ============================================================================
+// FILE: FileSync.h
+// Description: Push written files to the device, not just the OS cache, for
+//              data that must survive a power loss
+// ============================================================================
+
+#ifndef FILESYNC_H
+#define FILESYNC_H
+
+#include "common.h"
+
+// Sync a closed file's data by path; returns false if it can't be opened
+// or the device reports an error
+bool syncFile(const std::string& path);
+
+// Sync a directory's entries, so a file created or renamed in it stays
+// there after a power loss
+bool syncDirectory(const std::string& path);
+
+// Sync tempPath, rename it over path, then sync the directory: after a
+// crash path holds either the old contents or all of the new ones. On
+// failure tempPath is removed and path is left as it was
+bool replaceFile(const std::string& tempPath, const std::string& path);
+
+#endif // FILESYNC_H
@@ -0,0 +1,201 @@
+// ============================================================================
+// FILE: FlatLRUCache.h
+// Description: Allocation-free LRU cache with the LRUCache interface. All
+//              entries live in a slot array sized up front, linked into the
+//              recency list by index, and found through an open-addressing
+//              table of slot numbers; after construction get/put/erase never
+//              call the allocator (beyond what copying K and V itself does)
+// ============================================================================
+
+#ifndef FLATLRUCACHE_H
+#define FLATLRUCACHE_H
+
+#include "common.h"
+#include <functional>
+
+template<typename K, typename V, typename Hash = std::hash<K>>
+class FlatLRUCache {
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Slot {
+        K key;
+        V value;
+        size_t hash;
+        uint64_t generation;
+        uint32_t prev;
+        uint32_t next;     // Also links the free list
+    };
+
+    size_t capacity;
+    size_t count;
+    uint64_t generation;      // Bumped by invalidate()
+    std::vector<Slot> slots;  // 'capacity' slots, never resized
+    std::vector<uint32_t> table;  // Linear probing, NIL = empty bucket
+    size_t mask;
+    uint32_t head;            // Most recent
+    uint32_t tail;            // Least recent
+    uint32_t freeHead;
+    Hash hasher;
+
+    void unlink(uint32_t s) {
+        Slot& slot = slots[s];
+        if (slot.prev != NIL) slots[slot.prev].next = slot.next;
+        else head = slot.next;
+        if (slot.next != NIL) slots[slot.next].prev = slot.prev;
+        else tail = slot.prev;
+    }
+
+    void pushFront(uint32_t s) {
+        slots[s].prev = NIL;
+        slots[s].next = head;
+        if (head != NIL) slots[head].prev = s;
+        head = s;
+        if (tail == NIL) tail = s;
+    }
+
+    // Bucket holding 'key', or the empty bucket where it would go
+    size_t findBucket(const K& key, size_t hash) const {
+        size_t i = hash & mask;
+        while (table[i] != NIL) {
+            const Slot& slot = slots[table[i]];
+            if (slot.hash == hash && slot.key == key) break;
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    // Remove a bucket, shifting later entries of the probe run back so
+    // lookups never need tombstones
+    void eraseBucket(size_t hole) {
+        size_t i = hole;
+        while (true) {
+            i = (i + 1) & mask;
+            if (table[i] == NIL) break;
+            size_t home = slots[table[i]].hash & mask;
+            if (((i - home) & mask) >= ((i - hole) & mask)) {
+                table[hole] = table[i];
+                hole = i;
+            }
+        }
+        table[hole] = NIL;
+    }
+
+    void eraseSlot(size_t bucket) {
+        uint32_t s = table[bucket];
+        eraseBucket(bucket);
+        unlink(s);
+        slots[s].value = V();  // Release what the value holds; the key keeps its buffer
+        slots[s].next = freeHead;
+        freeHead = s;
+        --count;
+    }
+
+public:
+    // Constructor (allocates everything the cache will ever use)
+    explicit FlatLRUCache(size_t cap)
+        : capacity(cap), count(0), generation(0), slots(cap), mask(0),
+          head(NIL), tail(NIL), freeHead(NIL) {
+        size_t buckets = 8;
+        while (buckets < cap * 2) buckets <<= 1;  // Load factor <= 0.5
+        table.assign(buckets, NIL);
+        mask = buckets - 1;
+        clear();
+    }
+
+    // Get value from cache, returns nullptr if not found. The pointer is
+    // valid until the next put/clear.
+    V* get(const K& key) {
+        size_t hash = hasher(key);
+        size_t bucket = findBucket(key, hash);
+        if (table[bucket] == NIL) return nullptr;  // Cache miss
+
+        uint32_t s = table[bucket];
+        if (slots[s].generation != generation) {
+            eraseSlot(bucket);  // Put before the last invalidate()
+            return nullptr;
+        }
+        if (head != s) {
+            unlink(s);
+            pushFront(s);
+        }
+        return &slots[s].value;
+    }
+
+    // Put key-value pair in cache, returns how many entries were evicted
+    // to make room (0 or 1)
+    size_t put(const K& key, const V& value) {
+        if (capacity == 0) return 0;
+
+        size_t hash = hasher(key);
+        size_t bucket = findBucket(key, hash);
+        if (table[bucket] != NIL) {
+            uint32_t s = table[bucket];
+            slots[s].value = value;
+            slots[s].generation = generation;
+            if (head != s) {
+                unlink(s);
+                pushFront(s);
+            }
+            return 0;
+        }
+
+        size_t evicted = 0;
+        if (count == capacity) {
+            eraseSlot(findBucket(slots[tail].key, slots[tail].hash));
+            bucket = findBucket(key, hash);  // The shift may have moved the hole
+            evicted = 1;
+        }
+
+        uint32_t s = freeHead;
+        freeHead = slots[s].next;
+        Slot& slot = slots[s];
+        slot.key = key;  // Assigning reuses the slot's existing buffers
+        slot.value = value;
+        slot.hash = hash;
+        slot.generation = generation;
+        pushFront(s);
+        table[bucket] = s;
+        ++count;
+        return evicted;
+    }
+
+    // Drop a single key
+    bool erase(const K& key) {
+        size_t bucket = findBucket(key, hasher(key));
+        if (table[bucket] == NIL) return false;
+        eraseSlot(bucket);
+        return true;
+    }
+
+    // Make every current entry invisible (they are reclaimed lazily)
+    void invalidate() {
+        ++generation;
+    }
+
+    // Clear cache
+    void clear() {
+        for (uint32_t s = head; s != NIL; s = slots[s].next) {
+            slots[s].value = V();
+        }
+        std::fill(table.begin(), table.end(), NIL);
+        for (size_t s = 0; s < slots.size(); ++s) {
+            slots[s].next = s + 1 < slots.size() ? static_cast<uint32_t>(s + 1) : NIL;
+        }
+        freeHead = slots.empty() ? NIL : 0;
+        head = tail = NIL;
+        count = 0;
+    }
+
+    // Get size (entries, including ones invalidated but not yet dropped)
+    size_t size() const {
+        return count;
+    }
+
+    // Capacity used, in entries
+    size_t weight() const {
+        return count;
+    }
+};
+
+#endif // FLATLRUCACHE_H
@@ -8,34 +8,90 @@
 
 #include "common.h"
 #include "User.h"
+#include "UserStore.h"
+#include "RoaringBitmap.h"
+#include "AccessSchedule.h"
+#include "AccessLog.h"
+#include "AuditLog.h"
+#include "Metrics.h"
 
 class Floor {
 private:
     std::string id;                          // Unique floor ID
     std::string name;                        // Unique floor name
-    ClearanceLevel requiredClearance;        // Required clearance level
-    std::vector<AccessAttempt> accessHistory; // Access log (runtime only)
+    AccessSchedule schedule;                 // Required clearance by minute of the week
+    RoaringBitmap allowList;                 // Users let in below the clearance (by handle)
+    RoaringBitmap denyList;                  // Users kept out whatever their clearance
+    AccessLog accessHistory;                 // Bounded access log (runtime only)
+    AuditLog* auditLog;                      // Durable audit trail (not owned, may be null)
+    Counter* grantedCount;                   // Registry series for this floor
+    Counter* deniedCount;
 
 public:
     // Constructor
     Floor(const std::string& floorId, const std::string& floorName,
-          ClearanceLevel clearance);
+          ClearanceLevel clearance, size_t historyLimit = ACCESS_HISTORY_LIMIT);
 
     // Getters
     std::string getId() const;
     std::string getName() const;
-    ClearanceLevel getRequiredClearance() const;
-    const std::vector<AccessAttempt>& getAccessHistory() const;
+    ClearanceLevel getRequiredClearance() const;  // Outside any scheduled window
+    ClearanceLevel getRequiredClearanceAt(int64_t epochSeconds) const;
+    const AccessSchedule& getSchedule() const;
+    const AccessLog& getAccessHistory() const;
+    const RoaringBitmap& getAllowList() const;
+    const RoaringBitmap& getDenyList() const;
 
     // Setters
     void setName(const std::string& newName);
     void setRequiredClearance(ClearanceLevel clearance);
 
-    // Access control - returns true if user is authorized
+    // Scheduled windows with their own required clearance (see AccessSchedule)
+    void addScheduleRule(const ScheduleRule& rule);
+    bool replaceScheduleRule(size_t index, const ScheduleRule& rule);
+    bool removeScheduleRule(size_t index);
+    void setHistoryLimit(size_t maxRecords);
+    void setAuditLog(AuditLog* log);
+
+    // Per-user exceptions, applied to whole sets of user handles at once.
+    // A user is on at most one list: allowing takes them off the deny list
+    // and denying takes them off the allow list
+    void allowUsers(const RoaringBitmap& users);
+    void denyUsers(const RoaringBitmap& users);
+    void clearExceptions(const RoaringBitmap& users);
+
+    // Follow the roster's handles through a compaction (old -> new)
+    void remapUsers(const std::vector<UserHandle>& remap);
+
+    // (clearance is enough at that time or user is allowed) and user is
+    // not denied. minimum is the requirement of one of the floor's doors
+    // or zones, or its building (see SiteModel); the allow list only lifts
+    // the floor's own level, so minimum applies to allowed users too
+    bool isAuthorized(UserHandle user, ClearanceLevel clearance, int64_t epochSeconds,
+                      ClearanceLevel minimum = ClearanceLevel::LEVEL_0) const;
+
+    // Access control - returns true if user is authorized. Without a
+    // handle only the clearance level is checked, and the history can't
+    // name the user
     bool attemptAccess(const User& user);
+    bool attemptAccess(const std::string& userId, const std::string& userName,
+                       ClearanceLevel clearance);
+    bool attemptAccess(UserHandle user, const std::string& userId, const std::string& userName,
+                       ClearanceLevel clearance);
+
+    // Access through a door on this floor: the door's minimum applies on
+    // top, and the audit record carries the door's ID
+    bool attemptAccess(UserHandle user, const std::string& userId, const std::string& userName,
+                       ClearanceLevel clearance, ClearanceLevel minimum,
+                       const std::string& doorId);
+
+    // The floor's scs_access_total series for one outcome, shared by every
+    // path that decides swipes there (see AccessEngine::decideBatch)
+    static Counter& accessCounter(const std::string& floorId, bool granted);
 
-    // Display access history
-    void displayAccessHistory() const;
+    // Display access history; lookup gives a handle's employee ID and
+    // current name (only looked up here, not on every swipe)
+    void displayAccessHistory(const UserLookup& lookup = nullptr) const;
 };
 
 #endif // FLOOR_H
\ No newline at end of file
@@ -0,0 +1,41 @@
+// ============================================================================
+// FILE: IdAllocator.h
+// Description: Employee ID allocator - per-prefix suffix counters backed by
+//              a set of taken IDs, so allocation is amortized O(1)
+// ============================================================================
+
+#ifndef IDALLOCATOR_H
+#define IDALLOCATOR_H
+
+#include "common.h"
+#include <unordered_map>
+#include <unordered_set>
+
+// IDs are PREFIX, PREFIX1, PREFIX2, ... and the lowest free one is handed out.
+// Not synchronized: callers serialize (SystemManager holds systemMutex).
+class IdAllocator {
+private:
+    std::unordered_set<std::string> taken;              // Every ID in use
+    std::unordered_map<std::string, int> nextSuffix;    // Prefix -> lowest suffix that may be free
+
+public:
+    // Forget all IDs
+    void clear();
+
+    // Pre-size for a known number of IDs (avoids rehashing on bulk load)
+    void reserveCapacity(size_t count);
+
+    // Mark an existing ID (e.g. loaded from file) as taken
+    void reserve(const std::string& id);
+
+    // Free an ID so it can be handed out again
+    void release(const std::string& id);
+
+    // Return the lowest free ID for the prefix and mark it taken
+    std::string allocate(const std::string& prefix);
+
+    bool contains(const std::string& id) const;
+    size_t size() const;
+};
+
+#endif // IDALLOCATOR_H
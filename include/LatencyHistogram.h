@@ -0,0 +1,57 @@
+// ============================================================================
+// FILE: LatencyHistogram.h
+// Description: HDR-style log-linear histogram of non-negative integer values
+//              (typically nanoseconds) - fixed memory, O(1) record, every
+//              value reported within 1/128 (< 0.8%) of what was recorded
+// ============================================================================
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include "common.h"
+
+class LatencyHistogram {
+public:
+    // Each power of two is split into this many linear sub-buckets
+    static const int SUB_BUCKET_BITS = 7;
+    static const size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+
+private:
+    std::vector<uint64_t> counts;
+    uint64_t total;
+    uint64_t minValue;
+    uint64_t maxValue;
+    long double sum;
+
+    static size_t bucketOf(uint64_t value);
+
+public:
+    // Constructor
+    LatencyHistogram();
+
+    // Add one value (or 'count' copies of it)
+    void record(uint64_t value, uint64_t count = 1);
+
+    // Add everything recorded in another histogram
+    void merge(const LatencyHistogram& other);
+
+    void clear();
+
+    uint64_t count() const;
+    uint64_t min() const;   // 0 if empty
+    uint64_t max() const;   // 0 if empty
+    double mean() const;
+
+    // Smallest recorded value v such that 'percentile' % of the values are
+    // <= v (up to bucket precision); 0 if empty
+    uint64_t valueAtPercentile(double percentile) const;
+
+    // Bucket iteration (for dumps): bucket count, and per bucket its value
+    // range [lowest, highest] and how many values fell in it
+    size_t bucketCount() const;
+    uint64_t bucketLowest(size_t bucket) const;
+    uint64_t bucketHighest(size_t bucket) const;
+    uint64_t bucketTotal(size_t bucket) const;
+};
+
+#endif // LATENCYHISTOGRAM_H
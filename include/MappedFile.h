@@ -0,0 +1,38 @@
+// ============================================================================
+// FILE: MappedFile.h
+// Description: Read-only memory-mapped file (falls back to reading the file
+//              into memory on platforms without mmap)
+// ============================================================================
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include "common.h"
+
+class MappedFile {
+private:
+    const char* bytes;   // Start of the mapping (nullptr when closed or empty)
+    size_t length;       // Size of the file in bytes
+#ifdef _WIN32
+    std::vector<char> buffer;  // Fallback: whole file read into memory
+#endif
+
+public:
+    // Constructor / destructor
+    MappedFile();
+    ~MappedFile();
+
+    // A mapping has a single owner
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file read-only, returns false if it can't be opened
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const;
+    const char* data() const;
+    size_t size() const;
+};
+
+#endif // MAPPEDFILE_H
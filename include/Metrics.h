@@ -0,0 +1,172 @@
+// ============================================================================
+// FILE: Metrics.h
+// Description: Process-wide metrics registry - sharded atomic counters,
+//              gauges and log2-bucketed latency histograms, exported in the
+//              Prometheus text format on demand or periodically to a file.
+//              Metrics are registered once (under a lock) and then recorded
+//              through a reference: a relaxed add on the calling thread's own
+//              cache line, so threads never contend.
+// ============================================================================
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "common.h"
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+
+const size_t METRICS_SHARDS = 16;  // Cache lines per counter/histogram
+
+// Shard of the calling thread, assigned round-robin on first use
+inline size_t metricsShard() {
+    static std::atomic<size_t> nextShard{0};
+    thread_local size_t shard = nextShard++ % METRICS_SHARDS;
+    return shard;
+}
+
+class Counter {
+private:
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> value{0};
+    };
+    Cell cells[METRICS_SHARDS];
+
+public:
+    void add(uint64_t n = 1) {
+        cells[metricsShard()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const;
+};
+
+// Last value set (e.g. a duration measured once)
+class Gauge {
+private:
+    std::atomic<uint64_t> bits{0};  // double
+
+public:
+    void set(double value);
+    double value() const;
+};
+
+// Bucket k counts nanosecond values with bit length k, i.e. [2^(k-1), 2^k)
+class Histogram {
+public:
+    static const size_t BUCKETS = 65;
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> buckets[BUCKETS];
+        std::atomic<uint64_t> sumNs{0};
+        Cell() {
+            for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+        }
+    };
+    Cell cells[METRICS_SHARDS];
+
+public:
+    void observeNs(uint64_t ns) {
+#if defined(__GNUC__)
+        size_t bucket = ns ? 64 - __builtin_clzll(ns) : 0;
+#else
+        size_t bucket = 0;
+        for (uint64_t v = ns; v; v >>= 1) ++bucket;
+#endif
+        Cell& cell = cells[metricsShard()];
+        cell.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        cell.sumNs.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    template<typename Duration>
+    void observe(Duration elapsed) {
+        observeNs(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    // Totals over all shards (one bucket, all values, sum of values)
+    uint64_t bucketCount(size_t bucket) const;
+    uint64_t count() const;
+    uint64_t sumNs() const;
+};
+
+// Observes the time from construction to destruction
+class ScopedTimer {
+private:
+    Histogram& histogram;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(Histogram& h) : histogram(h), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() { histogram.observe(std::chrono::steady_clock::now() - start); }
+};
+
+class MetricsRegistry {
+private:
+    enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Series {
+        std::string labels;  // Rendered: key="value",key2="value2"
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        Type type;
+        std::deque<Series> series;
+        std::unordered_map<std::string, Series*> seriesByLabels;
+    };
+
+    // Families and series in registration order (the export order), each
+    // also indexed so registering thousands of floors stays linear
+    mutable std::mutex registryMutex;
+    std::deque<Family> families;
+    std::unordered_map<std::string, Family*> familyByName;
+
+    // Periodic dump
+    std::thread dumpThread;
+    std::mutex dumpMutex;
+    std::condition_variable dumpCondition;
+    bool dumping = false;
+
+    Series& findOrAdd(const std::string& name, const std::string& help, Type type,
+                      const std::string& labels);
+
+public:
+    MetricsRegistry() = default;
+    ~MetricsRegistry();
+
+    // The registry every component records into
+    static MetricsRegistry& global();
+
+    // Register (or look up) a series; the reference stays valid for the
+    // registry's lifetime. 'labels' is in Prometheus form, e.g.
+    // floor="F1",result="granted"
+    Counter& counter(const std::string& name, const std::string& help,
+                     const std::string& labels = "");
+    Gauge& gauge(const std::string& name, const std::string& help,
+                 const std::string& labels = "");
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const std::string& labels = "");
+
+    // Prometheus text exposition format (histograms in seconds)
+    void writePrometheus(std::ostream& out) const;
+
+    // Write to 'path' (via a temp file) now, and every 'interval' until
+    // stopDumping(); returns false if the first write fails
+    bool writeFile(const std::string& path) const;
+    bool startDumping(const std::string& path, std::chrono::seconds interval);
+    void stopDumping();
+};
+
+// Hit/miss/eviction counters an LRUCache reports into (see Cache.h)
+struct CacheMetrics {
+    Counter* hits = nullptr;
+    Counter* misses = nullptr;
+    Counter* evictions = nullptr;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,188 @@
+// ============================================================================
+// FILE: RcuCell.h
+// Description: RCU-style holder of an immutable value. Readers pin the
+//              current version without taking a lock; writers copy, edit and
+//              publish a new version with an atomic pointer swap. Replaced
+//              versions are freed once no reader can still be using them
+//              (epoch-based deferred reclamation)
+// ============================================================================
+
+#ifndef RCUCELL_H
+#define RCUCELL_H
+
+#include "common.h"
+
+// Reader threads are numbered 0..RCU_READER_SLOTS-1 while they live, so every
+// RcuCell can give each thread its own slot without registration
+const size_t RCU_READER_SLOTS = 128;
+
+class RcuThreadSlot {
+private:
+    static std::atomic<bool>* slotsInUse() {
+        static std::atomic<bool> inUse[RCU_READER_SLOTS] = {};
+        return inUse;
+    }
+
+    size_t index;
+
+    RcuThreadSlot() {
+        // More live reader threads than slots: wait for one to exit
+        while (true) {
+            for (size_t i = 0; i < RCU_READER_SLOTS; ++i) {
+                bool expected = false;
+                if (slotsInUse()[i].compare_exchange_strong(expected, true)) {
+                    index = i;
+                    return;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    ~RcuThreadSlot() {
+        slotsInUse()[index].store(false);
+    }
+
+public:
+    // This thread's slot, claimed on first use and released at thread exit
+    static size_t current() {
+        thread_local RcuThreadSlot slot;
+        return slot.index;
+    }
+};
+
+template<typename T>
+class RcuCell {
+private:
+    // Epoch a reader announced when it pinned a version (0 = not reading)
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{0};
+        unsigned depth = 0;  // Nested guards, only touched by the owning thread
+    };
+
+    mutable ReaderSlot readers[RCU_READER_SLOTS];
+    std::atomic<const T*> value;
+    std::atomic<uint64_t> epoch;
+
+    std::mutex writerMutex;  // Serializes writers, guards retired
+    std::vector<std::pair<uint64_t, const T*>> retired;  // Replaced at epoch
+
+    // Free every retired version no active reader can still hold
+    void reclaimLocked() {
+        uint64_t oldestReader = UINT64_MAX;
+        for (const auto& reader : readers) {
+            uint64_t announced = reader.epoch.load();
+            if (announced != 0) oldestReader = std::min(oldestReader, announced);
+        }
+
+        // A version retired at epoch E is reachable only by readers that
+        // announced an epoch <= E
+        auto keep = std::remove_if(retired.begin(), retired.end(),
+            [oldestReader](const std::pair<uint64_t, const T*>& entry) {
+                if (entry.first < oldestReader) {
+                    delete entry.second;
+                    return true;
+                }
+                return false;
+            });
+        retired.erase(keep, retired.end());
+    }
+
+    void publishLocked(std::unique_ptr<T> next) {
+        const T* old = value.exchange(next.release());
+        uint64_t retiredAt = epoch.fetch_add(1);
+        if (old) retired.emplace_back(retiredAt, old);
+        reclaimLocked();
+    }
+
+public:
+    // Pins one version for as long as it lives; never blocks
+    class ReadGuard {
+    private:
+        const RcuCell* cell;
+        const T* pinned;
+
+    public:
+        explicit ReadGuard(const RcuCell& owner) : cell(&owner) {
+            ReaderSlot& slot = cell->readers[RcuThreadSlot::current()];
+            if (slot.depth++ == 0) {
+                slot.epoch.store(cell->epoch.load());
+            }
+            pinned = cell->value.load();
+        }
+
+        ~ReadGuard() {
+            if (!cell) return;
+            ReaderSlot& slot = cell->readers[RcuThreadSlot::current()];
+            if (--slot.depth == 0) {
+                slot.epoch.store(0);
+            }
+        }
+
+        ReadGuard(ReadGuard&& other) : cell(other.cell), pinned(other.pinned) {
+            other.cell = nullptr;
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+
+        // The pinned version (nullptr if nothing was published yet)
+        const T* get() const { return pinned; }
+        const T& operator*() const { return *pinned; }
+        const T* operator->() const { return pinned; }
+        explicit operator bool() const { return pinned != nullptr; }
+    };
+
+    RcuCell() : value(nullptr), epoch(1) {}
+
+    ~RcuCell() {
+        // No reader may outlive the cell
+        delete value.load();
+        for (auto& entry : retired) {
+            delete entry.second;
+        }
+    }
+
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    // Pin the current version
+    ReadGuard read() const {
+        return ReadGuard(*this);
+    }
+
+    // Make next the current version; the old one is freed once unpinned
+    void publish(std::unique_ptr<T> next) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        publishLocked(std::move(next));
+    }
+
+    // Copy the current version, apply edit to the copy and publish it
+    // (writers queue up, readers are never held). Does nothing if no
+    // version was published yet.
+    template<typename F>
+    bool update(F edit) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        const T* current = value.load();
+        if (!current) return false;
+        std::unique_ptr<T> next(new T(*current));
+        edit(*next);
+        publishLocked(std::move(next));
+        return true;
+    }
+
+    // Try again to free versions that were still pinned at their publish
+    void reclaim() {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        reclaimLocked();
+    }
+
+    // Replaced versions not freed yet
+    size_t pendingReclaim() {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        return retired.size();
+    }
+};
+
+#endif // RCUCELL_H
@@ -0,0 +1,124 @@
+// ============================================================================
+// FILE: RoaringBitmap.h
+// Description: Compressed set of 32-bit values (user handles) in the Roaring
+//              layout: values are grouped by their high 16 bits, and each
+//              group is a sorted array of low halves while it is small and a
+//              65536-bit bitmap once it is dense. Sparse and dense sets both
+//              stay compact, and set operations work a group at a time
+// ============================================================================
+
+#ifndef ROARINGBITMAP_H
+#define ROARINGBITMAP_H
+
+#include "common.h"
+
+class RoaringBitmap {
+private:
+    // Values sharing one high half. Array form while cardinality is at most
+    // ROARING_ARRAY_MAX, bitmap form above it; the form is always the one
+    // the cardinality calls for, so equal sets have equal containers
+    struct Container {
+        std::vector<uint16_t> array;  // Sorted low halves (array form)
+        std::vector<uint64_t> bits;   // BITMAP_WORDS words (bitmap form, else empty)
+        uint32_t cardinality = 0;
+
+        bool isBitmap() const { return !bits.empty(); }
+    };
+
+    static constexpr size_t BITMAP_WORDS = 65536 / 64;
+
+    std::vector<uint16_t> keys;         // Sorted high halves
+    std::vector<Container> containers;  // containers[i] holds keys[i]'s values
+
+    // Index of high's container, or keys.size() if there is none
+    size_t findContainer(uint16_t high) const;
+
+    // Container form changes
+    static void toBitmap(Container& c);
+    static void toArray(Container& c);
+    static void recount(Container& c);
+    static void fit(Container& c);
+
+    // Per-container set operations, result left in a
+    static void unionContainers(Container& a, const Container& b);
+    static void intersectContainers(Container& a, const Container& b);
+    static void subtractContainers(Container& a, const Container& b);
+
+    static bool containerContains(const Container& c, uint16_t low);
+
+public:
+    // Single values; add/remove return false if nothing changed
+    bool add(uint32_t value);
+    bool remove(uint32_t value);
+    bool contains(uint32_t value) const;
+
+    size_t cardinality() const;
+    bool empty() const;
+    void clear();
+
+    // In-place set operations: this = this | other, this & other, this - other
+    void unionWith(const RoaringBitmap& other);
+    void intersectWith(const RoaringBitmap& other);
+    void subtract(const RoaringBitmap& other);
+
+    // Replace every value v with table[v]; values past the table or mapped
+    // to UINT32_MAX drop out (for renumbered handles)
+    void remap(const std::vector<uint32_t>& table);
+
+    bool operator==(const RoaringBitmap& other) const;
+    bool operator!=(const RoaringBitmap& other) const { return !(*this == other); }
+
+    // Heap and object bytes held by the set
+    size_t memoryBytes() const;
+
+    // Call fn(value) for the values also in other, in increasing order,
+    // until fn returns false. Groups are intersected one at a time, so an
+    // early stop never pays for the rest
+    template <typename F>
+    void forEachCommon(const RoaringBitmap& other, F fn) const {
+        Container common;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            size_t j = other.findContainer(keys[i]);
+            if (j == other.keys.size()) continue;
+            common = containers[i];
+            intersectContainers(common, other.containers[j]);
+
+            const uint32_t base = static_cast<uint32_t>(keys[i]) << 16;
+            if (!common.isBitmap()) {
+                for (uint16_t low : common.array) {
+                    if (!fn(base | low)) return;
+                }
+                continue;
+            }
+            for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+                uint64_t word = common.bits[w];
+                while (word) {
+                    if (!fn(base | static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)))) return;
+                    word &= word - 1;
+                }
+            }
+        }
+    }
+
+    // Call fn(value) for every value in increasing order
+    template <typename F>
+    void forEach(F fn) const {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            const uint32_t base = static_cast<uint32_t>(keys[i]) << 16;
+            const Container& c = containers[i];
+            if (!c.isBitmap()) {
+                for (uint16_t low : c.array) fn(base | low);
+                continue;
+            }
+            for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+                uint64_t word = c.bits[w];
+                while (word) {
+                    fn(base | static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+    }
+};
+
+#endif // ROARINGBITMAP_H
@@ -0,0 +1,147 @@
+// ============================================================================
+// FILE: SiteModel.h
+// Description: The campus as a tree: buildings hold floors, floors hold
+//              zones (which may nest) and doors. Every node has a stable
+//              SiteId and is hash-indexed by ID and name. Clearance policies
+//              on buildings, zones and doors are flattened into one minimum
+//              per node, so a decision at a door is a few array reads
+//              however large the site is
+// ============================================================================
+
+#ifndef SITEMODEL_H
+#define SITEMODEL_H
+
+#include "common.h"
+#include "Floor.h"
+#include <deque>
+#include <unordered_map>
+
+// Index of a node; never reused, so it stays valid as the site changes
+typedef uint32_t SiteId;
+const SiteId NO_SITE = UINT32_MAX;
+
+enum class SiteKind : uint8_t { BUILDING, FLOOR, ZONE, DOOR };
+
+class SiteModel {
+private:
+    struct Node {
+        SiteKind kind;
+        bool live;
+        int8_t policy;                 // Own minimum clearance (0-3), -1 = none
+        SiteId parent;                 // NO_SITE for buildings
+        SiteId floor;                  // Enclosing floor (itself for floors)
+        uint32_t floorSlot;            // Floors: index into floorStore
+        std::string id;
+        std::string name;
+        std::vector<SiteId> children;
+    };
+
+    std::vector<Node> nodes;        // Indexed by SiteId; removed nodes stay as tombstones
+    std::vector<uint8_t> minimum;   // Highest policy from the building down to each node
+    std::deque<Floor> floorStore;   // Floor state; a deque never moves what it holds
+    std::vector<SiteId> floorOrder; // Floors by menu number
+    std::unordered_map<std::string, SiteId> byId;
+    std::unordered_multimap<std::string, SiteId> byName;
+    size_t doors;
+
+    SiteId addNode(SiteKind kind, SiteId parent, const std::string& id, const std::string& name);
+
+    // Recompute minimum[] for a node and everything below it
+    void flatten(SiteId root);
+
+public:
+    SiteModel();
+
+    // Build the site; parents must exist, IDs must be unique and at most
+    // SITE_ID_MAX characters (readers and audit records carry them).
+    // Zones and doors go under a floor or a zone. NO_SITE on failure
+    SiteId addBuilding(const std::string& id, const std::string& name);
+    SiteId addFloor(SiteId building, const std::string& id, const std::string& name,
+                    ClearanceLevel clearance, size_t historyLimit = ACCESS_HISTORY_LIMIT);
+    SiteId addZone(SiteId parent, const std::string& id, const std::string& name);
+    SiteId addDoor(SiteId parent, const std::string& id, const std::string& name);
+
+    // Remove a zone or door and everything under it (floors stay)
+    bool remove(SiteId node);
+
+    // Minimum clearance for a building, zone or door and all it contains;
+    // a floor's own level is its Floor's required clearance and schedule
+    bool setPolicy(SiteId node, ClearanceLevel level);
+    bool clearPolicy(SiteId node);
+    bool hasPolicy(SiteId node) const;
+    ClearanceLevel getPolicy(SiteId node) const;
+
+    // Lookups, NO_SITE on a miss
+    SiteId findById(const std::string& id) const;
+    SiteId findByName(const std::string& name, SiteKind kind) const;
+    SiteId floorAt(size_t number) const;  // 1-based, in the order floors were added
+
+    bool contains(SiteId node) const;
+    SiteKind getKind(SiteId node) const;
+    const std::string& getId(SiteId node) const;
+    const std::string& getName(SiteId node) const;
+    SiteId getParent(SiteId node) const;
+    const std::vector<SiteId>& getChildren(SiteId node) const;
+    bool rename(SiteId node, const std::string& newName);
+
+    size_t floorCount() const;
+    size_t doorCount() const;
+    size_t nodeLimit() const;  // One past the highest SiteId handed out
+
+    // The floor a node is on (zones, doors and floors)
+    Floor& getFloor(SiteId node);
+    const Floor& getFloor(SiteId node) const;
+    SiteId getFloorOf(SiteId node) const;
+
+    // Policies above and at the node, without the floor's own level
+    ClearanceLevel getMinimum(SiteId node) const;
+
+    // What a swipe needs at a time: the higher of the minimum and the
+    // floor's scheduled level
+    ClearanceLevel getRequiredClearanceAt(SiteId node, int64_t epochSeconds) const;
+
+    // The floor's rules (allow/deny lists included) with the node's minimum
+    // on top; attemptAccess also logs the attempt under the node's ID
+    bool isAuthorized(SiteId node, UserHandle user, ClearanceLevel clearance,
+                      int64_t epochSeconds) const;
+    bool attemptAccess(SiteId node, UserHandle user, const std::string& userId,
+                       const std::string& userName, ClearanceLevel clearance);
+
+    // Load "kind,id,name,parent,clearance" rows (kind = building, floor,
+    // zone or door; clearance may be empty except for floors), adding to
+    // the site. Bad rows are reported and skipped; false if unreadable
+    bool loadCSV(const std::string& path);
+
+    // The built-in site: one building with floors F1-F4
+    static SiteModel defaultSite();
+
+    template<typename F>
+    void forEachFloor(F fn) {
+        for (SiteId floor : floorOrder) fn(floorStore[nodes[floor].floorSlot]);
+    }
+
+    template<typename F>
+    void forEachFloor(F fn) const {
+        for (SiteId floor : floorOrder) fn(floorStore[nodes[floor].floorSlot]);
+    }
+
+    // Call fn(door) for every door under root (NO_SITE: the whole site)
+    template<typename F>
+    void forEachDoor(SiteId root, F fn) const {
+        if (root == NO_SITE) {
+            for (SiteId node = 0; node < nodes.size(); ++node) {
+                if (nodes[node].live && nodes[node].kind == SiteKind::DOOR) fn(node);
+            }
+            return;
+        }
+        std::vector<SiteId> stack(1, root);
+        while (!stack.empty()) {
+            SiteId node = stack.back();
+            stack.pop_back();
+            if (nodes[node].kind == SiteKind::DOOR) fn(node);
+            stack.insert(stack.end(), nodes[node].children.begin(), nodes[node].children.end());
+        }
+    }
+};
+
+#endif // SITEMODEL_H
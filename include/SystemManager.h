@@ -5,20 +5,58 @@
 #include "User.h"
 #include "Admin.h"
 #include "Floor.h"
+#include "SiteModel.h"
 #include "Cache.h"
+#include "UserStore.h"
+#include "CardIndex.h"
+#include "UserSearch.h"
 #include "DataManager.h"
+#include "AuditLog.h"
+#include "AccessEngine.h"
+#include "RcuCell.h"
+#include "Metrics.h"
+#include <condition_variable>
 
 class SystemManager {
 private:
-    std::vector<std::shared_ptr<User>> users;
+    UserStore users;  // Roster records with ID/name indexes, addressed by handle
+    CardIndex cardIndex;  // Card ID -> holder (the admin's card -> ADMIN_USER)
+    UserSearch userSearch;  // Prefix/typo-tolerant search over IDs, names and emails
+    bool userSearchBuilt;  // userSearch is built on first use, then kept in step
     std::shared_ptr<Admin> admin;
-    std::vector<Floor> floors;
-    LRUCache<std::string, std::shared_ptr<User>> userCache;
+    AuditLog auditLog;  // Outlives floors, which append to it
+    SiteModel site;  // Buildings, floors, zones and doors
+    RcuCell<AccessEngine> accessTables;  // Lock-free read path for the server (empty until serve)
+    RcuCell<UserStore> userTables;  // Copy of the roster for lock-free findUser
+    // Search term -> user (NO_USER = known miss); W-TinyLFU, sized in bytes,
+    // invalidated whenever a mutation could change a lookup's answer
+    ShardedLRUCache<std::string, UserHandle, 8, TinyLfuPolicy,
+                    ByteWeigher<std::string, UserHandle>> userCache;
     DataManager dataManager;
     std::mutex systemMutex;
     std::atomic<bool> running;
     std::thread saveThread;
 
+    // Flush worker hand-off: each request takes a ticket, the worker marks
+    // tickets done; requests made during a flush coalesce into the next one
+    std::mutex saveMutex;
+    std::condition_variable saveCondition;
+    uint64_t saveRequested;
+    uint64_t saveCompleted;
+
+    uint64_t rosterCompactions;  // Bumped whenever compactRoster renumbers handles
+
+    // Series in MetricsRegistry::global(), registered by the constructor
+    CacheMetrics userCacheMetrics;
+    Counter* userLoginSuccesses;
+    Counter* userLoginFailures;
+    Counter* adminLoginSuccesses;
+    Counter* adminLoginFailures;
+    Histogram* findUserLatency;
+    Histogram* userSearchLatency;
+    Histogram* saveLatency;
+    Gauge* loadSeconds;
+
 public:
     // Constructor
     SystemManager();
@@ -32,14 +70,25 @@ public:
     // Start the system
     void run();
 
+    // Server mode: answer badge readers on a Unix socket until stopped,
+    // optionally with the interactive menu running alongside
+    bool serve(const std::string& socketPath, size_t workers, bool withMenu);
+
+    // Build the first access-table version from the roster and floors
+    void publishAccessTables();
+
+    // Publish a copy of the roster for findUser; called with systemMutex
+    // held after any change to who is in it or what they are called
+    void publishUsers();
+
     // User operations
     void userMode();
     void userLogin();
-    void userMenu(std::shared_ptr<User> user);
-    void listFloorsForUser(std::shared_ptr<User> user);
-    void accessFloor(std::shared_ptr<User> user);
-    void showUserInfo(std::shared_ptr<User> user);
-    void changeUserInfo(std::shared_ptr<User> user);
+    void userMenu(UserHandle user);
+    void listFloorsForUser(UserHandle user);
+    void accessFloor(UserHandle user);
+    void showUserInfo(UserHandle user);
+    void changeUserInfo(UserHandle user);
 
     // Admin operations
     void adminMode();
@@ -47,19 +96,85 @@ public:
     void adminMenu();
     void listFloorsForAdmin();
     void manageFloor();
+    void manageFloorExceptions(Floor& floor);
+    void showFloorExceptions(const Floor& floor);
+    void manageFloorSchedule(Floor& floor);
+    void manageFloorSite(SiteId floorNode);
+    void showFloorSite(SiteId floorNode);
     void listUsers();
+    void searchUsers();
     void manageUser();
+    void manageUser(UserHandle user);
     void createUser();
     void deleteUser();
+    void showMetrics();
+
+    // Helper functions (lookups return NO_USER on a miss)
+    UserHandle findUser(const std::string& searchTerm);
+    UserHandle findUserById(const std::string& userId);
+
+    // Up to 'limit' users matching a partial or misspelled ID, name or
+    // email, best first
+    std::vector<SearchHit> findUsers(const std::string& query, size_t limit);
+    bool renameUser(UserHandle user, const std::string& newName);
+    bool setUserEmail(UserHandle user, const std::string& newEmail);
+    bool setUserPhone(UserHandle user, const std::string& newPhone);
+
+    // Floor by name, ID or menu number; NO_SITE on a miss
+    SiteId findFloor(const std::string& searchTerm);
+
+    // The campus; floors stay where they are as the site grows
+    SiteModel& getSite();
+
+    // Push the doors under a site node to the server's access tables
+    void publishDoors(SiteId root);
 
-    // Helper functions
-    std::shared_ptr<User> findUser(const std::string& searchTerm);
-    Floor* findFloor(const std::string& searchTerm);
+    // Users named by a comma-separated list of IDs, names or card IDs, or
+    // everyone at one clearance level ("level:N"); false if none matched
+    bool collectUsers(const std::string& spec, RoaringBitmap& group);
 
-    // Save system (thread-safe)
+    // Push a floor's allow/deny lists to the server's access tables
+    void publishFloorExceptions(const Floor& floor);
+
+    // Write every floor's allow/deny lists to EXCEPTIONS_FILE, and read
+    // them back onto the floors at startup (entries for unknown floors or
+    // users are dropped)
+    void saveFloorExceptions();
+    void loadFloorExceptions();
+
+    // Prompt for a schedule window's days, times and level; false on bad input
+    bool readScheduleRule(ScheduleRule& rule);
+
+    // Rebuild and freeze the card index from the loaded roster and admin
+    void rebuildCardIndex();
+
+    // Read-only view of the roster; a handle's fields are read through it
+    const UserStore& getUsers() const;
+
+    // Take a user out of the roster and indexes
+    void removeUser(UserHandle user);
+
+    // Compact the roster once removed users and old values pile up, and
+    // remap every handle kept elsewhere. Only the menu thread calls this,
+    // between sessions, when it holds no handle itself
+    void compactRoster();
+
+    // Apply the change journal on top of the loaded roster
+    void replayJournal();
+
+    // Save system (thread-safe, waits until the changes are on disk)
     void saveSystem();
 
-    // Background thread for save command
+    // Queue a flush for the background worker, optionally waiting for it
+    void requestSave(bool wait);
+
+    // Journal everything changed since the last flush (compacting when due)
+    void flushChanges();
+
+    // Copy of the full roster for a CSV rewrite outside the lock
+    void copyRoster(UserStore& rosterCopy, std::shared_ptr<Admin>& adminCopy);
+
+    // Background flush worker
     void saveThreadFunction();
 
     // Check for "scs -save" command
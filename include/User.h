@@ -16,21 +16,22 @@ protected:
     std::string email;        // Email address
     std::string phone;        // Phone number
     std::shared_ptr<Card> card;  // Associated access card (not null)
+    bool dirty;               // Changed since it was last saved
 
 public:
-    // Constructor
-    User(const std::string& userId, const std::string& userName,
-         const std::string& userEmail, const std::string& userPhone,
+    // Constructor (fields are taken by value and moved in)
+    User(std::string userId, std::string userName,
+         std::string userEmail, std::string userPhone,
          std::shared_ptr<Card> userCard);
 
     // Virtual destructor for inheritance
     virtual ~User() = default;
 
-    // Getters
-    std::string getId() const;
-    std::string getName() const;
-    std::string getEmail() const;
-    std::string getPhone() const;
+    // Getters (return references, no per-call string copies)
+    const std::string& getId() const;
+    const std::string& getName() const;
+    const std::string& getEmail() const;
+    const std::string& getPhone() const;
     std::shared_ptr<Card> getCard() const;
 
     // Setters (only name, email, phone can be changed by user)
@@ -38,6 +39,11 @@ public:
     void setEmail(const std::string& newEmail);
     void setPhone(const std::string& newPhone);
 
+    // Dirty tracking for incremental saves (setters mark the user dirty)
+    bool isDirty() const;
+    void markDirty();
+    void clearDirty();
+
     // Display user information
     void displayInfo() const;
 
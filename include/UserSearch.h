@@ -0,0 +1,160 @@
+// ============================================================================
+// FILE: UserSearch.h
+// Description: Search-as-you-type over the roster. IDs, name words and
+//              emails sit in a radix trie for prefix queries; name words
+//              and emails also get trigram postings, so a word with a typo
+//              or two still finds its user. Matches come back ranked, cut
+//              to the best k, without scoring every user a prefix matches
+// ============================================================================
+
+#ifndef USERSEARCH_H
+#define USERSEARCH_H
+
+#include "common.h"
+#include "UserStore.h"
+#include "RoaringBitmap.h"
+#include <string_view>
+#include <unordered_map>
+
+struct SearchHit {
+    UserHandle user;
+    uint32_t score;  // Lower is better (see UserSearch::score)
+};
+
+class UserSearch {
+private:
+    // Radix-trie node: the edge into it is labels[labelStart, +labelLength)
+    // and the path from the root spells a term of depth characters. A term
+    // some user holds has count > 0. Nodes are never freed, so a removed
+    // term just stays empty until the next rebuild.
+    struct Node {
+        uint32_t labelStart;
+        uint32_t firstChild;   // NO_NODE if none
+        uint32_t nextSibling;  // Siblings sorted by their label's first byte
+        uint32_t postings;     // (term, user) pairs at and below this node
+        uint32_t count;        // Users holding this term
+        uint32_t users;        // The user (count <= 1) or an index into holders
+        uint32_t hub;          // Index into hubs, NO_NODE if none
+        uint16_t labelLength;
+        uint16_t depth;
+        char first;            // labels[labelStart], kept here for sibling scans
+        bool listed;           // users indexes holders
+    };
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    struct FuzzyTerm {
+        std::string text;
+        uint32_t node;
+    };
+
+    std::vector<Node> nodes;              // nodes[0] is the root
+    std::string labels;                   // Edge labels, append-only
+    std::vector<RoaringBitmap> holders;   // Users of terms held by 2+ users
+    // Everyone at or below a node that reached SEARCH_HUB_POSTINGS, so a
+    // short prefix's users are one bitmap rather than a walk of the subtree
+    std::vector<RoaringBitmap> hubs;
+    std::vector<FuzzyTerm> fuzzyTerms;    // Name words and emails
+    std::unordered_map<uint32_t, uint32_t> fuzzyByNode;             // Node -> fuzzyTerms index
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams;   // Trigram -> fuzzyTerms indexes
+
+    // A user's terms: the ID (prefix only), then name words and the email,
+    // lowercased into terms[0, returned count) (reusing its strings)
+    struct Term {
+        std::string text;
+        bool fuzzy;
+    };
+    static size_t userTerms(const UserStore& users, UserHandle user, std::vector<Term>& terms);
+
+    uint32_t newNode(uint32_t labelStart, size_t labelLength, size_t depth);
+    uint32_t childStartingWith(uint32_t node, char first) const;
+    void linkChild(uint32_t parent, uint32_t child);
+
+    // The node whose subtree holds every term starting with text
+    uint32_t findPrefix(std::string_view text) const;
+
+    // The node spelling text exactly (path = root .. node), NO_NODE if none
+    uint32_t findTerm(std::string_view text, std::vector<uint32_t>& path) const;
+
+    // Find or create the node spelling text, splitting an edge if needed
+    uint32_t insertTerm(std::string_view text, std::vector<uint32_t>& path);
+
+    // Give a name word or email trigram postings (once); its fuzzyTerms index
+    uint32_t markFuzzy(uint32_t node, const std::string& text);
+
+    // Add/remove one user in a term's postings; false if nothing changed
+    bool insertUser(uint32_t node, UserHandle user);
+    bool eraseUser(uint32_t node, UserHandle user);
+
+    // Users holding a term, ascending; fn returns false to stop
+    template <typename F>
+    void forEachUser(uint32_t node, F fn) const {
+        const Node& n = nodes[node];
+        if (!n.listed) {
+            if (n.count) fn(n.users);
+            return;
+        }
+        bool going = true;
+        holders[n.users].forEach([&](uint32_t user) {
+            if (going) going = fn(user);
+        });
+    }
+
+    // Everyone holding a term at or below node
+    void gatherSubtree(uint32_t node, RoaringBitmap& out) const;
+
+    // Recount postings and build hubs bottom-up (after a bulk load)
+    void countPostings();
+
+    // Fuzzy terms within maxEdits of word: (distance, node), nearest first
+    typedef std::vector<std::pair<uint32_t, uint32_t>> FuzzyMatches;
+    FuzzyMatches fuzzyMatches(const std::string& word, uint32_t maxEdits) const;
+
+    // Cheapest cost any term has for a word of this length, given its
+    // prefix node (or NO_NODE) and fuzzy matches; UINT32_MAX if none match
+    uint32_t minimumCost(uint32_t prefix, size_t wordLength, const FuzzyMatches& fuzzy) const;
+
+    // Cost of matching one query word against one term, UINT32_MAX if it
+    // doesn't (packed like score)
+    static uint32_t wordCost(const std::string& word, const std::string& term, bool fuzzy);
+
+public:
+    UserSearch();
+
+    // Index every live user, replacing what was there
+    void rebuild(const UserStore& users);
+
+    // Keep the index in step with the roster: add new users, remove users
+    // before they leave the store, and bracket a change to an ID, name or
+    // email with remove (old values) and add (new values)
+    void add(const UserStore& users, UserHandle user);
+    void remove(const UserStore& users, UserHandle user);
+
+    // Follow the roster's handles through a compaction (old -> new, which
+    // keeps their order, so postings stay sorted)
+    void remapUsers(const std::vector<UserHandle>& remap);
+
+    // Up to k best matches for a query of one or more words, best first
+    // (ties by handle). Every word must match one of the user's terms:
+    // exactly, as a prefix, or - name words and emails, for words of 4+
+    // characters - within 1 typo (2 from 8 characters)
+    std::vector<SearchHit> search(const UserStore& users, std::string_view query, size_t k) const;
+
+    // Lowercased words of a query
+    static std::vector<std::string> queryWords(std::string_view query);
+
+    // A user's score for the words, false if some word doesn't match.
+    // Packed so that fewer typos rank first, then fewer words that were
+    // only prefixes, then fewer characters those prefixes left out
+    static bool score(const UserStore& users, UserHandle user,
+                      const std::vector<std::string>& words, uint32_t& result);
+
+    // Levenshtein distance if it is at most maxEdits, else maxEdits + 1
+    static uint32_t boundedDistance(const std::string& a, const std::string& b, uint32_t maxEdits);
+
+    size_t termCount() const;
+    size_t nodeCount() const;
+    size_t memoryBytes() const;
+    void clear();
+};
+
+#endif // USERSEARCH_H
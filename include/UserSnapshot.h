@@ -0,0 +1,98 @@
+// ============================================================================
+// FILE: UserSnapshot.h
+// Description: Versioned, columnar binary snapshot of the roster. Mapped
+//              read-only at startup and bulk-loaded into the UserStore;
+//              User objects can still be built per row
+// ============================================================================
+
+#ifndef USERSNAPSHOT_H
+#define USERSNAPSHOT_H
+
+#include "common.h"
+#include "User.h"
+#include "Admin.h"
+#include "UserStore.h"
+#include "MappedFile.h"
+#include <string_view>
+
+// On-disk layout (host byte order), every section 8-byte aligned:
+//   SnapshotHeader
+//   uint8_t  clearance[rows]
+//   uint64_t offsets[rows + 1]      one array per string column, into the heap
+//   char     heap[heapSize]         strings of each column stored back to back
+//   uint32_t idIndex[indexSlots]    open-addressing, value = row + 1 (0 = empty)
+//   uint32_t nameIndex[indexSlots]  same, equal names kept in row order
+// Rows are the users in roster order, then the admin (if any) as the last row.
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;             // SNAPSHOT_HAS_ADMIN
+    uint64_t userCount;         // User rows, excluding the admin
+    uint64_t fileSize;
+    uint64_t csvSize;           // The users.csv this snapshot mirrors
+    int64_t csvMtime;
+    uint64_t indexSlots;        // Power of two
+    uint64_t clearanceOffset;
+    uint64_t stringOffsets[6];  // Indexed by SnapshotColumn
+    uint64_t heapOffset;
+    uint64_t heapSize;
+    uint64_t idIndexOffset;
+    uint64_t nameIndexOffset;
+};
+
+enum SnapshotColumn {
+    COL_ID = 0,
+    COL_NAME,
+    COL_EMAIL,
+    COL_PHONE,
+    COL_CARD_ID,
+    COL_PASSWORD,  // Only set for the admin row
+    SNAPSHOT_COLUMNS
+};
+
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t SNAPSHOT_HAS_ADMIN = 1;
+
+class UserSnapshot {
+private:
+    MappedFile file;
+    const SnapshotHeader* header;
+    const uint8_t* clearance;
+    const uint64_t* offsets[SNAPSHOT_COLUMNS];
+    const char* heap;
+    const uint32_t* idIndex;
+    const uint32_t* nameIndex;
+
+public:
+    UserSnapshot();
+
+    // Map and validate a snapshot file, returns false if missing or malformed
+    bool open(const std::string& path);
+
+    // Write users + admin as a snapshot of the given CSV state (temp file + rename)
+    static bool write(const std::string& path, const UserStore& users,
+                      const std::shared_ptr<Admin>& admin,
+                      uint64_t csvSize, int64_t csvMtime);
+
+    // True if this snapshot was built from a CSV of that size and mtime
+    bool matchesCsv(uint64_t csvSize, int64_t csvMtime) const;
+
+    // Column access, no parsing or copying
+    size_t userCount() const;
+    bool hasAdmin() const;  // Admin is row userCount()
+    std::string_view field(size_t row, SnapshotColumn column) const;
+    int clearanceLevel(size_t row) const;
+
+    // Index lookups: row of the user with that ID (-1 if none), rows with that name
+    long findById(std::string_view id) const;
+    std::vector<size_t> findByName(std::string_view name) const;
+
+    // Build objects for a row
+    std::shared_ptr<User> materialize(size_t row) const;
+    std::shared_ptr<Admin> materializeAdmin() const;
+
+    // Copy every user row into a store in row order (loaded rows are clean)
+    void loadInto(UserStore& store) const;
+};
+
+#endif // USERSNAPSHOT_H
@@ -0,0 +1,185 @@
+// ============================================================================
+// FILE: UserStore.h
+// Description: Arena-backed roster - one fixed-size record per user in a
+//              contiguous array, addressed by 32-bit handles. Strings live
+//              in a chunked pool (names interned) and the card is embedded
+//              in its owner's record
+// ============================================================================
+
+#ifndef USERSTORE_H
+#define USERSTORE_H
+
+#include "common.h"
+#include "User.h"
+#include <string_view>
+
+// Index of a record in a UserStore. Handles are never reused: one keeps
+// naming the same user until that user is removed, then matches nobody.
+// Only compact() renumbers them (keeping their order), and its caller
+// remaps every handle it holds
+typedef uint32_t UserHandle;
+const UserHandle NO_USER = UINT32_MAX;
+
+// Append-only character arena. A string is addressed by a packed reference
+// (chunk, offset, length) rather than a pointer, so a copied pool is valid
+// as it stands. Chunks never grow past their reserved capacity, so views
+// stay put while more strings are appended.
+class StringPool {
+public:
+    typedef uint64_t Ref;
+    static constexpr size_t MAX_LENGTH = 0xFFFF;  // Longest string a Ref can address
+
+    Ref append(std::string_view text);
+    std::string_view view(Ref ref) const;
+
+    size_t memoryBytes() const;
+    void clear();
+
+private:
+    std::vector<std::vector<char>> chunks;
+};
+
+class UserStore {
+    friend class UserSnapshot;  // Bulk load adopts the snapshot's on-disk indexes
+
+private:
+    struct Record {
+        StringPool::Ref id;
+        StringPool::Ref name;     // Interned: equal names share one Ref
+        StringPool::Ref email;
+        StringPool::Ref phone;
+        StringPool::Ref cardId;   // Card embedded in the record
+        uint8_t clearance;
+        uint8_t flags;            // RECORD_LIVE | RECORD_DIRTY (a removed record
+                                  // stays dirty until its removal is drained)
+    };
+    static constexpr uint8_t RECORD_LIVE = 1;
+    static constexpr uint8_t RECORD_DIRTY = 2;
+
+    std::vector<Record> records;  // Indexed by handle; removed users stay as tombstones
+    size_t liveCount;
+    std::vector<UserHandle> changed;  // Dirty handles, in the order they became dirty
+    size_t garbageBytes;  // Pool bytes and records only removed users or old values hold
+    StringPool pool;
+
+    // Open-addressing tables over FNV-1a of the text, linear probing, sizes
+    // are powers of two - the same layout as the snapshot's indexes. Index
+    // slots hold handle + 1 (0 = empty); intern slots hold a Ref.
+    std::vector<StringPool::Ref> internTable;
+    size_t internCount;
+    std::vector<uint32_t> idIndex;    // First user with an ID wins
+    std::vector<uint32_t> nameIndex;  // Equal names in insertion order, compared by Ref
+
+    StringPool::Ref intern(std::string_view text);
+    StringPool::Ref findInterned(std::string_view text, uint64_t hash) const;
+    void growInternTable(size_t entries);
+    void touch(UserHandle handle);  // Mark dirty, queueing the handle if it was clean
+
+    void indexId(UserHandle handle);
+    void indexName(UserHandle handle);
+    void unindexId(UserHandle handle);
+    void unindexName(UserHandle handle);
+    void growIndexes(size_t users);
+
+public:
+    UserStore();
+
+    // Add a user; loaded rows pass dirty = false, new users keep it true.
+    // NO_USER (and nothing stored) if a field is longer than MAX_LENGTH
+    UserHandle add(std::string_view id, std::string_view name, std::string_view email,
+                   std::string_view phone, std::string_view cardId, ClearanceLevel level,
+                   bool dirty = true);
+
+    // Start fetching the index slots add() will probe for these fields;
+    // bulk loads call it a few rows ahead of the row they add
+    void prefetch(std::string_view id, std::string_view name) const;
+
+    // Take a user out of the store and indexes; false if already gone
+    bool remove(UserHandle handle);
+
+    // True while the handle names a user in the store
+    bool contains(UserHandle handle) const;
+
+    // Fields (views into the pool, valid until the store is cleared)
+    std::string_view getId(UserHandle handle) const;
+    std::string_view getName(UserHandle handle) const;
+    std::string_view getEmail(UserHandle handle) const;
+    std::string_view getPhone(UserHandle handle) const;
+    std::string_view getCardId(UserHandle handle) const;
+    ClearanceLevel getClearanceLevel(UserHandle handle) const;
+
+    // Setters mark the user dirty. Replaced strings stay in the pool until
+    // the store is compacted or next loaded. The string setters leave the
+    // user as it was and return false if the new value is too long.
+    bool setName(UserHandle handle, std::string_view newName);
+    bool setEmail(UserHandle handle, std::string_view newEmail);
+    bool setPhone(UserHandle handle, std::string_view newPhone);
+    void setClearanceLevel(UserHandle handle, ClearanceLevel level);
+    bool setCardId(UserHandle handle, std::string_view newCardId);
+
+    // True if the store can hold this as a field
+    static bool fits(std::string_view field) { return field.size() <= StringPool::MAX_LENGTH; }
+
+    // Dirty tracking for incremental saves
+    bool isDirty(UserHandle handle) const;
+    void markDirty(UserHandle handle);
+    void clearDirty(UserHandle handle);
+
+    // Users added, changed or removed since the last drain, each once and in
+    // the order they were first touched, as fn(handle, live); a removed
+    // user's fields stay readable. Clears their dirty marks. Handles only
+    // grow and a removed ID can only come back on a later handle, so this
+    // order journals "remove X, add X again" the right way round.
+    template <typename Fn>
+    void drainChanges(Fn fn) {
+        for (UserHandle handle : changed) {
+            Record& record = records[handle];
+            if (!(record.flags & RECORD_DIRTY)) continue;  // Cleared, or listed twice
+            record.flags &= ~RECORD_DIRTY;
+            fn(handle, (record.flags & RECORD_LIVE) != 0);
+        }
+        changed.clear();
+    }
+
+    // Exact lookups, NO_USER on a miss
+    UserHandle findById(std::string_view id) const;
+    UserHandle findByName(std::string_view name) const;
+
+    // Live users in handle (= roster) order
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (UserHandle handle = 0; handle < records.size(); ++handle) {
+            if (records[handle].flags & RECORD_LIVE) fn(handle);
+        }
+    }
+
+    // Live users, and one past the highest handle handed out
+    size_t size() const;
+    size_t handleLimit() const;
+
+    // Room for this many users without regrowing records or indexes (the
+    // intern table too, as most names are distinct)
+    void reserve(size_t users);
+    void clear();
+
+    // True once removed users and replaced strings hold a quarter of the
+    // store's memory (and at least USER_STORE_COMPACT_MIN_BYTES)
+    bool needsCompaction() const;
+
+    // Rewrite the store without removed users (whose removal was drained)
+    // and without strings nobody refers to. Handles are renumbered in order;
+    // returns old handle -> new handle, NO_USER for the dropped ones.
+    std::vector<UserHandle> compact();
+
+    // Same row as User::toCSV, written straight to the stream
+    void writeCSV(std::ostream& out, UserHandle handle) const;
+    std::string toCSV(UserHandle handle) const;
+
+    // Standalone User object for code that still works on those
+    std::shared_ptr<User> toUser(UserHandle handle) const;
+
+    // Heap bytes held by records, pool and indexes
+    size_t memoryBytes() const;
+};
+
+#endif // USERSTORE_H
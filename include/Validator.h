@@ -19,6 +19,12 @@ public:
     // Validate phone: 07XXXXXXXX or +467XXXXXXXX
     static bool validatePhone(const std::string& phone);
 
+    // Batch validation of a column of values: bit i of the result
+    // (word i / 64, bit i % 64) is set when values[i] is valid. Character
+    // classes are checked eight bytes at a time in 64-bit words (SWAR)
+    static std::vector<uint64_t> validateEmails(const std::vector<std::string>& emails);
+    static std::vector<uint64_t> validatePhones(const std::vector<std::string>& phones);
+
     // Generate a valid random email
     static std::string generateEmail(const std::string& name);
 
@@ -21,7 +21,7 @@
 #include <atomic>
 #include <chrono>
 #include <random>
-#include <regex>
+#include <cstdint>
 
 // Clearance levels for cards and floors (0-3)
 enum class ClearanceLevel {
@@ -31,28 +31,64 @@ enum class ClearanceLevel {
     LEVEL_3 = 3   // Highest clearance
 };
 
-// Access result when trying to enter a floor
-struct AccessAttempt {
-    std::string employeeId;
-    std::string employeeName;
-    std::string timestamp;
-    bool authorized;
+// One access attempt at a floor (16 bytes)
+struct AccessRecord {
+    int64_t epochSeconds;   // When, seconds since the Unix epoch
+    uint32_t userHandle;    // Roster handle (UserStore), UINT32_MAX if unknown
+    uint8_t authorized;     // 1 = granted, 0 = denied
 };
 
 // Global constants
 const std::string DATA_FILE = "data/users.csv";
+const std::string SNAPSHOT_FILE = "data/users.snap";  // Binary mirror of DATA_FILE
+const std::string JOURNAL_FILE = "data/users.journal";  // Changes not yet in DATA_FILE
+const size_t JOURNAL_COMPACT_MIN = 1024;  // Journal records before DATA_FILE is rewritten
 const std::string ADMIN_PASSWORD = "Admin@123";  // Hardcoded admin password
-const int CACHE_SIZE = 10;
+const size_t INITIAL_USER_COUNT = 1000;  // Users generated when there is no data file
+const size_t ROSTER_CHUNK_ROWS = 65536;  // Rows per generator work unit / random stream
+const size_t CACHE_SIZE = 4 * 1024 * 1024;  // User search cache budget in bytes
+const size_t STRING_POOL_CHUNK_BYTES = 64 * 1024;  // UserStore string arena block size
+const size_t USER_STORE_COMPACT_MIN_BYTES = 1024 * 1024;  // Garbage before a UserStore is compacted
+const size_t CARD_INDEX_FREEZE_MIN = 1024;  // Card changes before the card index is refrozen
+const size_t ACCESS_HISTORY_LIMIT = 100000;  // Access records kept per floor
+const uint32_t ROARING_ARRAY_MAX = 4096;  // Values per bitmap container before it goes dense
+const size_t EXCEPTION_DISPLAY_LIMIT = 20;  // Allow/deny entries listed per floor
+const uint32_t MINUTES_PER_DAY = 24 * 60;
+const uint32_t MINUTES_PER_WEEK = 7 * MINUTES_PER_DAY;  // Entries in a floor's schedule table
+const std::string SITE_FILE = "data/site.csv";  // Buildings, floors, zones and doors (optional)
+const std::string EXCEPTIONS_FILE = "data/exceptions.csv";  // Floor allow/deny lists by employee ID
+const size_t SITE_ID_MAX = 8;  // Longest site ID (reader requests and audit records hold 8)
+const size_t SITE_DISPLAY_LIMIT = 50;  // Zones and doors listed per floor
+const size_t SEARCH_RESULT_LIMIT = 10;  // Matches shown by the admin's user search
+const uint32_t SEARCH_HUB_POSTINGS = 4096;  // Search trie nodes this busy keep a bitmap of the users below
+const std::string AUDIT_DIR = "data/audit";  // Durable access log segments
+const size_t AUDIT_SEGMENT_RECORDS = 131072;  // 4 MB of records per segment
+const size_t AUDIT_COMMIT_BATCH = 4096;  // Queued records that trigger a commit
+const int AUDIT_COMMIT_INTERVAL_MS = 20;  // Longest a record waits to be committed
+const size_t AUDIT_MAX_PENDING = 1 << 20;  // Appenders block beyond this backlog
+const std::string SERVER_SOCKET = "data/access.sock";  // Default --serve socket
+const int SERVER_WORKERS = 4;  // Default --serve worker threads
+const std::string METRICS_FILE = "data/metrics.prom";  // Periodic Prometheus-format dump
+const int METRICS_DUMP_INTERVAL_SECONDS = 60;  // How often METRICS_FILE is rewritten
 
 // Utility function to get current timestamp
-inline std::string getCurrentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
+inline int64_t getCurrentEpochSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Format epoch seconds as local "YYYY-MM-DD HH:MM:SS"
+inline std::string formatTimestamp(int64_t epochSeconds) {
+    std::time_t time = static_cast<std::time_t>(epochSeconds);
     std::stringstream ss;
     ss << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
     return ss.str();
 }
 
+inline std::string getCurrentTimestamp() {
+    return formatTimestamp(getCurrentEpochSeconds());
+}
+
 // Convert clearance level to int
 inline int clearanceLevelToInt(ClearanceLevel level) {
     return static_cast<int>(level);
@@ -1,13 +1,66 @@
 #include <iostream>
 #include "SystemManager.h"
 #include "Validator.h"
+#include "DataGenerator.h"
+#include <filesystem>
 
-int main() {
+// Usage:
+//   main.exe                                            interactive menu
+//   main.exe --serve [socket path] [workers] [--menu]   badge-reader server,
+//                                                       --menu keeps the menu too
+//   main.exe --generate <users> [seed] [file]           write a seeded roster
+//                                                       (default DATA_FILE) and exit
+int main(int argc, char* argv[]) {
     try {
+        std::vector<std::string> args(argv + 1, argv + argc);
+
+        if (!args.empty() && args[0] == "--generate") {
+            if (args.size() < 2) {
+                std::cerr << "Usage: main.exe --generate <users> [seed] [file]" << std::endl;
+                return 1;
+            }
+            size_t userCount = std::stoull(args[1]);
+            uint64_t seed = args.size() > 2 ? std::stoull(args[2]) : 1;
+            std::string path = args.size() > 3 ? args[3] : DATA_FILE;
+            if (path == DATA_FILE) {
+                std::filesystem::create_directories("data");
+                DataManager().clearJournal();  // Changes to an old data file don't apply
+            }
+            return generateRoster(path, userCount, seed) ? 0 : 1;
+        }
+        bool serveMode = !args.empty() && args[0] == "--serve";
+        bool withMenu = false;
+        std::string socketPath = SERVER_SOCKET;
+        int workers = SERVER_WORKERS;
+
+        if (serveMode) {
+            auto menuFlag = std::find(args.begin(), args.end(), "--menu");
+            if (menuFlag != args.end()) {
+                withMenu = true;
+                args.erase(menuFlag);
+            }
+            if (args.size() > 1) socketPath = args[1];
+            if (args.size() > 2) {
+                try {
+                    workers = std::stoi(args[2]);
+                } catch (const std::exception&) {
+                    workers = 0;
+                }
+                if (workers < 1) {
+                    std::cerr << "Invalid worker count: " << args[2] << std::endl;
+                    return 1;
+                }
+            }
+        }
+
         // Create and initialize system manager
         SystemManager system;
         system.initialize();
         
+        if (serveMode) {
+            return system.serve(socketPath, static_cast<size_t>(workers), withMenu) ? 0 : 1;
+        }
+
         // Run the system
         system.run();
         
@@ -0,0 +1,430 @@
+// ============================================================================
+// FILE: src/AccessEngine.cpp
+// ============================================================================
+
+#include "AccessEngine.h"
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Swipes decided per inner pass: one bitmask word
+const size_t BLOCK = 64;
+
+// A level no card has, used for floors that don't exist
+const uint8_t NO_ACCESS = 0xFF;
+
+// A floor handle never handed out, for removed doors
+const FloorHandle NO_FLOOR = ~DOOR_HANDLE;
+
+// decideBatch's outcome counts, [2 * floor + granted], per thread so
+// batches on different workers don't share them; only the touched floors
+// are added to the registry and zeroed again after each batch
+struct OutcomeTally {
+    std::vector<uint32_t> counts;
+    std::vector<FloorHandle> touched;
+};
+thread_local OutcomeTally outcomeTally;
+
+}  // namespace
+
+AccessEngine::AccessEngine() : scheduledFloors(0), exceptionFloors(0), auditLog(nullptr) {}
+
+CardHandle AccessEngine::addCard(const std::string& cardId, const std::string& employeeId,
+                                 ClearanceLevel level) {
+    CardHandle handle = insertCard(cardId, employeeId, level);
+
+    // Cards added one by one pile up in the index's overlay; refolding it
+    // here keeps lookups at one probe (on the writer's copy, under RCU)
+    if (cardByCardId.needsFreeze()) cardByCardId.freeze();
+    return handle;
+}
+
+CardHandle AccessEngine::insertCard(const std::string& cardId, const std::string& employeeId,
+                                    ClearanceLevel level) {
+    CardHandle existing;
+    if (findCard(cardId, existing)) {
+        cardClearance[existing] = static_cast<uint8_t>(clearanceLevelToInt(level));
+        cardAudit[existing] = makeAuditRecord("", employeeId, false, 0);
+        return existing;
+    }
+
+    CardHandle handle = static_cast<CardHandle>(cardClearance.size());
+    cardClearance.push_back(static_cast<uint8_t>(clearanceLevelToInt(level)));
+    cardAudit.push_back(makeAuditRecord("", employeeId, false, 0));
+    cardByCardId.add(cardId, handle);
+    return handle;
+}
+
+FloorHandle AccessEngine::addFloor(const std::string& floorId, ClearanceLevel level) {
+    auto it = floorByFloorId.find(floorId);
+    if (it != floorByFloorId.end()) {
+        floorClearance[it->second] = static_cast<uint8_t>(clearanceLevelToInt(level));
+        return it->second;
+    }
+
+    FloorHandle handle = static_cast<FloorHandle>(floorClearance.size());
+    floorClearance.push_back(static_cast<uint8_t>(clearanceLevelToInt(level)));
+    floorMinimum.push_back(0);
+    floorAudit.push_back(makeAuditRecord(floorId, "", false, 0));
+    floorGranted.push_back(&Floor::accessCounter(floorId, true));
+    floorDenied.push_back(&Floor::accessCounter(floorId, false));
+    floorSchedule.emplace_back();
+    floorExceptions.emplace_back();
+    floorByFloorId.emplace(floorId, handle);
+    return handle;
+}
+
+FloorHandle AccessEngine::addDoor(const std::string& doorId, FloorHandle floor,
+                                  ClearanceLevel minimum) {
+    auto it = floorByFloorId.find(doorId);
+    if (it != floorByFloorId.end() && (it->second & DOOR_HANDLE)) {
+        size_t door = it->second & ~DOOR_HANDLE;
+        doorFloor[door] = floor;
+        doorMinimum[door] = static_cast<uint8_t>(clearanceLevelToInt(minimum));
+        return it->second;
+    }
+
+    FloorHandle handle = DOOR_HANDLE | static_cast<FloorHandle>(doorFloor.size());
+    doorFloor.push_back(floor);
+    doorMinimum.push_back(static_cast<uint8_t>(clearanceLevelToInt(minimum)));
+    doorAudit.push_back(makeAuditRecord(doorId, "", false, 0));
+    floorByFloorId[doorId] = handle;
+    return handle;
+}
+
+bool AccessEngine::removeDoor(const std::string& doorId) {
+    auto it = floorByFloorId.find(doorId);
+    if (it == floorByFloorId.end() || !(it->second & DOOR_HANDLE)) return false;
+
+    // The handle stays allocated on no floor; lookups no longer find it
+    doorFloor[it->second & ~DOOR_HANDLE] = NO_FLOOR;
+    floorByFloorId.erase(it);
+    return true;
+}
+
+bool AccessEngine::revokeCard(const std::string& cardId) {
+    CardHandle card;
+    if (!findCard(cardId, card)) return false;
+
+    // The handle stays allocated but revoked, so a stale handle matches no
+    // floor (level 0 included); lookups no longer find it
+    cardClearance[card] = 0;
+    revokedCards.add(card);
+    cardAudit[card] = makeAuditRecord("", "", false, 0);
+    // ...and can't stay on an allow list
+    for (FloorExceptions& entry : floorExceptions) {
+        bool hadExceptions = !entry.allow.empty() || !entry.deny.empty();
+        entry.allow.remove(card);
+        entry.deny.remove(card);
+        exceptionFloors -= hadExceptions && entry.allow.empty() && entry.deny.empty();
+    }
+    cardByCardId.remove(cardId);
+    return true;
+}
+
+void AccessEngine::reset() {
+    cardClearance.clear();
+    revokedCards.clear();
+    floorClearance.clear();
+    floorMinimum.clear();
+    doorFloor.clear();
+    doorMinimum.clear();
+    cardAudit.clear();
+    floorAudit.clear();
+    doorAudit.clear();
+    floorGranted.clear();
+    floorDenied.clear();
+    cardByCardId = CardIndex();
+    floorByFloorId.clear();
+    floorSchedule.clear();
+    scheduledFloors = 0;
+    floorExceptions.clear();
+    exceptionFloors = 0;
+}
+
+FloorHandle AccessEngine::loadFloor(const Floor& floor, const UserStore& users) {
+    FloorHandle handle = addFloor(floor.getId(), floor.getRequiredClearance());
+    setFloorSchedule(floor);
+    setFloorExceptions(floor, users);
+    return handle;
+}
+
+void AccessEngine::rebuild(const UserStore& users, const std::vector<Floor>& floors) {
+    rebuild(users, SiteModel());
+    for (const auto& floor : floors) {
+        loadFloor(floor, users);
+    }
+}
+
+void AccessEngine::rebuild(const UserStore& users, const SiteModel& site) {
+    reset();
+
+    cardClearance.reserve(users.size());
+    cardAudit.reserve(users.size());
+    users.forEach([&](UserHandle user) {
+        insertCard(std::string(users.getCardId(user)), std::string(users.getId(user)),
+                   users.getClearanceLevel(user));
+    });
+    cardByCardId.freeze();
+    site.forEachFloor([&](const Floor& floor) {
+        FloorHandle handle = loadFloor(floor, users);
+        setFloorMinimum(handle, site.getMinimum(site.findById(floor.getId())));
+    });
+
+    doorFloor.reserve(site.doorCount());
+    doorMinimum.reserve(site.doorCount());
+    doorAudit.reserve(site.doorCount());
+    floorByFloorId.reserve(site.floorCount() + site.doorCount());
+    site.forEachDoor(NO_SITE, [&](SiteId door) {
+        FloorHandle floor;
+        if (findFloor(site.getId(site.getFloorOf(door)), floor)) {
+            addDoor(site.getId(door), floor, site.getMinimum(door));
+        }
+    });
+}
+
+void AccessEngine::setCardClearance(CardHandle card, ClearanceLevel level) {
+    if (card < cardClearance.size()) {
+        cardClearance[card] = static_cast<uint8_t>(clearanceLevelToInt(level));
+    }
+}
+
+void AccessEngine::setFloorClearance(FloorHandle floor, ClearanceLevel level) {
+    if (floor < floorClearance.size()) {
+        floorClearance[floor] = static_cast<uint8_t>(clearanceLevelToInt(level));
+    }
+}
+
+void AccessEngine::setFloorMinimum(FloorHandle floor, ClearanceLevel level) {
+    if (floor < floorMinimum.size()) {
+        floorMinimum[floor] = static_cast<uint8_t>(clearanceLevelToInt(level));
+    }
+}
+
+bool AccessEngine::setFloorSchedule(const Floor& floor) {
+    FloorHandle handle;
+    if (!findFloor(floor.getId(), handle)) return false;
+
+    std::vector<uint8_t>& table = floorSchedule[handle];
+    scheduledFloors -= !table.empty();
+    if (floor.getSchedule().getRules().empty()) {
+        table.clear();
+    } else {
+        table = floor.getSchedule().getTable();
+    }
+    scheduledFloors += !table.empty();
+    return true;
+}
+
+bool AccessEngine::setFloorExceptions(const Floor& floor, const UserStore& users) {
+    FloorHandle handle;
+    if (!findFloor(floor.getId(), handle)) return false;
+
+    // Users without a registered card can't swipe, so they drop out
+    auto toCards = [&](const RoaringBitmap& userSet) {
+        RoaringBitmap cards;
+        userSet.forEach([&](UserHandle user) {
+            CardHandle card;
+            if (users.contains(user) && findCard(std::string(users.getCardId(user)), card)) {
+                cards.add(card);
+            }
+        });
+        return cards;
+    };
+
+    FloorExceptions& entry = floorExceptions[handle];
+    bool hadExceptions = !entry.allow.empty() || !entry.deny.empty();
+    entry.allow = toCards(floor.getAllowList());
+    entry.deny = toCards(floor.getDenyList());
+    bool hasExceptions = !entry.allow.empty() || !entry.deny.empty();
+
+    exceptionFloors += hasExceptions;
+    exceptionFloors -= hadExceptions;
+    return true;
+}
+
+bool AccessEngine::findCard(const std::string& cardId, CardHandle& handle) const {
+    UserHandle found = cardByCardId.find(cardId);
+    if (found == NO_USER) return false;
+    handle = found;
+    return true;
+}
+
+bool AccessEngine::findFloor(const std::string& floorId, FloorHandle& handle) const {
+    auto it = floorByFloorId.find(floorId);
+    if (it == floorByFloorId.end()) return false;
+    handle = it->second;
+    return true;
+}
+
+size_t AccessEngine::cardCount() const { return cardClearance.size(); }
+size_t AccessEngine::floorCount() const { return floorClearance.size(); }
+size_t AccessEngine::doorCount() const { return floorByFloorId.size() - floorClearance.size(); }
+
+void AccessEngine::setAuditLog(AuditLog* log) {
+    auditLog = log;
+}
+
+FloorHandle AccessEngine::floorOf(FloorHandle handle) const {
+    if (!(handle & DOOR_HANDLE)) return handle;
+    size_t door = handle & ~DOOR_HANDLE;
+    return door < doorFloor.size() ? doorFloor[door] : NO_FLOOR;
+}
+
+void AccessEngine::gatherLevels(const CardHandle* cards, const FloorHandle* floors, size_t count,
+                                uint32_t minute, uint8_t* cardLevels, uint8_t* floorLevels,
+                                FloorHandle* swipeFloors) const {
+    const size_t cardLimit = cardClearance.size();
+    const size_t floorLimit = floorClearance.size();
+    const bool scheduled = scheduledFloors > 0;
+    const bool revoked = !revokedCards.empty();
+    for (size_t i = 0; i < count; ++i) {
+        FloorHandle floor = floors[i];
+        uint8_t minimum = 0;
+        if (floor & DOOR_HANDLE) {
+            size_t door = floor & ~DOOR_HANDLE;
+            floor = door < doorFloor.size() ? doorFloor[door] : NO_FLOOR;
+            minimum = door < doorFloor.size() ? doorMinimum[door] : 0;
+        }
+        swipeFloors[i] = floor;
+        if (cards[i] < cardLimit && floor < floorLimit && !(revoked && revokedCards.contains(cards[i]))) {
+            // Only the floors this batch touches are looked at
+            uint8_t required = floorClearance[floor];
+            if (scheduled && !floorSchedule[floor].empty()) required = floorSchedule[floor][minute];
+            cardLevels[i] = cardClearance[cards[i]];
+            floorLevels[i] = std::max({required, floorMinimum[floor], minimum});
+        } else {
+            // Unknown or revoked card, or unknown floor: a pair that can never match
+            cardLevels[i] = 0;
+            floorLevels[i] = NO_ACCESS;
+        }
+    }
+}
+
+bool AccessEngine::applyExceptions(CardHandle card, FloorHandle handle, bool granted) const {
+    FloorHandle floor = floorOf(handle);
+    if (floor >= floorExceptions.size()) return granted;
+    const FloorExceptions& entry = floorExceptions[floor];
+    if (entry.deny.contains(card)) return false;
+    if (granted || card >= cardClearance.size() || !entry.allow.contains(card)) return granted;
+
+    uint8_t minimum = floorMinimum[floor];
+    if (handle & DOOR_HANDLE) minimum = std::max(minimum, doorMinimum[handle & ~DOOR_HANDLE]);
+    return cardClearance[card] >= minimum;
+}
+
+std::vector<uint64_t> AccessEngine::decideBatch(const CardHandle* cards, const FloorHandle* floors,
+                                                size_t count, int64_t epochSeconds) const {
+    std::vector<uint64_t> mask((count + BLOCK - 1) / BLOCK, 0);
+    alignas(16) uint8_t cardLevels[BLOCK];
+    alignas(16) uint8_t floorLevels[BLOCK];
+    FloorHandle swipeFloors[BLOCK];
+    const uint32_t minute = scheduledFloors > 0 ? AccessSchedule::minuteOfWeek(epochSeconds) : 0;
+
+    // Outcomes reach the registry once per floor per batch, not per swipe
+    OutcomeTally& tally = outcomeTally;
+    const size_t floorLimit = floorGranted.size();
+    if (tally.counts.size() < 2 * floorLimit) tally.counts.resize(2 * floorLimit, 0);
+    uint32_t* counts = tally.counts.data();
+
+    for (size_t base = 0; base < count; base += BLOCK) {
+        size_t n = std::min(BLOCK, count - base);
+        gatherLevels(cards + base, floors + base, n, minute, cardLevels, floorLevels, swipeFloors);
+
+        uint64_t word = 0;
+        size_t i = 0;
+#if defined(__SSE2__)
+        // card >= floor  <=>  max(card, floor) == card  (unsigned bytes)
+        for (; i + 16 <= n; i += 16) {
+            __m128i card = _mm_load_si128(reinterpret_cast<const __m128i*>(cardLevels + i));
+            __m128i floor = _mm_load_si128(reinterpret_cast<const __m128i*>(floorLevels + i));
+            __m128i granted = _mm_cmpeq_epi8(_mm_max_epu8(card, floor), card);
+            word |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(granted))) << i;
+        }
+#endif
+        for (; i < n; ++i) {
+            if (cardLevels[i] >= floorLevels[i]) word |= uint64_t(1) << i;
+        }
+        if (exceptionFloors > 0) {
+            for (i = 0; i < n; ++i) {
+                bool granted = (word >> i) & 1;
+                if (applyExceptions(cards[base + i], floors[base + i], granted) != granted) {
+                    word ^= uint64_t(1) << i;
+                }
+            }
+        }
+        mask[base / BLOCK] = word;
+
+        for (i = 0; i < n; ++i) {
+            FloorHandle floor = swipeFloors[i];
+            if (floor >= floorLimit) continue;
+            uint32_t* pair = counts + 2 * static_cast<size_t>(floor);
+            if ((pair[0] | pair[1]) == 0) tally.touched.push_back(floor);
+            ++pair[(word >> i) & 1];
+        }
+    }
+    for (FloorHandle floor : tally.touched) {
+        uint32_t* pair = counts + 2 * static_cast<size_t>(floor);
+        if (pair[1]) floorGranted[floor]->add(pair[1]);
+        if (pair[0]) floorDenied[floor]->add(pair[0]);
+        pair[0] = pair[1] = 0;
+    }
+    tally.touched.clear();
+
+    if (auditLog && count > 0) {
+        // Stitch each record from the card's and floor's pre-padded fields
+        std::vector<AuditRecord> records(count);
+        for (size_t i = 0; i < count; ++i) {
+            AuditRecord& rec = records[i];
+            if (cards[i] < cardAudit.size()) {
+                std::memcpy(rec.employeeId, cardAudit[cards[i]].employeeId, sizeof(rec.employeeId));
+            } else {
+                std::memset(rec.employeeId, 0, sizeof(rec.employeeId));
+            }
+            if (floors[i] & DOOR_HANDLE) {
+                size_t door = floors[i] & ~DOOR_HANDLE;
+                if (door < doorAudit.size()) {
+                    std::memcpy(rec.floorId, doorAudit[door].floorId, sizeof(rec.floorId));
+                } else {
+                    std::memset(rec.floorId, 0, sizeof(rec.floorId));
+                }
+            } else if (floors[i] < floorAudit.size()) {
+                std::memcpy(rec.floorId, floorAudit[floors[i]].floorId, sizeof(rec.floorId));
+            } else {
+                std::memset(rec.floorId, 0, sizeof(rec.floorId));
+            }
+            rec.epochSeconds = epochSeconds;
+            rec.authorized = static_cast<uint8_t>((mask[i / BLOCK] >> (i % BLOCK)) & 1);
+        }
+        auditLog->append(records.data(), records.size());
+    }
+
+    return mask;
+}
+
+std::vector<uint64_t> AccessEngine::decideBatchScalar(const CardHandle* cards, const FloorHandle* floors,
+                                                      size_t count, int64_t epochSeconds) const {
+    std::vector<uint64_t> mask((count + BLOCK - 1) / BLOCK, 0);
+    const uint32_t minute = AccessSchedule::minuteOfWeek(epochSeconds);
+    for (size_t i = 0; i < count; ++i) {
+        bool granted = false;
+        FloorHandle floor = floorOf(floors[i]);
+        if (cards[i] < cardClearance.size() && floor < floorClearance.size() &&
+            !revokedCards.contains(cards[i])) {
+            const std::vector<uint8_t>& table = floorSchedule[floor];
+            uint8_t required = table.empty() ? floorClearance[floor] : table[minute];
+            required = std::max(required, floorMinimum[floor]);
+            if (floors[i] & DOOR_HANDLE) {
+                required = std::max(required, doorMinimum[floors[i] & ~DOOR_HANDLE]);
+            }
+            granted = cardClearance[cards[i]] >= required;
+        }
+        granted = applyExceptions(cards[i], floors[i], granted);
+        if (granted) mask[i / BLOCK] |= uint64_t(1) << (i % BLOCK);
+    }
+    return mask;
+}
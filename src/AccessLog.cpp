@@ -0,0 +1,83 @@
+// ============================================================================
+// FILE: src/AccessLog.cpp
+// ============================================================================
+
+#include "AccessLog.h"
+#include <unordered_map>
+
+AccessLog::AccessLog(size_t maxRecords) : head(0), capacity(maxRecords) {}
+
+void AccessLog::record(UserHandle user, bool authorized, int64_t epochSeconds) {
+    if (capacity == 0) return;
+
+    AccessRecord rec;
+    rec.epochSeconds = epochSeconds;
+    rec.userHandle = user;
+    rec.authorized = authorized ? 1 : 0;
+
+    if (records.size() < capacity) {
+        records.push_back(rec);
+    } else {
+        records[head] = rec;
+        head = (head + 1) % capacity;
+    }
+}
+
+void AccessLog::setCapacity(size_t maxRecords) {
+    // Unroll into oldest-first order, then keep the newest maxRecords
+    std::vector<AccessRecord> ordered;
+    ordered.reserve(std::min(records.size(), maxRecords));
+    size_t skip = records.size() > maxRecords ? records.size() - maxRecords : 0;
+    for (size_t i = skip; i < records.size(); ++i) {
+        ordered.push_back(at(i));
+    }
+
+    records.swap(ordered);
+    head = 0;
+    capacity = maxRecords;
+}
+
+size_t AccessLog::getCapacity() const {
+    return capacity;
+}
+
+size_t AccessLog::size() const {
+    return records.size();
+}
+
+const AccessRecord& AccessLog::at(size_t index) const {
+    // head is 0 until the buffer wraps, so this is also right before then
+    return records[(head + index) % records.size()];
+}
+
+void AccessLog::remapUsers(const std::vector<UserHandle>& remap) {
+    for (AccessRecord& rec : records) {
+        if (rec.userHandle < remap.size()) rec.userHandle = remap[rec.userHandle];
+    }
+}
+
+void AccessLog::display(const UserLookup& lookup) const {
+    // Resolve each user once, not once per record
+    std::unordered_map<UserHandle, std::pair<std::string, std::string>> resolved;
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        const AccessRecord& rec = at(i);
+        auto it = resolved.find(rec.userHandle);
+        if (it == resolved.end()) {
+            std::pair<std::string, std::string> who;
+            if (rec.userHandle != NO_USER && lookup) who = lookup(rec.userHandle);
+            if (who.first.empty()) who = {"-", "(unknown user)"};
+            it = resolved.emplace(rec.userHandle, std::move(who)).first;
+        }
+
+        std::cout << std::left << std::setw(15) << it->second.first
+                  << std::setw(25) << it->second.second
+                  << std::setw(22) << formatTimestamp(rec.epochSeconds)
+                  << (rec.authorized ? "AUTHORIZED" : "DENIED") << std::endl;
+    }
+}
+
+void AccessLog::clear() {
+    records.clear();
+    head = 0;
+}
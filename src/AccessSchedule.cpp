@@ -0,0 +1,234 @@
+// ============================================================================
+// FILE: src/AccessSchedule.cpp
+// ============================================================================
+
+#include "AccessSchedule.h"
+#include <cctype>
+
+namespace {
+
+const char* const DAY_NAMES[7] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+
+// Day index for a name like "mon" or "Monday", -1 if it isn't one
+int dayIndex(const std::string& text) {
+    if (text.size() < 3) return -1;
+    for (int d = 0; d < 7; ++d) {
+        bool match = true;
+        for (size_t i = 0; i < 3; ++i) {
+            if (std::tolower(static_cast<unsigned char>(text[i])) !=
+                std::tolower(static_cast<unsigned char>(DAY_NAMES[d][i]))) {
+                match = false;
+            }
+        }
+        if (match) return d;
+    }
+    return -1;
+}
+
+std::string trimmed(const std::string& text) {
+    size_t first = text.find_first_not_of(' ');
+    if (first == std::string::npos) return "";
+    return text.substr(first, text.find_last_not_of(' ') - first + 1);
+}
+
+}  // namespace
+
+// Most floors never get a rule, so the table waits for the first one
+AccessSchedule::AccessSchedule(ClearanceLevel base) : baseLevel(base) {}
+
+template<typename F>
+void AccessSchedule::forEachSpan(const ScheduleRule& rule, F fn) {
+    uint32_t length = (rule.endMinute + MINUTES_PER_DAY - rule.startMinute) % MINUTES_PER_DAY;
+    if (length == 0) length = MINUTES_PER_DAY;  // start == end: a full day
+
+    for (uint32_t day = 0; day < 7; ++day) {
+        if (!(rule.days & (1u << day))) continue;
+        uint32_t begin = day * MINUTES_PER_DAY + rule.startMinute;
+        uint32_t end = begin + length;
+        if (end <= MINUTES_PER_WEEK) {
+            fn(begin, end);
+        } else {
+            // Sunday night into Monday morning
+            fn(begin, MINUTES_PER_WEEK);
+            fn(0, end - MINUTES_PER_WEEK);
+        }
+    }
+}
+
+void AccessSchedule::extendToRule(const ScheduleRule& rule, uint32_t& begin, uint32_t& end) {
+    forEachSpan(rule, [&](uint32_t spanBegin, uint32_t spanEnd) {
+        begin = std::min(begin, spanBegin);
+        end = std::max(end, spanEnd);
+    });
+}
+
+void AccessSchedule::recompile(uint32_t begin, uint32_t end) {
+    if (rules.empty()) {
+        std::vector<uint8_t>().swap(table);  // The base level alone applies
+        return;
+    }
+    if (begin >= end) return;
+    std::fill(table.begin() + begin, table.begin() + end,
+              static_cast<uint8_t>(clearanceLevelToInt(baseLevel)));
+    for (const ScheduleRule& rule : rules) {
+        const uint8_t level = static_cast<uint8_t>(clearanceLevelToInt(rule.level));
+        forEachSpan(rule, [&](uint32_t spanBegin, uint32_t spanEnd) {
+            uint32_t from = std::max(begin, spanBegin);
+            uint32_t to = std::min(end, spanEnd);
+            if (from < to) std::fill(table.begin() + from, table.begin() + to, level);
+        });
+    }
+}
+
+ClearanceLevel AccessSchedule::getBaseLevel() const { return baseLevel; }
+
+void AccessSchedule::setBaseLevel(ClearanceLevel level) {
+    baseLevel = level;
+    recompile(0, MINUTES_PER_WEEK);
+}
+
+const std::vector<ScheduleRule>& AccessSchedule::getRules() const { return rules; }
+
+void AccessSchedule::addRule(const ScheduleRule& rule) {
+    // The newest rule wins everywhere it covers: no other rule is involved
+    rules.push_back(rule);
+    if (table.empty()) table.assign(MINUTES_PER_WEEK, static_cast<uint8_t>(clearanceLevelToInt(baseLevel)));
+    const uint8_t level = static_cast<uint8_t>(clearanceLevelToInt(rule.level));
+    forEachSpan(rule, [&](uint32_t begin, uint32_t end) {
+        std::fill(table.begin() + begin, table.begin() + end, level);
+    });
+}
+
+bool AccessSchedule::replaceRule(size_t index, const ScheduleRule& rule) {
+    if (index >= rules.size()) return false;
+    // Only minutes inside the first and last window touched can change.
+    // Refilling that whole range is cheaper than clipping every rule
+    // against each window separately
+    uint32_t begin = MINUTES_PER_WEEK, end = 0;
+    extendToRule(rules[index], begin, end);
+    extendToRule(rule, begin, end);
+    rules[index] = rule;
+    recompile(begin, end);
+    return true;
+}
+
+bool AccessSchedule::removeRule(size_t index) {
+    if (index >= rules.size()) return false;
+    uint32_t begin = MINUTES_PER_WEEK, end = 0;
+    extendToRule(rules[index], begin, end);
+    rules.erase(rules.begin() + index);
+    recompile(begin, end);
+    return true;
+}
+
+ClearanceLevel AccessSchedule::levelAt(uint32_t minute) const {
+    return table.empty() ? baseLevel : intToClearanceLevel(table[minute % MINUTES_PER_WEEK]);
+}
+
+ClearanceLevel AccessSchedule::levelAtTime(int64_t epochSeconds) const {
+    return levelAt(minuteOfWeek(epochSeconds));
+}
+
+const std::vector<uint8_t>& AccessSchedule::getTable() const { return table; }
+
+uint32_t AccessSchedule::minuteOfWeek(int64_t epochSeconds) {
+    // Local time zones are whole minutes off UTC, so the answer only changes
+    // at a minute boundary; swipes come many per minute, localtime_r doesn't
+    thread_local int64_t cachedEpochMinute = INT64_MIN;
+    thread_local uint32_t cachedMinuteOfWeek = 0;
+
+    int64_t epochMinute = epochSeconds / 60;
+    if (epochMinute != cachedEpochMinute) {
+        std::time_t time = static_cast<std::time_t>(epochSeconds);
+        std::tm local;
+        localtime_r(&time, &local);
+        cachedMinuteOfWeek = static_cast<uint32_t>((local.tm_wday + 6) % 7) * MINUTES_PER_DAY +
+                             static_cast<uint32_t>(local.tm_hour * 60 + local.tm_min);
+        cachedEpochMinute = epochMinute;
+    }
+    return cachedMinuteOfWeek;
+}
+
+std::string AccessSchedule::describe(const ScheduleRule& rule) {
+    std::stringstream ss;
+    if ((rule.days & 0x7F) == 0x7F) {
+        ss << "Every day";
+    } else {
+        // Runs of consecutive days: "Mon-Fri", "Sat,Sun", "Wed"
+        bool first = true;
+        for (int d = 0; d < 7;) {
+            if (!(rule.days & (1u << d))) {
+                ++d;
+                continue;
+            }
+            int last = d;
+            while (last + 1 < 7 && (rule.days & (1u << (last + 1)))) ++last;
+            if (!first) ss << ",";
+            first = false;
+            if (last - d >= 2) {
+                ss << DAY_NAMES[d] << "-" << DAY_NAMES[last];
+            } else {
+                for (int i = d; i <= last; ++i) ss << (i > d ? "," : "") << DAY_NAMES[i];
+            }
+            d = last + 1;
+        }
+    }
+
+    auto clock = [&](uint16_t minute) {
+        ss << std::setw(2) << std::setfill('0') << minute / 60 << ":"
+           << std::setw(2) << std::setfill('0') << minute % 60;
+    };
+    ss << " ";
+    clock(rule.startMinute);
+    ss << "-";
+    clock(rule.endMinute);
+    ss << ", level " << clearanceLevelToInt(rule.level);
+    return ss.str();
+}
+
+bool AccessSchedule::parseDays(const std::string& text, uint8_t& days) {
+    std::string all = trimmed(text);
+    std::transform(all.begin(), all.end(), all.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (all == "all" || all == "daily") {
+        days = 0x7F;
+        return true;
+    }
+
+    uint8_t mask = 0;
+    std::stringstream ss(all);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item = trimmed(item);
+        size_t dash = item.find('-');
+        int from = dayIndex(trimmed(item.substr(0, dash)));
+        int to = dash == std::string::npos ? from : dayIndex(trimmed(item.substr(dash + 1)));
+        if (from < 0 || to < 0) return false;
+
+        // Ranges may wrap, e.g. Fri-Mon
+        for (int d = from;; d = (d + 1) % 7) {
+            mask |= static_cast<uint8_t>(1u << d);
+            if (d == to) break;
+        }
+    }
+    if (mask == 0) return false;
+    days = mask;
+    return true;
+}
+
+bool AccessSchedule::parseTime(const std::string& text, uint16_t& minute) {
+    std::string value = trimmed(text);
+    size_t colon = value.find(':');
+    if (colon == std::string::npos || colon == 0 || colon > 2 || value.size() != colon + 3) {
+        return false;
+    }
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (i != colon && !std::isdigit(static_cast<unsigned char>(value[i]))) return false;
+    }
+
+    int hours = std::stoi(value.substr(0, colon));
+    int minutes = std::stoi(value.substr(colon + 1));
+    if (minutes > 59 || hours > 24 || (hours == 24 && minutes != 0)) return false;
+    minute = static_cast<uint16_t>((hours * 60 + minutes) % MINUTES_PER_DAY);
+    return true;
+}
@@ -0,0 +1,329 @@
+// ============================================================================
+// FILE: src/AccessServer.cpp
+// ============================================================================
+
+#include "AccessServer.h"
+#include <csignal>
+#include <cstring>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Set by stop() and the signal handler, polled by the epoll loop
+volatile std::sig_atomic_t stopRequested = 0;
+
+void handleStopSignal(int) {
+    stopRequested = 1;
+}
+
+std::string paddedField(const char* src, size_t size) {
+    size_t len = 0;
+    while (len < size && src[len] != '\0') ++len;
+    return std::string(src, len);
+}
+
+}  // namespace
+
+struct AccessServer::Connection {
+    int fd;
+    std::vector<char> input;    // Bytes of a request that hasn't fully arrived
+    std::vector<char> output;   // Responses the socket couldn't take yet
+};
+
+AccessServer::AccessServer(const RcuCell<AccessEngine>& accessTables, const std::string& path, size_t threads)
+    : tables(accessTables), socketPath(path), workerCount(std::max<size_t>(1, threads)),
+      listenFd(-1), epollFd(-1), stopping(false) {}
+
+AccessServer::~AccessServer() {
+#ifndef _WIN32
+    if (listenFd >= 0) ::close(listenFd);
+    if (epollFd >= 0) ::close(epollFd);
+#endif
+}
+
+void AccessServer::stop() {
+    stopRequested = 1;
+}
+
+#ifdef _WIN32
+
+bool AccessServer::run() {
+    std::cerr << "Error: Server mode needs Unix domain sockets and epoll." << std::endl;
+    return false;
+}
+
+void AccessServer::acceptConnections() {}
+void AccessServer::workerLoop() {}
+bool AccessServer::serviceConnection(Connection&) { return false; }
+void AccessServer::decideRequests(const AccessRequest*, size_t, std::vector<AccessResponse>&) {}
+bool AccessServer::rearm(Connection&) { return false; }
+
+#else
+
+bool AccessServer::run() {
+    stopRequested = 0;
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+    std::signal(SIGPIPE, SIG_IGN);  // A reader hanging up must not kill the server
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path too long: " << socketPath << std::endl;
+        return false;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    ::unlink(socketPath.c_str());  // Left over from an earlier run
+    if (listenFd < 0 ||
+        ::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd, SOMAXCONN) != 0) {
+        std::cerr << "Error: Could not listen on " << socketPath << ": "
+                  << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event listenEvent;
+    std::memset(&listenEvent, 0, sizeof(listenEvent));
+    listenEvent.events = EPOLLIN;
+    listenEvent.data.ptr = nullptr;  // nullptr marks the listening socket
+    if (epollFd < 0 || ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &listenEvent) != 0) {
+        std::cerr << "Error: Could not set up epoll." << std::endl;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = false;
+    }
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&AccessServer::workerLoop, this);
+    }
+
+    std::cout << "Serving access requests on " << socketPath << " with "
+              << workerCount << " workers (Ctrl+C to stop)" << std::endl;
+
+    // Connections are registered EPOLLONESHOT: after an event fires, nothing
+    // else is reported for that socket until its worker re-arms it, so only
+    // one worker ever touches a connection and responses stay in order
+    const int maxEvents = 64;
+    epoll_event events[maxEvents];
+    while (!stopRequested) {
+        int n = ::epoll_wait(epollFd, events, maxEvents, 200);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        bool acceptPending = false;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.ptr == nullptr) {
+                    acceptPending = true;
+                } else {
+                    ready.push_back(static_cast<Connection*>(events[i].data.ptr));
+                }
+            }
+        }
+        queueCondition.notify_all();
+
+        if (acceptPending) {
+            acceptConnections();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    // Workers are gone, so every connection left is ours to close
+    for (Connection* conn : connections) {
+        ::close(conn->fd);
+        delete conn;
+    }
+    connections.clear();
+    ready.clear();
+
+    ::close(epollFd);
+    epollFd = -1;
+    ::close(listenFd);
+    listenFd = -1;
+    ::unlink(socketPath.c_str());
+    std::cout << "Server stopped." << std::endl;
+    return true;
+}
+
+void AccessServer::acceptConnections() {
+    while (true) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN: nothing more to accept
+
+        Connection* conn = new Connection();
+        conn->fd = fd;
+
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        event.data.ptr = conn;
+        std::lock_guard<std::mutex> lock(queueMutex);
+        connections.insert(conn);
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            connections.erase(conn);
+            ::close(fd);
+            delete conn;
+        }
+    }
+}
+
+void AccessServer::workerLoop() {
+    while (true) {
+        Connection* conn;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]() { return stopping || !ready.empty(); });
+            if (stopping) return;
+            conn = ready.front();
+            ready.pop_front();
+        }
+
+        if (!serviceConnection(*conn) || !rearm(*conn)) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            connections.erase(conn);
+            ::close(conn->fd);  // Also drops it from the epoll set
+            delete conn;
+        }
+    }
+}
+
+bool AccessServer::serviceConnection(Connection& conn) {
+    // Finish responses left over from last time before taking new requests
+    while (!conn.output.empty()) {
+        ssize_t sent = ::send(conn.fd, conn.output.data(), conn.output.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            return false;
+        }
+        conn.output.erase(conn.output.begin(), conn.output.begin() + sent);
+    }
+
+    char buffer[64 * 1024];
+    std::vector<AccessRequest> requests;
+    std::vector<AccessResponse> responses;
+    bool peerOpen = true;
+
+    while (true) {
+        ssize_t received = ::recv(conn.fd, buffer, sizeof(buffer), 0);
+        if (received == 0) {
+            peerOpen = false;
+            break;
+        }
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+
+        // Every complete request in what has arrived so far is one batch
+        conn.input.insert(conn.input.end(), buffer, buffer + received);
+        size_t complete = conn.input.size() / sizeof(AccessRequest);
+        if (complete == 0) continue;
+
+        requests.resize(complete);
+        std::memcpy(requests.data(), conn.input.data(), complete * sizeof(AccessRequest));
+        conn.input.erase(conn.input.begin(), conn.input.begin() + complete * sizeof(AccessRequest));
+
+        decideRequests(requests.data(), complete, responses);
+
+        const char* out = reinterpret_cast<const char*>(responses.data());
+        size_t remaining = responses.size() * sizeof(AccessResponse);
+        while (remaining > 0 && conn.output.empty()) {
+            ssize_t sent = ::send(conn.fd, out, remaining, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+                break;
+            }
+            out += sent;
+            remaining -= static_cast<size_t>(sent);
+        }
+        conn.output.insert(conn.output.end(), out, out + remaining);
+        if (!conn.output.empty()) break;  // Wait for the reader to drain its socket
+    }
+
+    return peerOpen || !conn.output.empty();
+}
+
+void AccessServer::decideRequests(const AccessRequest* requests, size_t count,
+                                  std::vector<AccessResponse>& responses) {
+    responses.assign(count, AccessResponse());
+
+    // One version for the whole batch; admin edits publish a new one
+    // without waiting for us
+    auto engine = tables.read();
+    if (!engine) {
+        for (size_t i = 0; i < count; ++i) {
+            responses[i].requestId = requests[i].requestId;
+            responses[i].result = ACCESS_UNKNOWN_CARD;
+        }
+        return;
+    }
+
+    // Resolve IDs to handles; only known pairs go to the engine
+    std::vector<CardHandle> cards;
+    std::vector<FloorHandle> floors;
+    std::vector<size_t> positions;
+    cards.reserve(count);
+    floors.reserve(count);
+    positions.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        responses[i].requestId = requests[i].requestId;
+        CardHandle card;
+        FloorHandle floor;
+        if (!engine->findCard(paddedField(requests[i].cardId, sizeof(requests[i].cardId)), card)) {
+            responses[i].result = ACCESS_UNKNOWN_CARD;
+        } else if (!engine->findFloor(paddedField(requests[i].floorId, sizeof(requests[i].floorId)), floor)) {
+            responses[i].result = ACCESS_UNKNOWN_FLOOR;
+        } else {
+            cards.push_back(card);
+            floors.push_back(floor);
+            positions.push_back(i);
+        }
+    }
+
+    auto granted = engine->decideBatch(cards.data(), floors.data(), cards.size(),
+                                      getCurrentEpochSeconds());
+    for (size_t j = 0; j < positions.size(); ++j) {
+        bool ok = (granted[j / 64] >> (j % 64)) & 1;
+        responses[positions[j]].result = ok ? ACCESS_GRANTED : ACCESS_DENIED;
+    }
+}
+
+bool AccessServer::rearm(Connection& conn) {
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    // While responses are backed up, wait for room instead of more input
+    event.events = (conn.output.empty() ? EPOLLIN : EPOLLOUT) | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.ptr = &conn;
+    return ::epoll_ctl(epollFd, EPOLL_CTL_MOD, conn.fd, &event) == 0;
+}
+
+#endif
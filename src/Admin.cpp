@@ -3,16 +3,21 @@
 // ============================================================================
 #include "Admin.h"
 
-Admin::Admin(const std::string& adminId, const std::string& adminName,
-             const std::string& adminEmail, const std::string& adminPhone,
-             std::shared_ptr<Card> adminCard, const std::string& adminPassword)
-    : User(adminId, adminName, adminEmail, adminPhone, adminCard),
-      password(adminPassword) {}
+Admin::Admin(std::string adminId, std::string adminName,
+             std::string adminEmail, std::string adminPhone,
+             std::shared_ptr<Card> adminCard, std::string adminPassword)
+    : User(std::move(adminId), std::move(adminName), std::move(adminEmail),
+           std::move(adminPhone), std::move(adminCard)),
+      password(std::move(adminPassword)) {}
 
 bool Admin::verifyPassword(const std::string& inputPassword) const {
     return password == inputPassword;
 }
 
+const std::string& Admin::getPassword() const {
+    return password;
+}
+
 std::string Admin::toCSV() const {
     return id + "," + name + "," + email + "," + phone + "," +
            card->getId() + "," + std::to_string(card->getClearanceLevelInt()) + 
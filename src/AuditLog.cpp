@@ -0,0 +1,399 @@
+// ============================================================================
+// FILE: src/AuditLog.cpp
+// ============================================================================
+
+#include "AuditLog.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char AUDIT_MAGIC[8] = {'S', 'C', 'S', 'A', 'U', 'D', 'I', 'T'};
+
+// Push written data to the device, not just the OS cache
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fdatasync(fileno(file)) == 0;
+#endif
+}
+
+void copyPadded(char* dest, size_t size, const std::string& value) {
+    std::memset(dest, 0, size);
+    std::memcpy(dest, value.data(), std::min(size, value.size()));
+}
+
+std::string readPadded(const char* src, size_t size) {
+    size_t len = 0;
+    while (len < size && src[len] != '\0') ++len;
+    return std::string(src, len);
+}
+
+// Segment number from "audit-<number>.seg", 0 if the name doesn't match
+uint64_t segmentNumberOf(const std::string& fileName) {
+    if (fileName.size() != 18 || fileName.compare(0, 6, "audit-") != 0 ||
+        fileName.compare(14, 4, ".seg") != 0) {
+        return 0;
+    }
+    uint64_t number = 0;
+    for (size_t i = 6; i < 14; ++i) {
+        if (fileName[i] < '0' || fileName[i] > '9') return 0;
+        number = number * 10 + static_cast<uint64_t>(fileName[i] - '0');
+    }
+    return number;
+}
+
+// Segment files in a directory, oldest first
+std::vector<std::pair<uint64_t, std::string>> listSegments(const std::string& dir) {
+    std::vector<std::pair<uint64_t, std::string>> found;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        uint64_t number = segmentNumberOf(entry.path().filename().string());
+        if (number > 0) found.emplace_back(number, entry.path().string());
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+}  // namespace
+
+AuditRecord makeAuditRecord(const std::string& floorId, const std::string& employeeId,
+                            bool authorized, int64_t epochSeconds) {
+    AuditRecord rec;
+    rec.epochSeconds = epochSeconds;
+    copyPadded(rec.floorId, sizeof(rec.floorId), floorId);
+    copyPadded(rec.employeeId, sizeof(rec.employeeId), employeeId);
+    rec.authorized = authorized ? 1 : 0;
+    return rec;
+}
+
+std::string auditFloorId(const AuditRecord& rec) {
+    return readPadded(rec.floorId, sizeof(rec.floorId));
+}
+
+std::string auditEmployeeId(const AuditRecord& rec) {
+    return readPadded(rec.employeeId, sizeof(rec.employeeId));
+}
+
+// FNV-1a over 64-bit words (records are 4 words each)
+uint64_t auditChecksum(const AuditRecord* records, size_t count, uint64_t seed) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(records);
+    size_t words = count * sizeof(AuditRecord) / sizeof(uint64_t);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(word));
+        hash ^= word;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+AuditLog::AuditLog(size_t recordsPerSegment)
+    : segmentRecords(recordsPerSegment), segment(nullptr), segmentNumber(0),
+      segmentCount(0), segmentSum(0), appended(0), committed(0), flushTarget(0),
+      stopping(false), failed(false) {}
+
+AuditLog::~AuditLog() {
+    close();
+}
+
+std::string AuditLog::segmentPath(const std::string& dir, uint64_t number) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "audit-%08llu.seg", static_cast<unsigned long long>(number));
+    return dir + "/" + name;
+}
+
+bool AuditLog::openSegment(uint64_t number) {
+    std::FILE* file = std::fopen(segmentPath(directory, number).c_str(), "wb");
+    if (!file) return false;
+
+    AuditSegmentHeader header = {};
+    std::memcpy(header.magic, AUDIT_MAGIC, sizeof(header.magic));
+    header.version = AUDIT_VERSION;
+    header.recordSize = sizeof(AuditRecord);
+    header.segmentNumber = number;
+    header.recordCapacity = segmentRecords;
+
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1 || !syncFile(file)) {
+        std::fclose(file);
+        return false;
+    }
+
+    segment = file;
+    segmentNumber = number;
+    segmentCount = 0;
+    segmentSum = auditChecksum(nullptr, 0);
+    return true;
+}
+
+bool AuditLog::resumeSegment(const std::string& path, uint64_t number) {
+    // Rebuild the running checksum from what is on disk and drop a torn
+    // trailing record, then keep appending where the last run stopped
+    uint64_t count;
+    uint64_t sum;
+    {
+        MappedFile mapped;
+        if (!mapped.open(path) || mapped.size() < sizeof(AuditSegmentHeader)) return false;
+
+        AuditSegmentHeader header;
+        std::memcpy(&header, mapped.data(), sizeof(header));
+        if (std::memcmp(header.magic, AUDIT_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != AUDIT_VERSION || header.recordSize != sizeof(AuditRecord) ||
+            header.sealed != 0 || header.recordCapacity != segmentRecords) {
+            return false;
+        }
+
+        count = std::min<uint64_t>((mapped.size() - sizeof(header)) / sizeof(AuditRecord),
+                                   segmentRecords);
+        sum = auditChecksum(reinterpret_cast<const AuditRecord*>(mapped.data() + sizeof(header)),
+                            count);
+    }
+
+    std::error_code ec;
+    std::filesystem::resize_file(path, sizeof(AuditSegmentHeader) + count * sizeof(AuditRecord), ec);
+    if (ec) return false;
+
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+    if (!file) return false;
+    std::fseek(file, 0, SEEK_END);
+
+    segment = file;
+    segmentNumber = number;
+    segmentCount = count;
+    segmentSum = sum;
+    return true;
+}
+
+bool AuditLog::sealSegment() {
+    AuditSegmentHeader header = {};
+    std::memcpy(header.magic, AUDIT_MAGIC, sizeof(header.magic));
+    header.version = AUDIT_VERSION;
+    header.recordSize = sizeof(AuditRecord);
+    header.segmentNumber = segmentNumber;
+    header.recordCapacity = segmentRecords;
+    header.recordCount = segmentCount;
+    header.checksum = segmentSum;
+    header.sealed = 1;
+
+    // Records first, then the header that vouches for them
+    bool ok = syncFile(segment);
+    ok = ok && std::fseek(segment, 0, SEEK_SET) == 0;
+    ok = ok && std::fwrite(&header, sizeof(header), 1, segment) == 1;
+    ok = ok && syncFile(segment);
+    std::fclose(segment);
+    segment = nullptr;
+    return ok;
+}
+
+bool AuditLog::writeRecords(const AuditRecord* records, size_t count) {
+    while (count > 0) {
+        if (!segment) return false;
+
+        size_t room = segmentRecords - segmentCount;
+        size_t chunk = std::min(room, count);
+        if (std::fwrite(records, sizeof(AuditRecord), chunk, segment) != chunk) return false;
+
+        segmentSum = auditChecksum(records, chunk, segmentSum);
+        segmentCount += chunk;
+        records += chunk;
+        count -= chunk;
+
+        if (segmentCount == segmentRecords) {
+            if (!sealSegment() || !openSegment(segmentNumber + 1)) return false;
+        }
+    }
+    return true;
+}
+
+bool AuditLog::open(const std::string& dir) {
+    close();
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) return false;
+
+    directory = dir;
+    auto existing = listSegments(dir);
+    bool ready = false;
+    if (!existing.empty()) {
+        // Continue an unsealed newest segment, otherwise start the next one
+        ready = resumeSegment(existing.back().second, existing.back().first) ||
+                openSegment(existing.back().first + 1);
+    } else {
+        ready = openSegment(1);
+    }
+    if (!ready) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = false;
+        failed = false;
+    }
+    writer = std::thread(&AuditLog::writerLoop, this);
+    return true;
+}
+
+void AuditLog::close() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueCondition.notify_all();
+        writer.join();
+    }
+    if (segment) {
+        syncFile(segment);
+        std::fclose(segment);
+        segment = nullptr;
+    }
+}
+
+bool AuditLog::isOpen() const {
+    return segment != nullptr;
+}
+
+void AuditLog::append(const AuditRecord& record) {
+    append(&record, 1);
+}
+
+void AuditLog::append(const AuditRecord* records, size_t count) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    if (!writer.joinable() || failed) return;
+
+    // Back-pressure instead of letting the queue grow without bound
+    commitCondition.wait(lock, [this]() {
+        return pending.size() < AUDIT_MAX_PENDING || stopping || failed;
+    });
+
+    pending.insert(pending.end(), records, records + count);
+    appended += count;
+    if (pending.size() >= AUDIT_COMMIT_BATCH) {
+        queueCondition.notify_one();
+    }
+}
+
+bool AuditLog::flush() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    uint64_t target = appended;
+    flushTarget = std::max(flushTarget, target);
+    queueCondition.notify_one();
+    commitCondition.wait(lock, [this, target]() { return committed >= target || failed; });
+    return !failed;
+}
+
+// Group commit: everything queued since the last pass shares one write and
+// one sync. Wakes on a full batch, a flush() or the commit interval.
+void AuditLog::writerLoop() {
+    std::vector<AuditRecord> batch;
+    std::unique_lock<std::mutex> lock(queueMutex);
+
+    while (true) {
+        queueCondition.wait_for(lock, std::chrono::milliseconds(AUDIT_COMMIT_INTERVAL_MS), [this]() {
+            return stopping || pending.size() >= AUDIT_COMMIT_BATCH || flushTarget > committed;
+        });
+
+        if (pending.empty()) {
+            if (stopping) break;
+            continue;
+        }
+
+        batch.swap(pending);
+        uint64_t target = appended;
+        lock.unlock();
+
+        bool ok = writeRecords(batch.data(), batch.size()) && syncFile(segment);
+        batch.clear();
+
+        lock.lock();
+        if (ok) {
+            committed = target;
+        } else {
+            failed = true;
+            pending.clear();
+            std::cerr << "Error: Could not write the audit log in " << directory << "." << std::endl;
+        }
+        commitCondition.notify_all();
+        if (failed) break;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+AuditReader::AuditReader() : corruptSegments(0) {}
+
+bool AuditReader::open(const std::string& dir) {
+    segments.clear();
+    corruptSegments = 0;
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir, ec)) return false;
+
+    for (auto& found : listSegments(dir)) {
+        segments.push_back(found.second);
+    }
+    return true;
+}
+
+size_t AuditReader::segmentCount() const {
+    return segments.size();
+}
+
+size_t AuditReader::corruptCount() const {
+    return corruptSegments;
+}
+
+size_t AuditReader::forEach(const std::function<void(const AuditRecord&)>& fn) {
+    size_t visited = 0;
+    corruptSegments = 0;
+
+    for (const auto& path : segments) {
+        MappedFile mapped;
+        if (!mapped.open(path) || mapped.size() < sizeof(AuditSegmentHeader)) {
+            ++corruptSegments;
+            continue;
+        }
+
+        AuditSegmentHeader header;
+        std::memcpy(&header, mapped.data(), sizeof(header));
+        if (std::memcmp(header.magic, AUDIT_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != AUDIT_VERSION || header.recordSize != sizeof(AuditRecord)) {
+            ++corruptSegments;
+            continue;
+        }
+
+        // Header and records are 8-byte aligned within the page-aligned mapping
+        const AuditRecord* records =
+            reinterpret_cast<const AuditRecord*>(mapped.data() + sizeof(header));
+        uint64_t available = (mapped.size() - sizeof(header)) / sizeof(AuditRecord);
+        uint64_t count = header.sealed ? header.recordCount : available;
+
+        if (header.sealed &&
+            (count > available || auditChecksum(records, count) != header.checksum)) {
+            ++corruptSegments;
+            continue;
+        }
+
+        for (uint64_t i = 0; i < count; ++i) {
+            fn(records[i]);
+        }
+        visited += count;
+    }
+    return visited;
+}
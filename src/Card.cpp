@@ -4,10 +4,10 @@
 #include "Card.h"
 
 // Card implementation
-Card::Card(const std::string& cardId, ClearanceLevel level)
-    : id(cardId), clearanceLevel(level) {}
+Card::Card(std::string cardId, ClearanceLevel level)
+    : id(std::move(cardId)), clearanceLevel(level) {}
 
-std::string Card::getId() const {
+const std::string& Card::getId() const {
     return id;
 }
 
@@ -0,0 +1,228 @@
+// ============================================================================
+// FILE: src/CardIndex.cpp
+// ============================================================================
+
+#include "CardIndex.h"
+
+namespace {
+
+// Seeds tried per bucket before its cards go to the overlay instead (only
+// reachable if two card IDs share a 64-bit hash)
+const uint32_t MAX_SEED_TRIES = 1 << 20;
+
+// FNV-1a, as in the store and snapshot indexes
+uint64_t hashCard(std::string_view cardId) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char ch : cardId) {
+        hash ^= ch;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Re-mix the card's hash with a bucket seed (SplitMix64 finalizer)
+uint64_t seededHash(uint64_t hash, uint32_t seed) {
+    uint64_t x = hash ^ (seed * 0x9E3779B97F4A7C15ULL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Map a hash onto [0, n) without a division
+size_t reduce(uint64_t hash, size_t n) {
+    return static_cast<size_t>(((hash >> 32) * n) >> 32);
+}
+
+// FNV-1a's high bits barely vary between IDs like CARD1..CARD50, so the
+// bucket comes from a mixed hash too (a "seed" no slot search reaches)
+size_t bucketOf(uint64_t hash, size_t buckets) {
+    return reduce(seededHash(hash, UINT32_MAX), buckets);
+}
+
+} // namespace
+
+CardIndex::CardIndex() : frozenCount(0), liveCount(0) {}
+
+void CardIndex::build(const std::vector<CardEntry>& entries) {
+    seeds.clear();
+    slots.clear();
+    keys.clear();
+    changes.clear();
+    frozenCount = 0;
+    liveCount = 0;
+
+    size_t n = entries.size();
+    if (n == 0) return;
+
+    // About four cards per bucket and a 0.8 load factor: most buckets find
+    // a working seed within a few tries
+    size_t bucketCount = (n + 3) / 4;
+    size_t slotCount = n + n / 4 + 1;
+
+    // Group cards by bucket, keeping their order within a bucket
+    std::vector<uint64_t> hashes(n);
+    std::vector<size_t> bucketStart(bucketCount + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        hashes[i] = hashCard(entries[i].cardId);
+        ++bucketStart[bucketOf(hashes[i], bucketCount) + 1];
+    }
+    size_t largest = 0;
+    for (size_t b = 0; b < bucketCount; ++b) {
+        largest = std::max(largest, bucketStart[b + 1]);
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    std::vector<size_t> members(n);
+    std::vector<size_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        members[fill[bucketOf(hashes[i], bucketCount)]++] = i;
+    }
+
+    // Place the biggest buckets first, while the table is still empty
+    std::vector<std::vector<uint32_t>> bySize(largest + 1);
+    for (size_t b = 0; b < bucketCount; ++b) {
+        bySize[bucketStart[b + 1] - bucketStart[b]].push_back(static_cast<uint32_t>(b));
+    }
+
+    // Seed trials only test this bitmap (a bit per slot stays in cache);
+    // the slot array itself is written once per card
+    seeds.assign(bucketCount, 0);
+    slots.assign(slotCount, Slot{0, NO_USER});
+    std::vector<uint64_t> taken((slotCount + 63) / 64, 0);
+    std::vector<size_t> cards;
+    std::vector<uint64_t> cardHashes;
+    std::vector<size_t> chosen;
+    for (size_t size = largest; size > 0; --size) {
+        for (uint32_t bucket : bySize[size]) {
+            // Equal card IDs hash alike, so duplicates meet here; first wins
+            cards.clear();
+            cardHashes.clear();
+            for (size_t m = bucketStart[bucket]; m < bucketStart[bucket + 1]; ++m) {
+                size_t i = members[m];
+                bool duplicate = false;
+                for (size_t other : cards) {
+                    duplicate = duplicate || (hashes[other] == hashes[i] &&
+                                              entries[other].cardId == entries[i].cardId);
+                }
+                if (!duplicate) {
+                    cards.push_back(i);
+                    cardHashes.push_back(hashes[i]);
+                }
+            }
+
+            bool placed = false;
+            for (uint32_t seed = 0; seed < MAX_SEED_TRIES && !placed; ++seed) {
+                chosen.clear();
+                placed = true;
+                for (uint64_t hash : cardHashes) {
+                    size_t slot = reduce(seededHash(hash, seed), slotCount);
+                    if ((taken[slot / 64] >> (slot % 64)) & 1 ||
+                        std::find(chosen.begin(), chosen.end(), slot) != chosen.end()) {
+                        placed = false;
+                        break;
+                    }
+                    chosen.push_back(slot);
+                }
+                if (placed) seeds[bucket] = seed;
+            }
+
+            for (size_t k = 0; k < cards.size(); ++k) {
+                const CardEntry& entry = entries[cards[k]];
+                if (placed) {
+                    slots[chosen[k]] = Slot{keys.append(entry.cardId), entry.holder};
+                    taken[chosen[k] / 64] |= uint64_t(1) << (chosen[k] % 64);
+                    ++frozenCount;
+                } else {
+                    changes.emplace(std::string(entry.cardId), entry.holder);
+                }
+                ++liveCount;
+            }
+        }
+    }
+}
+
+UserHandle CardIndex::findFrozen(std::string_view cardId) const {
+    if (slots.empty()) return NO_USER;
+
+    uint64_t hash = hashCard(cardId);
+    uint32_t seed = seeds[bucketOf(hash, seeds.size())];
+    const Slot& slot = slots[reduce(seededHash(hash, seed), slots.size())];
+    if (slot.holder != NO_USER && keys.view(slot.cardId) == cardId) {
+        return slot.holder;
+    }
+    return NO_USER;
+}
+
+UserHandle CardIndex::find(const std::string& cardId) const {
+    // The overlay is empty in steady state, leaving the one frozen probe
+    if (!changes.empty()) {
+        auto it = changes.find(cardId);
+        if (it != changes.end()) return it->second;
+    }
+    return findFrozen(cardId);
+}
+
+void CardIndex::add(const std::string& cardId, UserHandle holder) {
+    if (find(cardId) == NO_USER) ++liveCount;
+    changes[cardId] = holder;
+}
+
+void CardIndex::remove(const std::string& cardId) {
+    if (find(cardId) == NO_USER) return;
+    changes[cardId] = NO_USER;
+    --liveCount;
+}
+
+void CardIndex::freeze() {
+    if (changes.empty()) return;
+
+    // The entries point into the old key pool and overlay, so keep those
+    // alive until build() has copied them
+    StringPool oldKeys;
+    std::swap(oldKeys, keys);
+    std::unordered_map<std::string, UserHandle> oldChanges;
+    oldChanges.swap(changes);
+
+    std::vector<CardEntry> entries;
+    entries.reserve(liveCount);
+    for (const Slot& slot : slots) {
+        if (slot.holder == NO_USER) continue;
+        std::string_view cardId = oldKeys.view(slot.cardId);
+        if (oldChanges.count(std::string(cardId))) continue;  // Replaced or removed since
+        entries.push_back({cardId, slot.holder});
+    }
+    for (const auto& change : oldChanges) {
+        if (change.second != NO_USER) entries.push_back({change.first, change.second});
+    }
+    build(entries);
+}
+
+void CardIndex::catchUp(const CardIndex& live) {
+    for (const auto& change : live.changes) {
+        if (find(change.first) == change.second) continue;  // Folded in by the freeze
+        if (change.second == NO_USER) {
+            remove(change.first);
+        } else {
+            add(change.first, change.second);
+        }
+    }
+}
+
+void CardIndex::remapHolders(const std::vector<UserHandle>& remap) {
+    auto mapped = [&](UserHandle holder) {
+        return holder < remap.size() ? remap[holder] : holder;  // NO_USER, ADMIN_USER
+    };
+    for (Slot& slot : slots) slot.holder = mapped(slot.holder);
+    for (auto& change : changes) change.second = mapped(change.second);
+}
+
+bool CardIndex::needsFreeze() const {
+    return changes.size() >= std::max(CARD_INDEX_FREEZE_MIN, liveCount / 8);
+}
+
+size_t CardIndex::size() const {
+    return liveCount;
+}
+
+size_t CardIndex::pendingChanges() const {
+    return changes.size();
+}
@@ -0,0 +1,83 @@
+// ============================================================================
+// FILE: src/ChangeJournal.cpp
+// ============================================================================
+
+#include "ChangeJournal.h"
+#include "FileSync.h"
+#include <filesystem>
+
+ChangeJournal::ChangeJournal(const std::string& journalPath)
+    : path(journalPath), records(0), torn(false) {}
+
+bool ChangeJournal::append(const std::vector<JournalRecord>& changes) {
+    if (changes.empty()) return true;
+
+    // Build the whole batch first so it goes out in one write. Order is
+    // kept: "delete X, create a new X" must not replay as the reverse.
+    std::string batch;
+    if (torn) batch += '\n';  // End what a failed write left behind; read() skips the scrap
+    for (const auto& change : changes) {
+        batch += change.isDelete ? "D," : "U,";
+        batch += change.payload;
+        batch += '\n';
+    }
+
+    std::error_code ec;
+    bool created = !std::filesystem::exists(path, ec);
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if (!file.is_open()) return false;
+    file.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+    file.close();
+
+    // A failed write may have left part of a line; the next batch must not
+    // be glued onto it
+    torn = !file || !syncFile(path);
+    if (torn) return false;
+    if (created && !syncDirectory(std::filesystem::path(path).parent_path().string())) {
+        return false;  // The records are written; a retry appends them again, which replays the same
+    }
+
+    records += changes.size();
+    return true;
+}
+
+std::vector<JournalRecord> ChangeJournal::read() {
+    std::vector<JournalRecord> result;
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        records = 0;
+        return result;
+    }
+
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    size_t start = 0;
+    size_t eol;
+    while ((eol = content.find('\n', start)) != std::string::npos) {
+        std::string line = content.substr(start, eol - start);
+        start = eol + 1;
+        if (line.size() < 2 || line[1] != ',' || (line[0] != 'U' && line[0] != 'D')) continue;
+        result.push_back({line[0] == 'D', line.substr(2)});
+    }
+
+    // Cut a torn last line off now, before anything is appended after it
+    torn = false;
+    if (start < content.size()) {
+        file.close();
+        std::error_code ec;
+        std::filesystem::resize_file(path, start, ec);
+        torn = ec || !syncFile(path);
+    }
+
+    records = result.size();
+    return result;
+}
+
+void ChangeJournal::truncate() {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    records = 0;
+    torn = false;
+}
+
+size_t ChangeJournal::size() const {
+    return records;
+}
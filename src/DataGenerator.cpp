@@ -1,88 +1,259 @@
 // ============================================================================
 // FILE: src/DataGenerator.cpp
-// Description: Generates 1000 users and 1 admin with random data
+// Description: Generates seeded rosters of any size (users + 1 admin),
+//              in parallel and streamed straight to the CSV file
 // ============================================================================
 
 #include "common.h"
 #include "User.h"
 #include "Admin.h"
 #include "DataManager.h"
-#include "Validator.h"
+#include "DataGenerator.h"
+#include <condition_variable>
+#include <filesystem>
 
+namespace {
 
+// Hardcoded name lists
+const std::vector<std::string> firstNames = {
+    "Carl", "Noah", "Oliver", "Elijah", "William", "James", "Benjamin", 
+    "Lucas", "Henry", "Alexander", "Mason", "Michael", "Ethan", "Daniel", 
+    "Jacob", "Logan", "Jackson", "Sebastian", "Jack", "Aiden", "Owen", 
+    "Samuel", "Matthew", "Joseph", "David", "Wyatt", "Carter", "John", 
+    "Jayden", "Gabriel", "Luke", "Anthony", "Isaac", "Grayson", "Julian", 
+    "Ryan", "Levi", "Mateo", "Jaxon", "Ezra", "Aaron", "Charles", "Thomas", 
+    "Hunter", "Caleb", "Josiah", "Christian", "Andrew", "Connor", "Jeremiah",
+    "Olivia", "Emma", "Ava", "Sophia", "Isabella", "Charlotte", "Amelia", 
+    "Mia", "Harper", "Evelyn", "Abigail", "Emily", "Elizabeth", "Avery", 
+    "Sofia", "Ella", "Madison", "Scarlett", "Grace", "Chloe", "Victoria", 
+    "Penelope", "Riley", "Aria", "Layla", "Lily", "Nora", "Zoe", "Hannah", 
+    "Camila", "Stella", "Aurora", "Nova", "Willow", "Hazel", "Maya", 
+    "Skylar", "Kinsley", "Naomi", "Elena", "Ruby", "Alice", "Claire", 
+    "Lucy", "Violet", "Ivy", "Cora", "Audrey", "Anna", "Leah"
+};
 
+const std::vector<std::string> lastNames = {
+    "Smith", "Johnson", "Williams", "Brown", "Jones", "Garcia", "Rodriguez", 
+    "Martinez", "Hernandez", "Lopez", "Miller", "Wilson", "Moore", "Taylor", 
+    "Anderson", "Thomas", "Jackson", "Martin", "Lee", "Perez", "White", 
+    "Harris", "Clark", "Lewis", "Young", "Hall", "Walker", "Allen", 
+    "Sanchez", "Kelly", "Baker", "King", "Wright", "Hill", "Scott", "Green", 
+    "Adams", "Nelson", "Carter", "Mitchell", "Roberts", "Turner", "Phillips", 
+    "Campbell", "Parker", "Evans", "Edwards", "Stewart", "Collins", "Davis"
+};
 
-void generateInitialData() {
-    // Hardcoded name lists
-    std::vector<std::string> firstNames = {
-        "Carl", "Noah", "Oliver", "Elijah", "William", "James", "Benjamin", 
-        "Lucas", "Henry", "Alexander", "Mason", "Michael", "Ethan", "Daniel", 
-        "Jacob", "Logan", "Jackson", "Sebastian", "Jack", "Aiden", "Owen", 
-        "Samuel", "Matthew", "Joseph", "David", "Wyatt", "Carter", "John", 
-        "Jayden", "Gabriel", "Luke", "Anthony", "Isaac", "Grayson", "Julian", 
-        "Ryan", "Levi", "Mateo", "Jaxon", "Ezra", "Aaron", "Charles", "Thomas", 
-        "Hunter", "Caleb", "Josiah", "Christian", "Andrew", "Connor", "Jeremiah",
-        "Olivia", "Emma", "Ava", "Sophia", "Isabella", "Charlotte", "Amelia", 
-        "Mia", "Harper", "Evelyn", "Abigail", "Emily", "Elizabeth", "Avery", 
-        "Sofia", "Ella", "Madison", "Scarlett", "Grace", "Chloe", "Victoria", 
-        "Penelope", "Riley", "Aria", "Layla", "Lily", "Nora", "Zoe", "Hannah", 
-        "Camila", "Stella", "Aurora", "Nova", "Willow", "Hazel", "Maya", 
-        "Skylar", "Kinsley", "Naomi", "Elena", "Ruby", "Alice", "Claire", 
-        "Lucy", "Violet", "Ivy", "Cora", "Audrey", "Anna", "Leah"
-    };
-    
-    std::vector<std::string> lastNames = {
-        "Smith", "Johnson", "Williams", "Brown", "Jones", "Garcia", "Rodriguez", 
-        "Martinez", "Hernandez", "Lopez", "Miller", "Wilson", "Moore", "Taylor", 
-        "Anderson", "Thomas", "Jackson", "Martin", "Lee", "Perez", "White", 
-        "Harris", "Clark", "Lewis", "Young", "Hall", "Walker", "Allen", 
-        "Sanchez", "Kelly", "Baker", "King", "Wright", "Hill", "Scott", "Green", 
-        "Adams", "Nelson", "Carter", "Mitchell", "Roberts", "Turner", "Phillips", 
-        "Campbell", "Parker", "Evans", "Edwards", "Stewart", "Collins", "Davis"
-    };
-    
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> firstDist(0, firstNames.size() - 1);
-    std::uniform_int_distribution<> lastDist(0, lastNames.size() - 1);
-    std::uniform_int_distribution<> clearanceDist(0, 3);
-    
-    std::vector<std::shared_ptr<User>> users;
-    DataManager dataManager;
-    
-    // Generate 1000 users
-    std::cout << "Generating 1000 users..." << std::endl;
-    for (int i = 0; i < 1000; ++i) {
-        std::string firstName = firstNames[firstDist(gen)];
-        std::string lastName = lastNames[lastDist(gen)];
-        std::string fullName = firstName + " " + lastName;
-        
-        // Generate unique ID
-        std::string userId = dataManager.generateUniqueId(firstName, users);
-        
-        // Generate email and phone
-        std::string email = Validator::generateEmail(fullName);
-        std::string phone = Validator::generatePhone();
-        
-        // Generate card with random clearance level
-        int clearance = clearanceDist(gen);
-        std::string cardId = "CARD" + std::to_string(i + 1);
-        auto card = std::make_shared<Card>(cardId, intToClearanceLevel(clearance));
-        
-        // Create user
-        auto user = std::make_shared<User>(userId, fullName, email, phone, card);
-        users.push_back(user);
+// SplitMix64: small, fast and the same sequence on every platform (the
+// std:: distributions are allowed to differ between standard libraries)
+struct RosterRng {
+    uint64_t state;
+
+    explicit RosterRng(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    size_t below(size_t n) {
+        return static_cast<size_t>(next() % n);
+    }
+};
+
+// Independent streams per chunk: names (stream 0) are drawn apart from
+// the other fields (stream 1) so the ID pass can replay just the names
+RosterRng chunkStream(uint64_t seed, size_t chunk, uint64_t stream) {
+    RosterRng mix(seed ^ (static_cast<uint64_t>(chunk) * 0xD1B54A32D192ED03ULL));
+    mix.next();
+    return RosterRng(mix.next() ^ (stream * 0xA0761D6478BD642FULL));
+}
+
+// ID base (first 3 letters, upper case, as DataManager::generateUniqueId
+// builds it) of every first name; several names share a base
+struct IdBases {
+    std::vector<std::string> bases;
+    std::vector<size_t> baseOfFirst;
+
+    IdBases() {
+        for (const auto& first : firstNames) {
+            std::string base = first.substr(0, 3);
+            std::transform(base.begin(), base.end(), base.begin(), ::toupper);
+            auto it = std::find(bases.begin(), bases.end(), base);
+            baseOfFirst.push_back(it - bases.begin());
+            if (it == bases.end()) bases.push_back(base);
+        }
+    }
+};
+
+// Run fn(chunk) for every chunk on 'threads' threads
+template<typename F>
+void forEachChunk(size_t chunks, size_t threads, F fn) {
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t c = next++; c < chunks; c = next++) fn(c);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+// Format the rows of one chunk. 'firstSuffix' holds, per ID base, how many
+// earlier rows used that base: IDs come out exactly as a sequential run of
+// generateUniqueId would hand them out (SOF, SOF1, SOF2, ...)
+void formatChunk(const IdBases& ids, uint64_t seed, size_t chunk, size_t userCount,
+                 std::vector<uint32_t> firstSuffix, std::string& out) {
+    RosterRng names = chunkStream(seed, chunk, 0);
+    RosterRng fields = chunkStream(seed, chunk, 1);
+    size_t begin = chunk * ROSTER_CHUNK_ROWS;
+    size_t end = std::min(userCount, begin + ROSTER_CHUNK_ROWS);
+
+    out.clear();
+    for (size_t row = begin; row < end; ++row) {
+        const std::string& first = firstNames[names.below(firstNames.size())];
+        const std::string& last = lastNames[names.below(lastNames.size())];
+        size_t base = ids.baseOfFirst[&first - firstNames.data()];
+
+        // ID
+        out += ids.bases[base];
+        if (uint32_t suffix = firstSuffix[base]++) out += std::to_string(suffix);
+
+        // Name and email (Validator::generateEmail format)
+        out += ',';
+        out += first;
+        out += ' ';
+        out += last;
+        out += ',';
+        for (char c : first) out += static_cast<char>(::tolower(static_cast<unsigned char>(c)));
+        out += '.';
+        for (char c : last) out += static_cast<char>(::tolower(static_cast<unsigned char>(c)));
+        out += "@company.com,07";
+
+        // Phone, card and clearance
+        out += std::to_string(10000000 + fields.below(90000000));
+        out += ",CARD";
+        out += std::to_string(row + 1);
+        out += ',';
+        out += static_cast<char>('0' + fields.below(4));
+        out += ",USER\n";
+    }
+}
+
+} // namespace
+
+bool generateRoster(const std::string& path, size_t userCount, uint64_t seed, size_t threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    const IdBases ids;
+    const size_t bases = ids.bases.size();
+    const size_t chunks = (userCount + ROSTER_CHUNK_ROWS - 1) / ROSTER_CHUNK_ROWS;
+
+    // Pass 1: how often each chunk uses each ID base (names only)
+    std::vector<uint32_t> suffixes(chunks * bases, 0);
+    forEachChunk(chunks, threads, [&](size_t chunk) {
+        RosterRng names = chunkStream(seed, chunk, 0);
+        size_t rows = std::min(userCount - chunk * ROSTER_CHUNK_ROWS, ROSTER_CHUNK_ROWS);
+        for (size_t i = 0; i < rows; ++i) {
+            size_t first = names.below(firstNames.size());
+            names.next();  // Last name
+            ++suffixes[chunk * bases + ids.baseOfFirst[first]];
+        }
+    });
+
+    // ...turned into each chunk's first suffix per base
+    std::vector<uint32_t> running(bases, 0);
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        for (size_t b = 0; b < bases; ++b) {
+            uint32_t used = suffixes[chunk * bases + b];
+            suffixes[chunk * bases + b] = running[b];
+            running[b] += used;
+        }
+    }
+
+    // Write next to the real file and rename over it, like saveToCSV
+    const std::string tempFile = path + ".tmp";
+    std::ofstream file(tempFile);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open " << tempFile << " for writing." << std::endl;
+        return false;
     }
-    
-    // Create admin with level 3 clearance
-    std::cout << "Creating admin..." << std::endl;
     auto adminCard = std::make_shared<Card>("CARD_ADMIN", ClearanceLevel::LEVEL_3);
-    auto admin = std::make_shared<Admin>("ADMIN", "Admin User", 
-                                          "admin@company.com", "0712345678",
-                                          adminCard, ADMIN_PASSWORD);
-    
-    // Save to file
-    std::cout << "Saving to file..." << std::endl;
-    dataManager.saveToCSV(users, admin);
-    std::cout << "Data generation complete!" << std::endl;
-}
\ No newline at end of file
+    Admin admin("ADMIN", "Admin User", "admin@company.com", "0712345678",
+                adminCard, ADMIN_PASSWORD);
+    file << "ID,Name,Email,Phone,CardID,ClearanceLevel,Type,Password\n";
+    file << admin.toCSV() << '\n';
+
+    // Pass 2: workers format chunks, this thread writes them in order. At
+    // most 'window' chunks are in flight, which bounds memory.
+    const size_t window = threads * 2;
+    std::vector<std::string> done(window);
+    std::vector<uint8_t> ready(window, 0);
+    std::mutex chunkMutex;
+    std::condition_variable chunkCondition;
+    size_t nextChunk = 0;
+    size_t written = 0;
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            std::string text;
+            while (true) {
+                size_t chunk;
+                {
+                    std::unique_lock<std::mutex> lock(chunkMutex);
+                    chunkCondition.wait(lock, [&]() {
+                        return nextChunk >= chunks || nextChunk < written + window;
+                    });
+                    if (nextChunk >= chunks) return;
+                    chunk = nextChunk++;
+                }
+                formatChunk(ids, seed, chunk, userCount,
+                            std::vector<uint32_t>(suffixes.begin() + chunk * bases,
+                                                  suffixes.begin() + (chunk + 1) * bases),
+                            text);
+                {
+                    std::lock_guard<std::mutex> lock(chunkMutex);
+                    done[chunk % window].swap(text);
+                    ready[chunk % window] = 1;
+                }
+                chunkCondition.notify_all();
+            }
+        });
+    }
+
+    std::string text;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        {
+            std::unique_lock<std::mutex> lock(chunkMutex);
+            chunkCondition.wait(lock, [&]() { return ready[chunk % window] != 0; });
+            text.swap(done[chunk % window]);
+            ready[chunk % window] = 0;
+        }
+        file.write(text.data(), text.size());
+        {
+            std::lock_guard<std::mutex> lock(chunkMutex);
+            ++written;
+        }
+        chunkCondition.notify_all();
+    }
+    for (auto& worker : workers) worker.join();
+
+    file.close();
+    std::error_code ec;
+    if (file) {
+        std::filesystem::rename(tempFile, path, ec);
+    }
+    if (!file || ec) {
+        std::cerr << "Error: Could not write " << path << "." << std::endl;
+        std::filesystem::remove(tempFile, ec);
+        return false;
+    }
+    return true;
+}
+
+void generateInitialData() {
+    std::cout << "Generating " << INITIAL_USER_COUNT << " users..." << std::endl;
+    if (generateRoster(DATA_FILE, INITIAL_USER_COUNT, std::random_device{}())) {
+        std::cout << "Data generation complete!" << std::endl;
+    }
+}
@@ -3,101 +3,456 @@
 // ============================================================================
 
 #include "DataManager.h"
+#include "FileSync.h"
+#include "MappedFile.h"
+#include "Metrics.h"
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <string_view>
 
-void DataManager::loadFromCSV(std::vector<std::shared_ptr<User>>& users,
-                               std::shared_ptr<Admin>& admin) {
-    std::lock_guard<std::mutex> lock(dataMutex);
-    std::ifstream file(DATA_FILE);
-    
-    if (!file.is_open()) {
-        std::cout << "No existing data file found. Starting fresh." << std::endl;
+namespace {
+
+// Rows parsed from one newline-aligned slice of the file, as field views
+// for loading into a UserStore. Unquoted fields point into the mapped file;
+// unescaped quoted ones into 'unescaped', which never moves its strings.
+struct RowChunk {
+    struct Row {
+        std::string_view fields[5];  // ID, name, email, phone, card ID
+        int clearance;
+    };
+    std::vector<Row> rows;
+    std::deque<std::string> unescaped;
+    std::shared_ptr<Admin> admin;  // Last admin row in the chunk, if any
+};
+
+// Files smaller than this are parsed on the calling thread
+const size_t PARALLEL_LOAD_MIN_BYTES = 1 << 20;
+
+// How far ahead of UserStore::add the loader prefetches index slots
+const size_t LOAD_PREFETCH_ROWS = 8;
+
+// Rows are sized up front from the chunk's bytes; real rows run ~70 bytes
+const size_t MIN_ROW_BYTES = 48;
+
+// Split an unquoted line on commas without copying. Fields past maxFields
+// are dropped, as the getline loader ignored everything after the password
+size_t splitFields(std::string_view line, std::string_view* fields, size_t maxFields) {
+    size_t count = 0;
+    size_t start = 0;
+    while (count < maxFields) {
+        size_t comma = line.find(',', start);
+        if (comma == std::string_view::npos) {
+            fields[count++] = line.substr(start);
+            break;
+        }
+        fields[count++] = line.substr(start, comma - start);
+        start = comma + 1;
+    }
+    return count;
+}
+
+// Plain "0".."3" is the common case; anything else goes through stoi
+int parseClearance(std::string_view field) {
+    if (field.size() == 1 && field[0] >= '0' && field[0] <= '9') {
+        return field[0] - '0';
+    }
+    return std::stoi(std::string(field));
+}
+
+std::shared_ptr<Admin> makeAdmin(const std::string_view* fields, int clearance) {
+    auto card = std::make_shared<Card>(std::string(fields[4]), intToClearanceLevel(clearance));
+    return std::make_shared<Admin>(std::string(fields[0]), std::string(fields[1]),
+                                   std::string(fields[2]), std::string(fields[3]),
+                                   card, std::string(fields[7]));
+}
+
+// Keep one row (or the admin), same rules as the line-by-line loader
+void addRow(RowChunk& chunk, const std::string_view* fields, size_t count) {
+    if (count < 7) return;
+
+    int clearance = parseClearance(fields[5]);
+    if (fields[6] == "ADMIN" && count >= 8) {
+        chunk.admin = makeAdmin(fields, clearance);
         return;
     }
-    
-    std::string line;
-    // Skip header if exists
-    std::getline(file, line);
-    
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        
-        auto fields = parseCSVLine(line);
-        if (fields.size() < 7) continue;
-        
-        std::string id = fields[0];
-        std::string name = fields[1];
-        std::string email = fields[2];
-        std::string phone = fields[3];
-        std::string cardId = fields[4];
-        int clearance = std::stoi(fields[5]);
-        std::string type = fields[6];
-        
-        auto card = std::make_shared<Card>(cardId, intToClearanceLevel(clearance));
-        
-        if (type == "ADMIN" && fields.size() >= 8) {
-            std::string password = fields[7];
-            admin = std::make_shared<Admin>(id, name, email, phone, card, password);
+    chunk.rows.push_back({{fields[0], fields[1], fields[2], fields[3], fields[4]}, clearance});
+}
+
+// Unescaped text of a quoted row, owned by the chunk that keeps views of it
+std::string_view retainField(RowChunk& chunk, const std::string& text) {
+    chunk.unescaped.push_back(text);
+    return chunk.unescaped.back();
+}
+
+// Parse the rows in [begin, end); quoted lines fall back to parseCSVLine
+void parseCSVChunk(DataManager& parser, const char* begin, const char* end, RowChunk& chunk) {
+    // Rows are line-delimited, as with getline: quote state never spans lines
+    chunk.rows.reserve((end - begin) / MIN_ROW_BYTES);
+    std::string_view fields[8];
+    const char* line = begin;
+    while (line < end) {
+        const char* eol = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        if (!eol) eol = end;
+
+        std::string_view row(line, eol - line);
+        if (!row.empty() && row.back() == '\r') row.remove_suffix(1);  // CRLF files
+        line = eol + 1;
+        if (row.empty()) continue;
+
+        if (row.find('"') == std::string_view::npos) {
+            addRow(chunk, fields, splitFields(row, fields, 8));
         } else {
-            users.push_back(std::make_shared<User>(id, name, email, phone, card));
+            // Quoted fields need unescaping, use the string parser
+            auto parsed = parser.parseCSVLine(std::string(row));
+            size_t count = std::min<size_t>(parsed.size(), 8);
+            for (size_t i = 0; i < count; ++i) fields[i] = retainField(chunk, parsed[i]);
+            addRow(chunk, fields, count);
         }
     }
-    
-    file.close();
-    std::cout << "Loaded " << users.size() << " users and " 
-              << (admin ? "1" : "0") << " admin from file." << std::endl;
 }
 
-void DataManager::saveToCSV(const std::vector<std::shared_ptr<User>>& users,
-                             const std::shared_ptr<Admin>& admin) {
-    std::lock_guard<std::mutex> lock(dataMutex);
-    std::ofstream file(DATA_FILE);
+// Parse the mapped data file in newline-aligned chunks, one per worker
+// thread (the first on this thread); chunks come back in file order
+std::vector<RowChunk> parseDataFile(DataManager& parser, const MappedFile& file) {
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+
+    // Skip header if exists
+    const char* headerEnd = static_cast<const char*>(std::memchr(begin, '\n', file.size()));
+    begin = headerEnd ? headerEnd + 1 : end;
+
+    // Cut the body into newline-aligned chunks, one per worker thread
+    size_t bodySize = end - begin;
+    size_t workers = 1;
+    if (bodySize >= PARALLEL_LOAD_MIN_BYTES) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<const char*> cuts = {begin};
+    for (size_t i = 1; i < workers; ++i) {
+        const char* cut = std::max(begin + bodySize * i / workers, cuts.back());
+        const char* eol = static_cast<const char*>(std::memchr(cut, '\n', end - cut));
+        cuts.push_back(eol ? eol + 1 : end);
+    }
+    cuts.push_back(end);
+
+    std::vector<RowChunk> chunks(workers);
+    std::vector<std::future<void>> pending;
+    for (size_t i = 1; i < workers; ++i) {
+        pending.push_back(std::async(std::launch::async, [&parser, &cuts, &chunks, i]() {
+            parseCSVChunk(parser, cuts[i], cuts[i + 1], chunks[i]);
+        }));
+    }
+    parseCSVChunk(parser, cuts[0], cuts[1], chunks[0]);
+    for (auto& task : pending) {
+        task.get();  // Rethrows parse errors
+    }
+    return chunks;
+}
+
+// Write the CSV next to the real file and rename over it, so a crash
+// mid-save never leaves a truncated users.csv behind; it is on the device
+// before this returns true. writeUsers emits one line per user.
+template <typename WriteUsers>
+bool writeDataFile(const std::shared_ptr<Admin>& admin, WriteUsers writeUsers) {
+    const std::string tempFile = DATA_FILE + ".tmp";
+    std::ofstream file(tempFile);
     
     if (!file.is_open()) {
         std::cerr << "Error: Could not open file for writing." << std::endl;
-        return;
+        return false;
     }
     
     // Write header
-    file << "ID,Name,Email,Phone,CardID,ClearanceLevel,Type,Password" << std::endl;
+    file << "ID,Name,Email,Phone,CardID,ClearanceLevel,Type,Password\n";
     
     // Write admin first
     if (admin) {
-        file << admin->toCSV() << std::endl;
+        file << admin->toCSV() << '\n';
     }
     
     // Write all users
-    for (const auto& user : users) {
-        file << user->toCSV() << std::endl;
-    }
+    writeUsers(file);
     
     file.close();
+    if (!file) std::remove(tempFile.c_str());
+    if (!file || !replaceFile(tempFile, DATA_FILE)) {
+        std::cerr << "Error: Could not write " << DATA_FILE << "." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Size and modification time of the CSV file, ties a snapshot to it
+bool csvStamp(uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    auto fileSize = std::filesystem::file_size(DATA_FILE, ec);
+    if (ec) return false;
+    auto writeTime = std::filesystem::last_write_time(DATA_FILE, ec);
+    if (ec) return false;
+    size = fileSize;
+    mtime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+// Regenerate the snapshot for whatever the CSV file holds now
+void writeSnapshot(const UserStore& users, const std::shared_ptr<Admin>& admin) {
+    uint64_t size;
+    int64_t mtime;
+    if (!csvStamp(size, mtime) || !UserSnapshot::write(SNAPSHOT_FILE, users, admin, size, mtime)) {
+        std::cerr << "Warning: Could not write snapshot " << SNAPSHOT_FILE << std::endl;
+    }
+}
+
+Histogram& csvLoadTime() {
+    static Histogram& histogram = MetricsRegistry::global().histogram(
+        "scs_csv_load_seconds", "DataManager::loadFromCSV duration");
+    return histogram;
+}
+
+Histogram& csvSaveTime() {
+    static Histogram& histogram = MetricsRegistry::global().histogram(
+        "scs_csv_save_seconds", "DataManager::saveToCSV duration");
+    return histogram;
+}
+
+} // namespace
+
+DataManager::DataManager() : unreservedStore(nullptr), journal(JOURNAL_FILE) {}
+
+void DataManager::loadFromCSV(UserStore& users, std::shared_ptr<Admin>& admin) {
+    ScopedTimer timer(csvLoadTime());
+    std::lock_guard<std::mutex> lock(dataMutex);
+    MappedFile file;
+
+    if (!file.open(DATA_FILE)) {
+        std::cout << "No existing data file found. Starting fresh." << std::endl;
+        return;
+    }
+
+    // Workers only split rows; appending to the store is sequential, in
+    // file order, while the views into the mapping are still valid
+    std::vector<RowChunk> chunks = parseDataFile(*this, file);
+    size_t total = users.size();
+    for (const auto& chunk : chunks) total += chunk.rows.size();
+    users.reserve(total);
+    size_t rejected = 0;
+    for (const auto& chunk : chunks) {
+        const auto& rows = chunk.rows;
+        for (size_t i = 0; i < rows.size(); ++i) {
+            // The index probes are cache misses at this size; start them early
+            if (i + LOAD_PREFETCH_ROWS < rows.size()) {
+                const auto& ahead = rows[i + LOAD_PREFETCH_ROWS];
+                users.prefetch(ahead.fields[0], ahead.fields[1]);
+            }
+            const auto& row = rows[i];
+            UserHandle user = users.add(row.fields[0], row.fields[1], row.fields[2], row.fields[3],
+                                        row.fields[4], intToClearanceLevel(row.clearance), false);
+            if (user == NO_USER) ++rejected;  // A field too long to store
+        }
+        if (chunk.admin) admin = chunk.admin;
+    }
+
+    chunks.clear();
+    file.close();
+
+    // The store's IDs go into the allocator the first time one is needed
+    unreservedIds.reset();
+    unreservedStore = &users;
+    deferredReleases.clear();
+    idAllocator.clear();
+    if (admin) {
+        idAllocator.reserve(admin->getId());
+    }
+
+    std::cout << "Loaded " << users.size() << " users and " 
+              << (admin ? "1" : "0") << " admin from file." << std::endl;
+    if (rejected > 0) {
+        std::cerr << "Warning: Skipped " << rejected << " row(s) with an over-long field." << std::endl;
+    }
+}
+
+bool DataManager::saveToCSV(const UserStore& users, const std::shared_ptr<Admin>& admin) {
+    ScopedTimer timer(csvSaveTime());
+    std::lock_guard<std::mutex> lock(dataMutex);
+
+    // Rows go straight from the pool to the stream, no per-row strings
+    bool written = writeDataFile(admin, [&](std::ofstream& file) {
+        users.forEach([&](UserHandle user) {
+            users.writeCSV(file, user);
+            file << '\n';
+        });
+    });
+    if (!written) return false;
+
+    writeSnapshot(users, admin);
     std::cout << "\n[SAVED] Data saved to " << DATA_FILE << " at " 
               << getCurrentTimestamp() << std::endl;
+    return true;
+}
+
+std::shared_ptr<UserSnapshot> DataManager::openSnapshot() {
+    std::lock_guard<std::mutex> lock(dataMutex);
+
+    uint64_t size;
+    int64_t mtime;
+    auto snapshot = std::make_shared<UserSnapshot>();
+    if (!csvStamp(size, mtime) || !snapshot->open(SNAPSHOT_FILE) || !snapshot->matchesCsv(size, mtime)) {
+        return nullptr;
+    }
+
+    // IDs go into the allocator the first time one is needed
+    idAllocator.clear();
+    unreservedIds = snapshot;
+    unreservedStore = nullptr;
+    deferredReleases.clear();
+
+    std::cout << "Mapped " << snapshot->userCount() << " users and "
+              << (snapshot->hasAdmin() ? "1" : "0") << " admin from snapshot." << std::endl;
+    return snapshot;
+}
+
+void DataManager::saveSnapshot(const UserStore& users, const std::shared_ptr<Admin>& admin) {
+    std::lock_guard<std::mutex> lock(dataMutex);
+    writeSnapshot(users, admin);
+}
+
+void DataManager::reservePendingIds() {
+    if (unreservedIds) {
+        size_t rows = unreservedIds->userCount() + (unreservedIds->hasAdmin() ? 1 : 0);
+        idAllocator.reserveCapacity(rows);
+        for (size_t row = 0; row < rows; ++row) {
+            idAllocator.reserve(std::string(unreservedIds->field(row, COL_ID)));
+        }
+        unreservedIds.reset();
+    } else if (unreservedStore) {
+        // Users removed since the load are already gone from the store
+        idAllocator.reserveCapacity(unreservedStore->size() + 1);
+        unreservedStore->forEach([&](UserHandle user) {
+            idAllocator.reserve(std::string(unreservedStore->getId(user)));
+        });
+        unreservedStore = nullptr;
+    } else {
+        return;
+    }
+
+    for (const auto& id : deferredReleases) {
+        idAllocator.release(id);
+    }
+    deferredReleases.clear();
+}
+
+bool DataManager::appendToJournal(const std::vector<JournalRecord>& changes) {
+    static Histogram& appendTime = MetricsRegistry::global().histogram(
+        "scs_journal_append_seconds", "DataManager::appendToJournal duration");
+    ScopedTimer timer(appendTime);
+    std::lock_guard<std::mutex> lock(dataMutex);
+    if (!journal.append(changes)) {
+        std::cerr << "Error: Could not append to " << JOURNAL_FILE << std::endl;
+        return false;
+    }
+
+    std::cout << "\n[SAVED] " << changes.size()
+              << " change(s) journaled to " << JOURNAL_FILE << " at "
+              << getCurrentTimestamp() << std::endl;
+    return true;
+}
+
+std::vector<JournalRecord> DataManager::readJournal() {
+    std::lock_guard<std::mutex> lock(dataMutex);
+    return journal.read();
+}
+
+bool DataManager::journalNeedsCompaction(size_t userCount) const {
+    return journal.size() >= std::max(JOURNAL_COMPACT_MIN, userCount / 8);
 }
 
-std::string DataManager::generateUniqueId(const std::string& baseName,
-                                          const std::vector<std::shared_ptr<User>>& users) {
+void DataManager::compact(const UserStore& users, const std::shared_ptr<Admin>& admin) {
+    // CSV + snapshot first, synced to the device: if we crash before the
+    // truncate, replaying the journal again is harmless (upserts and
+    // deletes are idempotent), and the truncate can't reach the disk
+    // ahead of the rows it drops
+    if (saveToCSV(users, admin)) {
+        clearJournal();
+    }
+}
+
+bool DataManager::saveFloorExceptions(const std::vector<FloorException>& exceptions) {
+    std::lock_guard<std::mutex> lock(dataMutex);
+
+    // Same write-then-rename as the data file
+    const std::string tempFile = EXCEPTIONS_FILE + ".tmp";
+    std::ofstream file(tempFile);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open " << tempFile << " for writing." << std::endl;
+        return false;
+    }
+    file << "FloorID,List,EmployeeID\n";
+    for (const auto& exception : exceptions) {
+        file << escapeCSV(exception.floorId) << ',' << (exception.allowed ? "allow" : "deny")
+             << ',' << escapeCSV(exception.userId) << '\n';
+    }
+
+    file.close();
+    if (!file) std::remove(tempFile.c_str());
+    if (!file || !replaceFile(tempFile, EXCEPTIONS_FILE)) {
+        std::cerr << "Error: Could not write " << EXCEPTIONS_FILE << "." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::vector<FloorException> DataManager::loadFloorExceptions() {
+    std::lock_guard<std::mutex> lock(dataMutex);
+
+    std::vector<FloorException> exceptions;
+    std::ifstream file(EXCEPTIONS_FILE);
+    std::string line;
+    if (!std::getline(file, line)) return exceptions;  // No file, or just the header
+
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        auto fields = parseCSVLine(line);
+        if (fields.size() < 3 || (fields[1] != "allow" && fields[1] != "deny")) {
+            continue;
+        }
+        exceptions.push_back({fields[0], fields[2], fields[1] == "allow"});
+    }
+    return exceptions;
+}
+
+void DataManager::clearJournal() {
+    std::lock_guard<std::mutex> lock(dataMutex);
+    journal.truncate();
+}
+
+std::string DataManager::generateUniqueId(const std::string& baseName) {
+    reservePendingIds();
+
     // Create alphanumeric ID from name
     std::string baseId = baseName.substr(0, 3);
     std::transform(baseId.begin(), baseId.end(), baseId.begin(), ::toupper);
-    
-    // Check for duplicates and add suffix
-    int suffix = 1;
-    std::string newId = baseId;
-    
-    bool exists = true;
-    while (exists) {
-        exists = false;
-        for (const auto& user : users) {
-            if (user->getId() == newId) {
-                exists = true;
-                newId = baseId + std::to_string(suffix++);
-                break;
-            }
-        }
+
+    // Lowest free of BASE, BASE1, BASE2, ...
+    return idAllocator.allocate(baseId);
+}
+
+void DataManager::releaseId(const std::string& id) {
+    // Keep startup lazy: don't pull in every loaded ID just to free one
+    if (unreservedIds || unreservedStore) {
+        deferredReleases.push_back(id);
+        return;
     }
-    
-    return newId;
+    idAllocator.release(id);
+}
+
+void DataManager::reserveId(const std::string& id) {
+    // A pending release of the same ID is superseded
+    deferredReleases.erase(std::remove(deferredReleases.begin(), deferredReleases.end(), id),
+                           deferredReleases.end());
+    idAllocator.reserve(id);
 }
 
 std::vector<std::string> DataManager::parseCSVLine(const std::string& line) {
@@ -0,0 +1,52 @@
+// ============================================================================
+// FILE: src/FileSync.cpp
+// ============================================================================
+
+#include "FileSync.h"
+#include <filesystem>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+bool syncFile(const std::string& path) {
+#ifdef _WIN32
+    int fd = _open(path.c_str(), _O_RDWR | _O_BINARY);
+    if (fd < 0) return false;
+    bool synced = _commit(fd) == 0;
+    _close(fd);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool synced = fdatasync(fd) == 0;
+    ::close(fd);
+#endif
+    return synced;
+}
+
+bool syncDirectory(const std::string& path) {
+#ifdef _WIN32
+    (void)path;  // Directories can't be opened for a sync here
+    return true;
+#else
+    int fd = ::open(path.empty() ? "." : path.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool synced = fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#endif
+}
+
+bool replaceFile(const std::string& tempPath, const std::string& path) {
+    std::error_code ec;
+    if (syncFile(tempPath)) {
+        std::filesystem::rename(tempPath, path, ec);  // Replaces the old file on every platform
+        if (!ec) return syncDirectory(std::filesystem::path(path).parent_path().string());
+    }
+    std::remove(tempPath.c_str());
+    return false;
+}
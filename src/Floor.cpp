@@ -4,35 +4,102 @@
 #include "Floor.h"
 
 Floor::Floor(const std::string& floorId, const std::string& floorName,
-             ClearanceLevel clearance)
-    : id(floorId), name(floorName), requiredClearance(clearance) {}
+             ClearanceLevel clearance, size_t historyLimit)
+    : id(floorId), name(floorName), schedule(clearance), accessHistory(historyLimit),
+      auditLog(nullptr), grantedCount(&accessCounter(id, true)),
+      deniedCount(&accessCounter(id, false)) {}
+
+Counter& Floor::accessCounter(const std::string& floorId, bool granted) {
+    return MetricsRegistry::global().counter(
+        "scs_access_total", "Access attempts by floor and outcome",
+        "floor=\"" + floorId + "\",result=\"" + (granted ? "granted" : "denied") + "\"");
+}
 
 std::string Floor::getId() const { return id; }
 std::string Floor::getName() const { return name; }
-ClearanceLevel Floor::getRequiredClearance() const { return requiredClearance; }
-const std::vector<AccessAttempt>& Floor::getAccessHistory() const { return accessHistory; }
+ClearanceLevel Floor::getRequiredClearance() const { return schedule.getBaseLevel(); }
+ClearanceLevel Floor::getRequiredClearanceAt(int64_t epochSeconds) const {
+    return schedule.levelAtTime(epochSeconds);
+}
+const AccessSchedule& Floor::getSchedule() const { return schedule; }
+const AccessLog& Floor::getAccessHistory() const { return accessHistory; }
+const RoaringBitmap& Floor::getAllowList() const { return allowList; }
+const RoaringBitmap& Floor::getDenyList() const { return denyList; }
 
 void Floor::setName(const std::string& newName) { name = newName; }
-void Floor::setRequiredClearance(ClearanceLevel clearance) { requiredClearance = clearance; }
+void Floor::setRequiredClearance(ClearanceLevel clearance) { schedule.setBaseLevel(clearance); }
+void Floor::setHistoryLimit(size_t maxRecords) { accessHistory.setCapacity(maxRecords); }
+void Floor::setAuditLog(AuditLog* log) { auditLog = log; }
 
 bool Floor::attemptAccess(const User& user) {
-    // Check if user's clearance level is sufficient
-    bool authorized = user.getCard()->getClearanceLevelInt() >= 
-                     clearanceLevelToInt(requiredClearance);
-    
-    // Log the access attempt
-    AccessAttempt attempt;
-    attempt.employeeId = user.getId();
-    attempt.employeeName = user.getName();
-    attempt.timestamp = getCurrentTimestamp();
-    attempt.authorized = authorized;
+    return attemptAccess(user.getId(), user.getName(), user.getCard()->getClearanceLevel());
+}
+
+void Floor::addScheduleRule(const ScheduleRule& rule) { schedule.addRule(rule); }
+
+bool Floor::replaceScheduleRule(size_t index, const ScheduleRule& rule) {
+    return schedule.replaceRule(index, rule);
+}
+
+bool Floor::removeScheduleRule(size_t index) { return schedule.removeRule(index); }
+
+void Floor::allowUsers(const RoaringBitmap& users) {
+    denyList.subtract(users);
+    allowList.unionWith(users);
+}
+
+void Floor::denyUsers(const RoaringBitmap& users) {
+    allowList.subtract(users);
+    denyList.unionWith(users);
+}
+
+void Floor::clearExceptions(const RoaringBitmap& users) {
+    allowList.subtract(users);
+    denyList.subtract(users);
+}
+
+void Floor::remapUsers(const std::vector<UserHandle>& remap) {
+    allowList.remap(remap);
+    denyList.remap(remap);
+    accessHistory.remapUsers(remap);
+}
+
+bool Floor::isAuthorized(UserHandle user, ClearanceLevel clearance, int64_t epochSeconds,
+                         ClearanceLevel minimum) const {
+    int level = clearanceLevelToInt(clearance);
+    bool floorOk = level >= clearanceLevelToInt(schedule.levelAtTime(epochSeconds)) ||
+                   allowList.contains(user);
+    return floorOk && level >= clearanceLevelToInt(minimum) && !denyList.contains(user);
+}
+
+bool Floor::attemptAccess(const std::string& userId, const std::string& userName,
+                          ClearanceLevel clearance) {
+    return attemptAccess(NO_USER, userId, userName, clearance);
+}
+
+bool Floor::attemptAccess(UserHandle user, const std::string& userId, const std::string& userName,
+                          ClearanceLevel clearance) {
+    return attemptAccess(user, userId, userName, clearance, ClearanceLevel::LEVEL_0, id);
+}
+
+bool Floor::attemptAccess(UserHandle user, const std::string& userId, const std::string& userName,
+                          ClearanceLevel clearance, ClearanceLevel minimum,
+                          const std::string& doorId) {
+    // Clearance level at this minute, then this floor's exceptions for the user
+    int64_t now = getCurrentEpochSeconds();
+    bool authorized = isAuthorized(user, clearance, now, minimum);
     
-    accessHistory.push_back(attempt);
+    // Log the access attempt (fixed-size record, formatted only on display)
+    accessHistory.record(user, authorized, now);
+    if (auditLog) {
+        auditLog->append(makeAuditRecord(doorId, userId, authorized, now));
+    }
     
+    (authorized ? grantedCount : deniedCount)->add();
     return authorized;
 }
 
-void Floor::displayAccessHistory() const {
+void Floor::displayAccessHistory(const UserLookup& lookup) const {
     std::cout << "\n=== Access History for " << name << " ===" << std::endl;
     std::cout << std::left << std::setw(15) << "Employee ID" 
               << std::setw(25) << "Name" 
@@ -40,10 +107,5 @@ void Floor::displayAccessHistory() const {
               << "Status" << std::endl;
     std::cout << std::string(80, '-') << std::endl;
     
-    for (const auto& attempt : accessHistory) {
-        std::cout << std::left << std::setw(15) << attempt.employeeId
-                  << std::setw(25) << attempt.employeeName
-                  << std::setw(22) << attempt.timestamp
-                  << (attempt.authorized ? "AUTHORIZED" : "DENIED") << std::endl;
-    }
+    accessHistory.display(lookup);
 }
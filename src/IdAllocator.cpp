@@ -0,0 +1,59 @@
+// ============================================================================
+// FILE: src/IdAllocator.cpp
+// ============================================================================
+
+#include "IdAllocator.h"
+
+void IdAllocator::clear() {
+    taken.clear();
+    nextSuffix.clear();
+}
+
+void IdAllocator::reserveCapacity(size_t count) {
+    taken.reserve(count);
+}
+
+void IdAllocator::reserve(const std::string& id) {
+    taken.insert(id);
+}
+
+void IdAllocator::release(const std::string& id) {
+    if (taken.erase(id) == 0) return;
+
+    // The ID may be PREFIX + suffix for any split of its trailing digits;
+    // rewind the counter of every known prefix it could belong to
+    for (size_t split = id.size(); split > 0 && std::isdigit(static_cast<unsigned char>(id[split - 1])); --split) {
+        std::string digits = id.substr(split - 1);
+        if (digits[0] == '0' || digits.size() > 9) continue;
+
+        auto it = nextSuffix.find(id.substr(0, split - 1));
+        if (it != nextSuffix.end()) {
+            it->second = std::min(it->second, std::stoi(digits));
+        }
+    }
+}
+
+std::string IdAllocator::allocate(const std::string& prefix) {
+    // Bare prefix first, then PREFIX1, PREFIX2, ...
+    if (taken.insert(prefix).second) {
+        return prefix;
+    }
+
+    // The counter only moves forward between releases, so each suffix is
+    // probed at most once per allocation sequence
+    int& suffix = nextSuffix.emplace(prefix, 1).first->second;
+    while (true) {
+        std::string candidate = prefix + std::to_string(suffix++);
+        if (taken.insert(candidate).second) {
+            return candidate;
+        }
+    }
+}
+
+bool IdAllocator::contains(const std::string& id) const {
+    return taken.count(id) != 0;
+}
+
+size_t IdAllocator::size() const {
+    return taken.size();
+}
@@ -0,0 +1,106 @@
+// ============================================================================
+// FILE: src/LatencyHistogram.cpp
+// ============================================================================
+
+#include "LatencyHistogram.h"
+#include <cmath>
+
+// Values below 2 * SUB_BUCKETS get a bucket each. Above that, a value whose
+// highest set bit is b keeps its top SUB_BUCKET_BITS + 1 bits: the shift
+// (b - SUB_BUCKET_BITS) picks the power-of-two range, the kept bits the
+// sub-bucket within it.
+static const size_t HALF = LatencyHistogram::SUB_BUCKETS;
+static const size_t BUCKETS = (64 - LatencyHistogram::SUB_BUCKET_BITS) * HALF + HALF;
+
+size_t LatencyHistogram::bucketOf(uint64_t value) {
+    if (value < 2 * HALF) return static_cast<size_t>(value);
+#if defined(__GNUC__)
+    int highest = 63 - __builtin_clzll(value);
+#else
+    int highest = 63;
+    while (!(value >> highest)) --highest;
+#endif
+    int shift = highest - SUB_BUCKET_BITS;
+    return static_cast<size_t>(shift) * HALF + static_cast<size_t>(value >> shift);
+}
+
+LatencyHistogram::LatencyHistogram()
+    : counts(BUCKETS, 0), total(0), minValue(UINT64_MAX), maxValue(0), sum(0) {}
+
+void LatencyHistogram::record(uint64_t value, uint64_t count) {
+    counts[bucketOf(value)] += count;
+    total += count;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+    sum += static_cast<long double>(value) * count;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    sum += other.sum;
+}
+
+void LatencyHistogram::clear() {
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    minValue = UINT64_MAX;
+    maxValue = 0;
+    sum = 0;
+}
+
+uint64_t LatencyHistogram::count() const {
+    return total;
+}
+
+uint64_t LatencyHistogram::min() const {
+    return total ? minValue : 0;
+}
+
+uint64_t LatencyHistogram::max() const {
+    return maxValue;
+}
+
+double LatencyHistogram::mean() const {
+    return total ? static_cast<double>(sum / total) : 0.0;
+}
+
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const {
+    if (total == 0) return 0;
+    percentile = std::min(100.0, std::max(0.0, percentile));
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * total));
+    rank = std::max<uint64_t>(1, rank);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(bucketHighest(i), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+size_t LatencyHistogram::bucketCount() const {
+    return BUCKETS;
+}
+
+uint64_t LatencyHistogram::bucketLowest(size_t bucket) const {
+    if (bucket < 2 * HALF) return bucket;
+    size_t shift = bucket / HALF - 1;
+    return static_cast<uint64_t>(bucket - shift * HALF) << shift;
+}
+
+uint64_t LatencyHistogram::bucketHighest(size_t bucket) const {
+    if (bucket < 2 * HALF) return bucket;
+    size_t shift = bucket / HALF - 1;
+    return bucketLowest(bucket) + ((uint64_t(1) << shift) - 1);
+}
+
+uint64_t LatencyHistogram::bucketTotal(size_t bucket) const {
+    return counts[bucket];
+}
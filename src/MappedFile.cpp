@@ -0,0 +1,74 @@
+// ============================================================================
+// FILE: src/MappedFile.cpp
+// ============================================================================
+
+#include "MappedFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : bytes(nullptr), length(0) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    bytes = buffer.data();
+    length = buffer.size();
+    return true;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            length = 0;
+            return false;
+        }
+        madvise(mapping, length, MADV_SEQUENTIAL);
+        bytes = static_cast<const char*>(mapping);
+    } else {
+        bytes = "";  // Empty file: valid, nothing mapped
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    buffer.clear();
+#else
+    if (bytes && length > 0) {
+        munmap(const_cast<char*>(bytes), length);
+    }
+#endif
+    bytes = nullptr;
+    length = 0;
+}
+
+bool MappedFile::isOpen() const { return bytes != nullptr; }
+const char* MappedFile::data() const { return bytes; }
+size_t MappedFile::size() const { return length; }
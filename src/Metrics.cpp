@@ -0,0 +1,197 @@
+// ============================================================================
+// FILE: src/Metrics.cpp
+// ============================================================================
+
+#include "Metrics.h"
+#include <cstring>
+#include <filesystem>
+
+// Histogram buckets exported as 'le' bounds: 256 ns .. 2^36 ns (~69 s);
+// smaller values are still in the cumulative counts, larger only in +Inf
+static const size_t EXPORT_FIRST_BUCKET = 8;
+static const size_t EXPORT_LAST_BUCKET = 36;
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& cell : cells) {
+        total += cell.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Gauge::set(double value) {
+    uint64_t raw;
+    std::memcpy(&raw, &value, sizeof(raw));
+    bits.store(raw, std::memory_order_relaxed);
+}
+
+double Gauge::value() const {
+    uint64_t raw = bits.load(std::memory_order_relaxed);
+    double value;
+    std::memcpy(&value, &raw, sizeof(value));
+    return value;
+}
+
+uint64_t Histogram::bucketCount(size_t bucket) const {
+    uint64_t total = 0;
+    for (const auto& cell : cells) {
+        total += cell.buckets[bucket].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t Histogram::count() const {
+    uint64_t total = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+        total += bucketCount(b);
+    }
+    return total;
+}
+
+uint64_t Histogram::sumNs() const {
+    uint64_t total = 0;
+    for (const auto& cell : cells) {
+        total += cell.sumNs.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+MetricsRegistry::~MetricsRegistry() {
+    stopDumping();
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Series& MetricsRegistry::findOrAdd(const std::string& name, const std::string& help,
+                                                    Type type, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    Family*& family = familyByName[name];
+    if (!family) {
+        families.push_back(Family{name, help, type, {}, {}});
+        family = &families.back();
+    }
+    if (family->type != type) {
+        // A name can only have one type; hand back a detached series
+        std::cerr << "Warning: metric " << name << " registered with two types." << std::endl;
+        static std::deque<Series> orphans;
+        orphans.emplace_back();
+        Series& orphan = orphans.back();
+        orphan.counter.reset(new Counter());
+        orphan.gauge.reset(new Gauge());
+        orphan.histogram.reset(new Histogram());
+        return orphan;
+    }
+
+    Series*& found = family->seriesByLabels[labels];
+    if (found) return *found;
+    family->series.emplace_back();
+    Series& series = family->series.back();
+    series.labels = labels;
+    found = &series;
+    if (type == Type::COUNTER) series.counter.reset(new Counter());
+    if (type == Type::GAUGE) series.gauge.reset(new Gauge());
+    if (type == Type::HISTOGRAM) series.histogram.reset(new Histogram());
+    return series;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help,
+                                  const std::string& labels) {
+    return *findOrAdd(name, help, Type::COUNTER, labels).counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help,
+                              const std::string& labels) {
+    return *findOrAdd(name, help, Type::GAUGE, labels).gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                      const std::string& labels) {
+    return *findOrAdd(name, help, Type::HISTOGRAM, labels).histogram;
+}
+
+// name{labels} / name{labels,extra}
+static std::string seriesName(const std::string& name, const std::string& labels,
+                              const std::string& extra = "") {
+    std::string all = labels;
+    if (!extra.empty()) all += (all.empty() ? "" : ",") + extra;
+    return all.empty() ? name : name + "{" + all + "}";
+}
+
+void MetricsRegistry::writePrometheus(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& family : families) {
+        const char* type = family.type == Type::COUNTER ? "counter"
+                         : family.type == Type::GAUGE ? "gauge" : "histogram";
+        out << "# HELP " << family.name << " " << family.help << "\n";
+        out << "# TYPE " << family.name << " " << type << "\n";
+
+        for (const auto& series : family.series) {
+            if (family.type == Type::COUNTER) {
+                out << seriesName(family.name, series.labels) << " " << series.counter->value() << "\n";
+            } else if (family.type == Type::GAUGE) {
+                out << seriesName(family.name, series.labels) << " " << series.gauge->value() << "\n";
+            } else {
+                const Histogram& h = *series.histogram;
+                uint64_t cumulative = 0;
+                for (size_t b = 0; b <= EXPORT_LAST_BUCKET; ++b) {
+                    cumulative += h.bucketCount(b);
+                    if (b < EXPORT_FIRST_BUCKET) continue;
+                    std::ostringstream le;
+                    le << "le=\"" << static_cast<double>(uint64_t(1) << b) / 1e9 << "\"";
+                    out << seriesName(family.name + "_bucket", series.labels, le.str())
+                        << " " << cumulative << "\n";
+                }
+                uint64_t total = h.count();
+                out << seriesName(family.name + "_bucket", series.labels, "le=\"+Inf\"")
+                    << " " << total << "\n";
+                out << seriesName(family.name + "_sum", series.labels) << " "
+                    << static_cast<double>(h.sumNs()) / 1e9 << "\n";
+                out << seriesName(family.name + "_count", series.labels) << " " << total << "\n";
+            }
+        }
+    }
+}
+
+bool MetricsRegistry::writeFile(const std::string& path) const {
+    const std::string tempFile = path + ".tmp";
+    {
+        std::ofstream file(tempFile);
+        if (!file) return false;
+        writePrometheus(file);
+        if (!file) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempFile, path, ec);  // Scrapers never see a half-written file
+    return !ec;
+}
+
+bool MetricsRegistry::startDumping(const std::string& path, std::chrono::seconds interval) {
+    stopDumping();
+    if (!writeFile(path)) return false;
+
+    dumping = true;
+    dumpThread = std::thread([this, path, interval]() {
+        std::unique_lock<std::mutex> lock(dumpMutex);
+        while (!dumpCondition.wait_for(lock, interval, [this]() { return !dumping; })) {
+            if (!writeFile(path)) {
+                std::cerr << "Warning: Could not write metrics to " << path << "." << std::endl;
+            }
+        }
+        writeFile(path);  // Final values on shutdown
+    });
+    return true;
+}
+
+void MetricsRegistry::stopDumping() {
+    {
+        std::lock_guard<std::mutex> lock(dumpMutex);
+        dumping = false;
+    }
+    dumpCondition.notify_all();
+    if (dumpThread.joinable()) {
+        dumpThread.join();
+    }
+}
@@ -0,0 +1,369 @@
+// ============================================================================
+// FILE: src/RoaringBitmap.cpp
+// ============================================================================
+
+#include "RoaringBitmap.h"
+#include <iterator>
+
+namespace {
+
+// Index of the first value >= target in a sorted run. Halving without a
+// data-dependent branch (a conditional move) keeps lookups free of the
+// mispredictions std::lower_bound takes on random probes
+size_t lowerBound(const uint16_t* values, size_t count, uint16_t target) {
+    if (count == 0) return 0;
+    const uint16_t* base = values;
+    while (count > 1) {
+        size_t half = count / 2;
+        base = (base[half] < target) ? base + half : base;
+        count -= half;
+    }
+    return static_cast<size_t>(base - values) + (*base < target);
+}
+
+}  // namespace
+
+size_t RoaringBitmap::findContainer(uint16_t high) const {
+    size_t i = lowerBound(keys.data(), keys.size(), high);
+    if (i == keys.size() || keys[i] != high) return keys.size();
+    return i;
+}
+
+void RoaringBitmap::toBitmap(Container& c) {
+    c.bits.assign(BITMAP_WORDS, 0);
+    for (uint16_t low : c.array) {
+        c.bits[low >> 6] |= uint64_t(1) << (low & 63);
+    }
+    std::vector<uint16_t>().swap(c.array);
+}
+
+void RoaringBitmap::toArray(Container& c) {
+    std::vector<uint16_t> values;
+    values.reserve(c.cardinality);
+    for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+        uint64_t word = c.bits[w];
+        while (word) {
+            values.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+    c.array.swap(values);
+    std::vector<uint64_t>().swap(c.bits);
+}
+
+void RoaringBitmap::recount(Container& c) {
+    if (!c.isBitmap()) {
+        c.cardinality = static_cast<uint32_t>(c.array.size());
+        return;
+    }
+    uint32_t count = 0;
+    for (uint64_t word : c.bits) count += static_cast<uint32_t>(__builtin_popcountll(word));
+    c.cardinality = count;
+}
+
+void RoaringBitmap::fit(Container& c) {
+    if (c.isBitmap() && c.cardinality <= ROARING_ARRAY_MAX) {
+        toArray(c);
+    } else if (!c.isBitmap() && c.cardinality > ROARING_ARRAY_MAX) {
+        toBitmap(c);
+    }
+}
+
+bool RoaringBitmap::containerContains(const Container& c, uint16_t low) {
+    if (c.isBitmap()) return (c.bits[low >> 6] >> (low & 63)) & 1;
+    size_t i = lowerBound(c.array.data(), c.array.size(), low);
+    return i != c.array.size() && c.array[i] == low;
+}
+
+void RoaringBitmap::unionContainers(Container& a, const Container& b) {
+    if (!a.isBitmap() && !b.isBitmap()) {
+        // Merge first: overlapping arrays often stay small enough for array
+        // form, which a round trip through a bitmap would find out slowly.
+        // Branch-free, as in intersectContainers
+        std::vector<uint16_t> merged(a.cardinality + b.cardinality);
+        const uint16_t* x = a.array.data();
+        const uint16_t* y = b.array.data();
+        size_t i = 0, j = 0, k = 0;
+        while (i < a.array.size() && j < b.array.size()) {
+            uint16_t u = x[i], v = y[j];
+            merged[k++] = std::min(u, v);
+            i += u <= v;
+            j += v <= u;
+        }
+        k = std::copy(a.array.begin() + i, a.array.end(), merged.begin() + k) - merged.begin();
+        k = std::copy(b.array.begin() + j, b.array.end(), merged.begin() + k) - merged.begin();
+        merged.resize(k);
+        a.array.swap(merged);
+        recount(a);
+        fit(a);
+        return;
+    }
+
+    // One side is a bitmap, so the result is one too
+    if (!a.isBitmap()) toBitmap(a);
+    if (b.isBitmap()) {
+        for (size_t w = 0; w < BITMAP_WORDS; ++w) a.bits[w] |= b.bits[w];
+        recount(a);
+    } else {
+        for (uint16_t low : b.array) {
+            uint64_t bit = uint64_t(1) << (low & 63);
+            a.cardinality += !(a.bits[low >> 6] & bit);
+            a.bits[low >> 6] |= bit;
+        }
+    }
+}
+
+void RoaringBitmap::intersectContainers(Container& a, const Container& b) {
+    if (a.isBitmap() && b.isBitmap()) {
+        for (size_t w = 0; w < BITMAP_WORDS; ++w) a.bits[w] &= b.bits[w];
+        recount(a);
+        fit(a);
+        return;
+    }
+
+    // At least one side is an array, so the result is one too
+    std::vector<uint16_t> kept;
+    if (a.isBitmap()) {
+        kept.reserve(b.cardinality);
+        for (uint16_t low : b.array) {
+            if (containerContains(a, low)) kept.push_back(low);
+        }
+        std::vector<uint64_t>().swap(a.bits);
+    } else if (b.isBitmap()) {
+        kept.reserve(a.cardinality);
+        for (uint16_t low : a.array) {
+            if (containerContains(b, low)) kept.push_back(low);
+        }
+    } else {
+        const std::vector<uint16_t>& small = a.cardinality <= b.cardinality ? a.array : b.array;
+        const std::vector<uint16_t>& large = a.cardinality <= b.cardinality ? b.array : a.array;
+        kept.resize(small.size());
+        size_t k = 0;
+        if (large.size() / 32 > small.size()) {
+            // Far apart in size: look each small value up in the large run
+            for (uint16_t low : small) {
+                size_t at = lowerBound(large.data(), large.size(), low);
+                kept[k] = low;
+                k += at != large.size() && large[at] == low;
+            }
+        } else {
+            // Merge without branching on the comparison: on handles spread
+            // at random a branchy merge mispredicts about every other step.
+            // k never passes min(i, j), so kept has room
+            const uint16_t* x = small.data();
+            const uint16_t* y = large.data();
+            size_t i = 0, j = 0;
+            while (i < small.size() && j < large.size()) {
+                uint16_t u = x[i], v = y[j];
+                kept[k] = u;
+                k += u == v;
+                i += u <= v;
+                j += v <= u;
+            }
+        }
+        kept.resize(k);
+    }
+    a.array.swap(kept);
+    recount(a);
+}
+
+void RoaringBitmap::subtractContainers(Container& a, const Container& b) {
+    if (a.isBitmap()) {
+        if (b.isBitmap()) {
+            for (size_t w = 0; w < BITMAP_WORDS; ++w) a.bits[w] &= ~b.bits[w];
+        } else {
+            for (uint16_t low : b.array) a.bits[low >> 6] &= ~(uint64_t(1) << (low & 63));
+        }
+        recount(a);
+        fit(a);
+        return;
+    }
+
+    std::vector<uint16_t> kept;
+    kept.reserve(a.cardinality);
+    if (b.isBitmap()) {
+        for (uint16_t low : a.array) {
+            if (!containerContains(b, low)) kept.push_back(low);
+        }
+    } else {
+        std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                            std::back_inserter(kept));
+    }
+    a.array.swap(kept);
+    recount(a);
+}
+
+bool RoaringBitmap::add(uint32_t value) {
+    const uint16_t high = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+
+    auto pos = std::lower_bound(keys.begin(), keys.end(), high);
+    size_t i = static_cast<size_t>(pos - keys.begin());
+    if (pos == keys.end() || *pos != high) {
+        keys.insert(pos, high);
+        containers.insert(containers.begin() + i, Container());
+    }
+
+    Container& c = containers[i];
+    if (c.isBitmap()) {
+        uint64_t& word = c.bits[low >> 6];
+        const uint64_t bit = uint64_t(1) << (low & 63);
+        if (word & bit) return false;
+        word |= bit;
+        ++c.cardinality;
+        return true;
+    }
+
+    auto it = std::lower_bound(c.array.begin(), c.array.end(), low);
+    if (it != c.array.end() && *it == low) return false;
+    c.array.insert(it, low);
+    ++c.cardinality;
+    fit(c);
+    return true;
+}
+
+bool RoaringBitmap::remove(uint32_t value) {
+    size_t i = findContainer(static_cast<uint16_t>(value >> 16));
+    if (i == keys.size()) return false;
+
+    Container& c = containers[i];
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    if (c.isBitmap()) {
+        uint64_t& word = c.bits[low >> 6];
+        const uint64_t bit = uint64_t(1) << (low & 63);
+        if (!(word & bit)) return false;
+        word &= ~bit;
+    } else {
+        auto it = std::lower_bound(c.array.begin(), c.array.end(), low);
+        if (it == c.array.end() || *it != low) return false;
+        c.array.erase(it);
+    }
+    --c.cardinality;
+
+    if (c.cardinality == 0) {
+        keys.erase(keys.begin() + i);
+        containers.erase(containers.begin() + i);
+    } else {
+        fit(c);
+    }
+    return true;
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    size_t i = findContainer(static_cast<uint16_t>(value >> 16));
+    return i != keys.size() &&
+           containerContains(containers[i], static_cast<uint16_t>(value & 0xFFFF));
+}
+
+size_t RoaringBitmap::cardinality() const {
+    size_t count = 0;
+    for (const Container& c : containers) count += c.cardinality;
+    return count;
+}
+
+bool RoaringBitmap::empty() const { return keys.empty(); }
+
+void RoaringBitmap::clear() {
+    keys.clear();
+    containers.clear();
+}
+
+void RoaringBitmap::unionWith(const RoaringBitmap& other) {
+    if (&other == this) return;
+
+    // Merge the two sorted key lists, combining containers on shared keys
+    std::vector<uint16_t> mergedKeys;
+    std::vector<Container> merged;
+    mergedKeys.reserve(keys.size() + other.keys.size());
+    merged.reserve(keys.size() + other.keys.size());
+
+    size_t i = 0, j = 0;
+    while (i < keys.size() || j < other.keys.size()) {
+        if (j == other.keys.size() || (i < keys.size() && keys[i] < other.keys[j])) {
+            mergedKeys.push_back(keys[i]);
+            merged.push_back(std::move(containers[i]));
+            ++i;
+        } else if (i == keys.size() || other.keys[j] < keys[i]) {
+            mergedKeys.push_back(other.keys[j]);
+            merged.push_back(other.containers[j]);
+            ++j;
+        } else {
+            unionContainers(containers[i], other.containers[j]);
+            mergedKeys.push_back(keys[i]);
+            merged.push_back(std::move(containers[i]));
+            ++i;
+            ++j;
+        }
+    }
+    keys.swap(mergedKeys);
+    containers.swap(merged);
+}
+
+void RoaringBitmap::intersectWith(const RoaringBitmap& other) {
+    if (&other == this) return;
+
+    size_t out = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        size_t j = other.findContainer(keys[i]);
+        if (j == other.keys.size()) continue;
+        intersectContainers(containers[i], other.containers[j]);
+        if (containers[i].cardinality == 0) continue;
+        if (out != i) {
+            keys[out] = keys[i];
+            containers[out] = std::move(containers[i]);
+        }
+        ++out;
+    }
+    keys.resize(out);
+    containers.resize(out);
+}
+
+void RoaringBitmap::subtract(const RoaringBitmap& other) {
+    if (&other == this) {
+        clear();
+        return;
+    }
+
+    size_t out = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        size_t j = other.findContainer(keys[i]);
+        if (j != other.keys.size()) {
+            subtractContainers(containers[i], other.containers[j]);
+            if (containers[i].cardinality == 0) continue;
+        }
+        if (out != i) {
+            keys[out] = keys[i];
+            containers[out] = std::move(containers[i]);
+        }
+        ++out;
+    }
+    keys.resize(out);
+    containers.resize(out);
+}
+
+void RoaringBitmap::remap(const std::vector<uint32_t>& table) {
+    RoaringBitmap mapped;
+    forEach([&](uint32_t value) {
+        if (value < table.size() && table[value] != UINT32_MAX) mapped.add(table[value]);
+    });
+    *this = std::move(mapped);
+}
+
+bool RoaringBitmap::operator==(const RoaringBitmap& other) const {
+    if (keys != other.keys) return false;
+    for (size_t i = 0; i < containers.size(); ++i) {
+        const Container& a = containers[i];
+        const Container& b = other.containers[i];
+        if (a.cardinality != b.cardinality || a.array != b.array || a.bits != b.bits) return false;
+    }
+    return true;
+}
+
+size_t RoaringBitmap::memoryBytes() const {
+    size_t bytes = sizeof(*this) + keys.capacity() * sizeof(uint16_t) +
+                   containers.capacity() * sizeof(Container);
+    for (const Container& c : containers) {
+        bytes += c.array.capacity() * sizeof(uint16_t) + c.bits.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
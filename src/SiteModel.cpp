@@ -0,0 +1,274 @@
+// ============================================================================
+// FILE: src/SiteModel.cpp
+// ============================================================================
+
+#include "SiteModel.h"
+
+SiteModel::SiteModel() : doors(0) {}
+
+SiteId SiteModel::addNode(SiteKind kind, SiteId parent, const std::string& id,
+                          const std::string& name) {
+    if (id.empty() || id.size() > SITE_ID_MAX) {
+        std::cerr << "Error: Site ID '" << id << "' must be 1-" << SITE_ID_MAX
+                  << " characters." << std::endl;
+        return NO_SITE;
+    }
+    if (byId.count(id)) {
+        std::cerr << "Error: Site ID '" << id << "' is already in use." << std::endl;
+        return NO_SITE;
+    }
+
+    SiteId node = static_cast<SiteId>(nodes.size());
+    Node entry;
+    entry.kind = kind;
+    entry.live = true;
+    entry.policy = -1;
+    entry.parent = parent;
+    entry.floor = NO_SITE;
+    entry.floorSlot = 0;
+    entry.id = id;
+    entry.name = name;
+    if (parent != NO_SITE) {
+        entry.floor = nodes[parent].floor;
+        nodes[parent].children.push_back(node);
+    }
+    nodes.push_back(std::move(entry));
+    minimum.push_back(parent != NO_SITE ? minimum[parent] : 0);
+    byId.emplace(id, node);
+    byName.emplace(name, node);
+    return node;
+}
+
+SiteId SiteModel::addBuilding(const std::string& id, const std::string& name) {
+    return addNode(SiteKind::BUILDING, NO_SITE, id, name);
+}
+
+SiteId SiteModel::addFloor(SiteId building, const std::string& id, const std::string& name,
+                           ClearanceLevel clearance, size_t historyLimit) {
+    if (!contains(building) || nodes[building].kind != SiteKind::BUILDING) return NO_SITE;
+    SiteId node = addNode(SiteKind::FLOOR, building, id, name);
+    if (node == NO_SITE) return NO_SITE;
+
+    nodes[node].floor = node;
+    nodes[node].floorSlot = static_cast<uint32_t>(floorStore.size());
+    floorStore.emplace_back(id, name, clearance, historyLimit);
+    floorOrder.push_back(node);
+    return node;
+}
+
+SiteId SiteModel::addZone(SiteId parent, const std::string& id, const std::string& name) {
+    if (!contains(parent) || (nodes[parent].kind != SiteKind::FLOOR &&
+                              nodes[parent].kind != SiteKind::ZONE)) {
+        return NO_SITE;
+    }
+    return addNode(SiteKind::ZONE, parent, id, name);
+}
+
+SiteId SiteModel::addDoor(SiteId parent, const std::string& id, const std::string& name) {
+    if (!contains(parent) || (nodes[parent].kind != SiteKind::FLOOR &&
+                              nodes[parent].kind != SiteKind::ZONE)) {
+        return NO_SITE;
+    }
+    SiteId node = addNode(SiteKind::DOOR, parent, id, name);
+    if (node != NO_SITE) ++doors;
+    return node;
+}
+
+bool SiteModel::remove(SiteId node) {
+    if (!contains(node) || (nodes[node].kind != SiteKind::ZONE &&
+                            nodes[node].kind != SiteKind::DOOR)) {
+        return false;
+    }
+
+    auto& siblings = nodes[nodes[node].parent].children;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), node));
+
+    std::vector<SiteId> stack(1, node);
+    while (!stack.empty()) {
+        SiteId current = stack.back();
+        stack.pop_back();
+        Node& entry = nodes[current];
+        stack.insert(stack.end(), entry.children.begin(), entry.children.end());
+
+        byId.erase(entry.id);
+        auto range = byName.equal_range(entry.name);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == current) {
+                byName.erase(it);
+                break;
+            }
+        }
+        if (entry.kind == SiteKind::DOOR) --doors;
+        entry.live = false;
+        entry.children.clear();
+    }
+    return true;
+}
+
+void SiteModel::flatten(SiteId root) {
+    std::vector<SiteId> stack(1, root);
+    while (!stack.empty()) {
+        SiteId node = stack.back();
+        stack.pop_back();
+        const Node& entry = nodes[node];
+        uint8_t inherited = entry.parent != NO_SITE ? minimum[entry.parent] : 0;
+        minimum[node] = std::max<uint8_t>(inherited, entry.policy < 0 ? 0 : entry.policy);
+        stack.insert(stack.end(), entry.children.begin(), entry.children.end());
+    }
+}
+
+bool SiteModel::setPolicy(SiteId node, ClearanceLevel level) {
+    if (!contains(node) || nodes[node].kind == SiteKind::FLOOR) return false;
+    nodes[node].policy = static_cast<int8_t>(clearanceLevelToInt(level));
+    flatten(node);
+    return true;
+}
+
+bool SiteModel::clearPolicy(SiteId node) {
+    if (!contains(node) || nodes[node].kind == SiteKind::FLOOR) return false;
+    nodes[node].policy = -1;
+    flatten(node);
+    return true;
+}
+
+bool SiteModel::hasPolicy(SiteId node) const { return nodes[node].policy >= 0; }
+
+ClearanceLevel SiteModel::getPolicy(SiteId node) const {
+    return intToClearanceLevel(std::max<int>(nodes[node].policy, 0));
+}
+
+SiteId SiteModel::findById(const std::string& id) const {
+    auto it = byId.find(id);
+    return it == byId.end() ? NO_SITE : it->second;
+}
+
+SiteId SiteModel::findByName(const std::string& name, SiteKind kind) const {
+    // Names repeat across buildings; the first one added wins
+    SiteId found = NO_SITE;
+    auto range = byName.equal_range(name);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (nodes[it->second].kind == kind) found = std::min(found, it->second);
+    }
+    return found;
+}
+
+SiteId SiteModel::floorAt(size_t number) const {
+    if (number < 1 || number > floorOrder.size()) return NO_SITE;
+    return floorOrder[number - 1];
+}
+
+bool SiteModel::contains(SiteId node) const { return node < nodes.size() && nodes[node].live; }
+SiteKind SiteModel::getKind(SiteId node) const { return nodes[node].kind; }
+const std::string& SiteModel::getId(SiteId node) const { return nodes[node].id; }
+const std::string& SiteModel::getName(SiteId node) const { return nodes[node].name; }
+SiteId SiteModel::getParent(SiteId node) const { return nodes[node].parent; }
+const std::vector<SiteId>& SiteModel::getChildren(SiteId node) const { return nodes[node].children; }
+
+bool SiteModel::rename(SiteId node, const std::string& newName) {
+    if (!contains(node)) return false;
+    Node& entry = nodes[node];
+    auto range = byName.equal_range(entry.name);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == node) {
+            byName.erase(it);
+            break;
+        }
+    }
+    entry.name = newName;
+    byName.emplace(newName, node);
+    if (entry.kind == SiteKind::FLOOR) floorStore[entry.floorSlot].setName(newName);
+    return true;
+}
+
+size_t SiteModel::floorCount() const { return floorOrder.size(); }
+size_t SiteModel::doorCount() const { return doors; }
+size_t SiteModel::nodeLimit() const { return nodes.size(); }
+
+Floor& SiteModel::getFloor(SiteId node) { return floorStore[nodes[nodes[node].floor].floorSlot]; }
+
+const Floor& SiteModel::getFloor(SiteId node) const {
+    return floorStore[nodes[nodes[node].floor].floorSlot];
+}
+
+SiteId SiteModel::getFloorOf(SiteId node) const { return nodes[node].floor; }
+
+ClearanceLevel SiteModel::getMinimum(SiteId node) const {
+    return intToClearanceLevel(minimum[node]);
+}
+
+ClearanceLevel SiteModel::getRequiredClearanceAt(SiteId node, int64_t epochSeconds) const {
+    int scheduled = clearanceLevelToInt(getFloor(node).getRequiredClearanceAt(epochSeconds));
+    return intToClearanceLevel(std::max<int>(scheduled, minimum[node]));
+}
+
+bool SiteModel::isAuthorized(SiteId node, UserHandle user, ClearanceLevel clearance,
+                             int64_t epochSeconds) const {
+    if (!contains(node) || nodes[node].floor == NO_SITE) return false;
+    return getFloor(node).isAuthorized(user, clearance, epochSeconds, getMinimum(node));
+}
+
+bool SiteModel::attemptAccess(SiteId node, UserHandle user, const std::string& userId,
+                              const std::string& userName, ClearanceLevel clearance) {
+    if (!contains(node) || nodes[node].floor == NO_SITE) return false;
+    return getFloor(node).attemptAccess(user, userId, userName, clearance, getMinimum(node),
+                                        nodes[node].id);
+}
+
+bool SiteModel::loadCSV(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || (lineNumber == 1 && line.compare(0, 5, "kind,") == 0)) continue;
+
+        // kind,id,name,parent,clearance
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) fields.push_back(field);
+        if (fields.size() == 4) fields.push_back("");
+
+        SiteId node = NO_SITE;
+        int level = -1;
+        if (fields.size() == 5 && !fields[4].empty()) {
+            level = (fields[4].size() == 1 && fields[4][0] >= '0' && fields[4][0] <= '3')
+                        ? fields[4][0] - '0' : -2;
+        }
+        if (fields.size() == 5 && level != -2) {
+            const std::string& kind = fields[0];
+            SiteId parent = findById(fields[3]);
+            if (kind == "building" && fields[3].empty()) {
+                node = addBuilding(fields[1], fields[2]);
+            } else if (kind == "floor" && level >= 0) {
+                node = addFloor(parent, fields[1], fields[2], intToClearanceLevel(level));
+                level = -1;  // The floor's own level, not a policy
+            } else if (kind == "zone") {
+                node = addZone(parent, fields[1], fields[2]);
+            } else if (kind == "door") {
+                node = addDoor(parent, fields[1], fields[2]);
+            }
+        }
+
+        if (node == NO_SITE) {
+            std::cerr << "Warning: Skipping line " << lineNumber << " of " << path
+                      << ": " << line << std::endl;
+            continue;
+        }
+        if (level >= 0) setPolicy(node, intToClearanceLevel(level));
+    }
+    return true;
+}
+
+SiteModel SiteModel::defaultSite() {
+    SiteModel site;
+    SiteId building = site.addBuilding("B1", "Main Building");
+    site.addFloor(building, "F1", "Ground Floor", ClearanceLevel::LEVEL_0);
+    site.addFloor(building, "F2", "Office Floor", ClearanceLevel::LEVEL_1);
+    site.addFloor(building, "F3", "Server Room", ClearanceLevel::LEVEL_2);
+    site.addFloor(building, "F4", "Executive Suite", ClearanceLevel::LEVEL_3);
+    return site;
+}
@@ -3,26 +3,47 @@
 // ============================================================================
 
 #include "SystemManager.h"
+#include "AccessServer.h"
 #include "DataGenerator.h"
 #include "Validator.h"
 
 SystemManager::SystemManager() 
-    : userCache(CACHE_SIZE), running(true) {
-    // Initialize default floors
-    floors.push_back(Floor("F1", "Ground Floor", ClearanceLevel::LEVEL_0));
-    floors.push_back(Floor("F2", "Office Floor", ClearanceLevel::LEVEL_1));
-    floors.push_back(Floor("F3", "Server Room", ClearanceLevel::LEVEL_2));
-    floors.push_back(Floor("F4", "Executive Suite", ClearanceLevel::LEVEL_3));
+    : userSearchBuilt(false), site(SiteModel::defaultSite()), userCache(CACHE_SIZE), running(true),
+      saveRequested(0), saveCompleted(0), rosterCompactions(0) {
+
+    MetricsRegistry& metrics = MetricsRegistry::global();
+    const std::string cacheHelp = "User search cache lookups and evictions";
+    userCacheMetrics.hits = &metrics.counter("scs_user_cache_total", cacheHelp, "event=\"hit\"");
+    userCacheMetrics.misses = &metrics.counter("scs_user_cache_total", cacheHelp, "event=\"miss\"");
+    userCacheMetrics.evictions = &metrics.counter("scs_user_cache_total", cacheHelp, "event=\"eviction\"");
+    userCache.setMetrics(&userCacheMetrics);
+
+    const std::string loginHelp = "Login attempts by role and outcome";
+    userLoginSuccesses = &metrics.counter("scs_logins_total", loginHelp, "role=\"user\",result=\"success\"");
+    userLoginFailures = &metrics.counter("scs_logins_total", loginHelp, "role=\"user\",result=\"failure\"");
+    adminLoginSuccesses = &metrics.counter("scs_logins_total", loginHelp, "role=\"admin\",result=\"success\"");
+    adminLoginFailures = &metrics.counter("scs_logins_total", loginHelp, "role=\"admin\",result=\"failure\"");
+    findUserLatency = &metrics.histogram("scs_find_user_seconds", "SystemManager::findUser latency");
+    userSearchLatency = &metrics.histogram("scs_user_search_seconds", "SystemManager::findUsers latency");
+    saveLatency = &metrics.histogram("scs_save_seconds", "Duration of one flush of changes to disk");
+    loadSeconds = &metrics.gauge("scs_load_seconds", "Time initialize() took to load the roster");
 }
 
 SystemManager::~SystemManager() {
-    running = false;
+    {
+        std::lock_guard<std::mutex> lock(saveMutex);
+        running = false;
+    }
+    saveCondition.notify_all();
     if (saveThread.joinable()) {
         saveThread.join();
     }
+    MetricsRegistry::global().stopDumping();  // Writes the final values
 }
 
 void SystemManager::initialize() {
+    auto loadStart = std::chrono::steady_clock::now();
+
     // Create data directory if it doesn't exist
     #ifdef _WIN32
         system("if not exist data mkdir data");
@@ -35,22 +56,116 @@ void SystemManager::initialize() {
     if (!checkFile.good()) {
         std::cout << "No data file found. Generating initial data..." << std::endl;
         generateInitialData();
+        dataManager.clearJournal();  // Changes to an old data file don't apply
     }
     checkFile.close();
     
-    // Load data from CSV
-    dataManager.loadFromCSV(users, admin);
-    
-    // Start background save thread
+    // Bulk-load the binary snapshot if it is current, else parse the CSV
+    // and write a snapshot so the next start is fast
+    auto snapshot = dataManager.openSnapshot();
+    if (snapshot) {
+        snapshot->loadInto(users);
+        admin = snapshot->materializeAdmin();
+    } else {
+        dataManager.loadFromCSV(users, admin);
+        dataManager.saveSnapshot(users, admin);
+    }
+
+    // Changes saved since the CSV was last rewritten; deletes among them
+    // leave holes, dropped here while nothing else holds a handle
+    replayJournal();
+    if (users.needsCompaction()) users.compact();
+    rebuildCardIndex();
+    publishUsers();
+    loadSeconds->set(std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count());
+
+    // Campus layout, if one is configured (else the built-in floors)
+    std::ifstream siteFile(SITE_FILE);
+    if (siteFile.good()) {
+        SiteModel loaded;
+        if (loaded.loadCSV(SITE_FILE) && loaded.floorCount() > 0) {
+            site = std::move(loaded);
+        } else {
+            std::cerr << "Warning: No floors in " << SITE_FILE
+                      << ", using the built-in floors." << std::endl;
+        }
+    }
+    siteFile.close();
+    loadFloorExceptions();
+
+    // Durable audit trail of every access attempt
+    if (auditLog.open(AUDIT_DIR)) {
+        site.forEachFloor([this](Floor& floor) {
+            floor.setAuditLog(&auditLog);
+        });
+    } else {
+        std::cerr << "Warning: Could not open audit log in " << AUDIT_DIR
+                  << ", access attempts will not be persisted." << std::endl;
+    }
+
+    // Metrics for scrapers, rewritten periodically
+    if (!MetricsRegistry::global().startDumping(
+            METRICS_FILE, std::chrono::seconds(METRICS_DUMP_INTERVAL_SECONDS))) {
+        std::cerr << "Warning: Could not write " << METRICS_FILE << "." << std::endl;
+    }
+
+    // Start background flush worker
     saveThread = std::thread(&SystemManager::saveThreadFunction, this);
 }
 
+void SystemManager::publishAccessTables() {
+    // Readers only send card and floor IDs, so the whole roster goes into
+    // the engine's clearance table up front
+    std::unique_ptr<AccessEngine> engine(new AccessEngine());
+    {
+        std::lock_guard<std::mutex> lock(systemMutex);
+        engine->rebuild(users, site);
+        if (admin) {
+            engine->addCard(admin->getCard()->getId(), admin->getId(),
+                            admin->getCard()->getClearanceLevel());
+        }
+    }
+    if (auditLog.isOpen()) {
+        engine->setAuditLog(&auditLog);
+    }
+
+    std::cout << "Loaded " << engine->cardCount() << " cards, "
+              << engine->floorCount() << " floors and " << engine->doorCount()
+              << " doors." << std::endl;
+    accessTables.publish(std::move(engine));
+}
+
+void SystemManager::publishUsers() {
+    // The store is a handful of flat arrays, so the copy is a few bulk
+    // copies; readers keep the version they pinned until they are done
+    userTables.publish(std::unique_ptr<UserStore>(new UserStore(users)));
+}
+
+bool SystemManager::serve(const std::string& socketPath, size_t workers, bool withMenu) {
+    publishAccessTables();
+    AccessServer server(accessTables, socketPath, workers);
+    if (!withMenu) {
+        return server.run();
+    }
+
+    // Admin edits made in the menu publish new table versions; the server
+    // keeps answering from whichever version it pinned
+    bool served = true;
+    std::thread serverThread([&]() { served = server.run(); });
+    run();
+    AccessServer::stop();
+    serverThread.join();
+    return served;
+}
+
 void SystemManager::run() {
     std::cout << "\n╔════════════════════════════════════════╗" << std::endl;
     std::cout << "║   SECURE CARD ACCESS SYSTEM           ║" << std::endl;
     std::cout << "╚════════════════════════════════════════╝" << std::endl;
     
     while (running) {
+        compactRoster();
+
         std::cout << "\n=== Main Menu ===" << std::endl;
         std::cout << "1. User Login" << std::endl;
         std::cout << "2. Admin Login" << std::endl;
@@ -75,27 +190,115 @@ void SystemManager::run() {
     }
 }
 
-// Background thread function to handle save command
+// Background flush worker: sleeps until a save is requested, then writes
+// everything changed so far in one go. Requests that arrive while a flush
+// is running are all covered by the next one.
 void SystemManager::saveThreadFunction() {
-    // This thread runs alongside main thread, scheduled by OS
-    // It waits for save operations to be triggered
-    while (running) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::unique_lock<std::mutex> lock(saveMutex);
+    while (true) {
+        saveCondition.wait(lock, [this]() { return saveRequested > saveCompleted || !running; });
+        if (saveRequested == saveCompleted) {
+            break;  // Shutting down with nothing queued
+        }
+
+        uint64_t target = saveRequested;
+        lock.unlock();
+        flushChanges();
+        lock.lock();
+
+        saveCompleted = target;
+        saveCondition.notify_all();
     }
 }
 
 void SystemManager::checkSaveCommand(const std::string& input) {
     if (input == "scs -save") {
-        // Trigger save in separate thread context
-        std::thread([this]() {
-            saveSystem();
-        }).detach();
+        // Queued for the flush worker, never blocks the menu
+        requestSave(false);
+    }
+}
+
+void SystemManager::requestSave(bool wait) {
+    if (!saveThread.joinable()) {
+        flushChanges();  // Worker not started (or already stopped)
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(saveMutex);
+    uint64_t ticket = ++saveRequested;
+    saveCondition.notify_all();
+    if (wait) {
+        saveCondition.wait(lock, [this, ticket]() { return saveCompleted >= ticket; });
     }
 }
 
 void SystemManager::saveSystem() {
+    requestSave(true);
+}
+
+void SystemManager::flushChanges() {
+    ScopedTimer timer(*saveLatency);
+
+    // Rows for the users changed since the last flush are formatted under
+    // the lock, in the order the changes were made (only those users are
+    // visited); the journal write happens outside it
+    std::vector<JournalRecord> changes;
+    size_t userCount;
+    std::unique_ptr<CardIndex> refrozen;
+    uint64_t compactionsSeen = 0;
+    {
+        std::lock_guard<std::mutex> lock(systemMutex);
+        users.drainChanges([this, &changes](UserHandle user, bool live) {
+            if (live) {
+                changes.push_back({false, users.toCSV(user)});
+            } else {
+                changes.push_back({true, std::string(users.getId(user))});
+            }
+        });
+        if (admin && admin->isDirty()) {
+            changes.push_back({false, admin->toCSV()});
+            admin->clearDirty();
+        }
+        userCount = users.size();
+
+        if (cardIndex.needsFreeze()) {
+            refrozen.reset(new CardIndex(cardIndex));  // Flat arrays: a few bulk copies
+            compactionsSeen = rosterCompactions;
+        }
+    }
+
+    // Fold card changes into a new perfect-hash table once enough piled up.
+    // The table is built outside the lock; cards changed meanwhile are
+    // carried over before it replaces the live index. If the roster was
+    // compacted meanwhile the copy names old handles; the next flush retries.
+    if (refrozen) {
+        refrozen->freeze();
+        std::lock_guard<std::mutex> lock(systemMutex);
+        if (rosterCompactions == compactionsSeen) {
+            refrozen->catchUp(cardIndex);
+            std::swap(cardIndex, *refrozen);
+        }
+    }
+
+    bool journaled = dataManager.appendToJournal(changes);
+
+    // The full CSV is only rewritten once the journal has grown large (or
+    // if it couldn't be written). Only this thread writes the journal, so
+    // nothing can be appended between the copy and the truncate; edits made
+    // meanwhile stay dirty and go to the next journal batch.
+    if (!journaled || dataManager.journalNeedsCompaction(userCount)) {
+        UserStore rosterCopy;
+        std::shared_ptr<Admin> adminCopy;
+        copyRoster(rosterCopy, adminCopy);
+        dataManager.compact(rosterCopy, adminCopy);
+    }
+}
+
+void SystemManager::copyRoster(UserStore& rosterCopy, std::shared_ptr<Admin>& adminCopy) {
+    // The store is a handful of flat arrays, so this is a few bulk copies
     std::lock_guard<std::mutex> lock(systemMutex);
-    dataManager.saveToCSV(users, admin);
+    rosterCopy = users;
+    adminCopy = admin ? std::make_shared<Admin>(*admin) : nullptr;
 }
 
 // ============================================================================
@@ -113,16 +316,18 @@ void SystemManager::userLogin() {
     std::getline(std::cin, searchTerm);
     checkSaveCommand(searchTerm);
     
-    auto user = findUser(searchTerm);
-    if (user) {
-        std::cout << "Login successful! Welcome, " << user->getName() << std::endl;
+    UserHandle user = findUser(searchTerm);
+    if (user != NO_USER) {
+        userLoginSuccesses->add();
+        std::cout << "Login successful! Welcome, " << users.getName(user) << std::endl;
         userMenu(user);
     } else {
+        userLoginFailures->add();
         std::cout << "User not found." << std::endl;
     }
 }
 
-void SystemManager::userMenu(std::shared_ptr<User> user) {
+void SystemManager::userMenu(UserHandle user) {
     while (true) {
         std::cout << "\n=== User Menu ===" << std::endl;
         std::cout << "1. List all available floors" << std::endl;
@@ -147,12 +352,14 @@ void SystemManager::userMenu(std::shared_ptr<User> user) {
     }
 }
 
-void SystemManager::listFloorsForUser(std::shared_ptr<User> user) {
+void SystemManager::listFloorsForUser(UserHandle user) {
     std::cout << "\n=== Available Floors ===" << std::endl;
-    for (size_t i = 0; i < floors.size(); ++i) {
-        std::cout << (i + 1) << ". " << floors[i].getName() 
+    int64_t now = getCurrentEpochSeconds();
+    for (size_t i = 1; i <= site.floorCount(); ++i) {
+        SiteId floor = site.floorAt(i);
+        std::cout << i << ". " << site.getName(floor) 
                   << " (Required Clearance: " 
-                  << clearanceLevelToInt(floors[i].getRequiredClearance()) << ")" 
+                  << clearanceLevelToInt(site.getRequiredClearanceAt(floor, now)) << ")" 
                   << std::endl;
     }
     
@@ -170,42 +377,54 @@ void SystemManager::listFloorsForUser(std::shared_ptr<User> user) {
     }
 }
 
-void SystemManager::accessFloor(std::shared_ptr<User> user) {
-    std::cout << "Enter floor number (1-" << floors.size() << "): ";
+void SystemManager::accessFloor(UserHandle user) {
+    std::cout << "Enter floor number (1-" << site.floorCount() << ") or door ID: ";
     std::string floorNum;
     std::getline(std::cin, floorNum);
     checkSaveCommand(floorNum);
     
     try {
-        int num = std::stoi(floorNum);
-        if (num < 1 || num > static_cast<int>(floors.size())) {
+        // A door or zone ID, else a floor number
+        SiteId point = site.findById(floorNum);
+        if (point == NO_SITE || site.getKind(point) == SiteKind::BUILDING) {
+            point = site.floorAt(static_cast<size_t>(std::max(std::stoi(floorNum), 0)));
+        }
+        if (point == NO_SITE) {
             std::cout << "Invalid floor number." << std::endl;
             return;
         }
         
-        Floor& floor = floors[num - 1];
-        bool authorized = floor.attemptAccess(*user);
+        const Floor& floor = site.getFloor(point);
+        std::string userId(users.getId(user));
+        std::string userName(users.getName(user));
+        bool authorized = site.attemptAccess(point, user, userId, userName,
+                                             users.getClearanceLevel(user));
         
         // Log and print result
         std::string timestamp = getCurrentTimestamp();
         std::cout << "\n=== Access Attempt ===" << std::endl;
         std::cout << "Floor: " << floor.getName() << std::endl;
-        std::cout << "Employee: " << user->getName() << " (" << user->getId() << ")" << std::endl;
+        if (site.getKind(point) != SiteKind::FLOOR) {
+            std::cout << "Door: " << site.getName(point) << " (" << site.getId(point) << ")" << std::endl;
+        }
+        std::cout << "Employee: " << userName << " (" << userId << ")" << std::endl;
         std::cout << "Time: " << timestamp << std::endl;
         std::cout << "Result: " << (authorized ? "ACCESS GRANTED" : "ACCESS DENIED") << std::endl;
         
-        if (!authorized) {
+        if (!authorized && floor.getDenyList().contains(user)) {
+            std::cout << "Reason: Access to this floor has been revoked." << std::endl;
+        } else if (!authorized) {
             std::cout << "Reason: Insufficient clearance level. Required: " 
-                      << clearanceLevelToInt(floor.getRequiredClearance())
-                      << ", Your level: " << user->getCard()->getClearanceLevelInt() << std::endl;
+                      << clearanceLevelToInt(site.getRequiredClearanceAt(point, getCurrentEpochSeconds()))
+                      << ", Your level: " << clearanceLevelToInt(users.getClearanceLevel(user)) << std::endl;
         }
     } catch (const std::exception& e) {
         std::cout << "Invalid input." << std::endl;
     }
 }
 
-void SystemManager::showUserInfo(std::shared_ptr<User> user) {
-    user->displayInfo();
+void SystemManager::showUserInfo(UserHandle user) {
+    users.toUser(user)->displayInfo();
     
     std::cout << "\nOptions:" << std::endl;
     std::cout << "1. Change information" << std::endl;
@@ -221,7 +440,7 @@ void SystemManager::showUserInfo(std::shared_ptr<User> user) {
     }
 }
 
-void SystemManager::changeUserInfo(std::shared_ptr<User> user) {
+void SystemManager::changeUserInfo(UserHandle user) {
     std::cout << "\n=== Change Information ===" << std::endl;
     std::cout << "1. Change name" << std::endl;
     std::cout << "2. Change email" << std::endl;
@@ -239,8 +458,11 @@ void SystemManager::changeUserInfo(std::shared_ptr<User> user) {
             std::string newName;
             std::getline(std::cin, newName);
             checkSaveCommand(newName);
-            user->setName(newName);
-            std::cout << "Name updated successfully." << std::endl;
+            if (renameUser(user, newName)) {
+                std::cout << "Name updated successfully." << std::endl;
+            } else {
+                std::cout << "Name too long. Name not updated." << std::endl;
+            }
         } else if (choice == "2") {
             std::cout << "Enter new email: ";
             std::string newEmail;
@@ -248,8 +470,11 @@ void SystemManager::changeUserInfo(std::shared_ptr<User> user) {
             checkSaveCommand(newEmail);
             
             if (Validator::validateEmail(newEmail)) {
-                user->setEmail(newEmail);
-                std::cout << "Email updated successfully." << std::endl;
+                if (setUserEmail(user, newEmail)) {
+                    std::cout << "Email updated successfully." << std::endl;
+                } else {
+                    std::cout << "Email too long. Email not updated." << std::endl;
+                }
             } else {
                 std::cout << "Invalid email format. Email not updated." << std::endl;
             }
@@ -260,8 +485,11 @@ void SystemManager::changeUserInfo(std::shared_ptr<User> user) {
             checkSaveCommand(newPhone);
             
             if (Validator::validatePhone(newPhone)) {
-                user->setPhone(newPhone);
-                std::cout << "Phone updated successfully." << std::endl;
+                if (setUserPhone(user, newPhone)) {
+                    std::cout << "Phone updated successfully." << std::endl;
+                } else {
+                    std::cout << "Phone too long. Phone not updated." << std::endl;
+                }
             } else {
                 std::cout << "Invalid phone format. Phone not updated." << std::endl;
             }
@@ -292,6 +520,7 @@ void SystemManager::adminLogin() {
     checkSaveCommand(adminId);
     
     if (adminId != admin->getId()) {
+        adminLoginFailures->add();
         std::cout << "Invalid admin ID." << std::endl;
         return;
     }
@@ -302,9 +531,11 @@ void SystemManager::adminLogin() {
     checkSaveCommand(password);
     
     if (admin->verifyPassword(password)) {
+        adminLoginSuccesses->add();
         std::cout << "Admin login successful!" << std::endl;
         adminMenu();
     } else {
+        adminLoginFailures->add();
         std::cout << "Incorrect password." << std::endl;
     }
 }
@@ -315,7 +546,9 @@ void SystemManager::adminMenu() {
         std::cout << "1. List all floors" << std::endl;
         std::cout << "2. List all users" << std::endl;
         std::cout << "3. Create new user" << std::endl;
-        std::cout << "4. Log out" << std::endl;
+        std::cout << "4. Show metrics" << std::endl;
+        std::cout << "5. Search users" << std::endl;
+        std::cout << "6. Log out" << std::endl;
         std::cout << "Choice: ";
         
         std::string choice;
@@ -329,6 +562,10 @@ void SystemManager::adminMenu() {
         } else if (choice == "3") {
             createUser();
         } else if (choice == "4") {
+            showMetrics();
+        } else if (choice == "5") {
+            searchUsers();
+        } else if (choice == "6") {
             std::cout << "Logging out..." << std::endl;
             return;
         } else {
@@ -337,13 +574,25 @@ void SystemManager::adminMenu() {
     }
 }
 
+void SystemManager::showMetrics() {
+    std::cout << "\n=== Metrics ===" << std::endl;
+    MetricsRegistry::global().writePrometheus(std::cout);
+    std::cout << "(also written to " << METRICS_FILE << " every "
+              << METRICS_DUMP_INTERVAL_SECONDS << " s)" << std::endl;
+}
+
 void SystemManager::listFloorsForAdmin() {
     std::cout << "\n=== All Floors ===" << std::endl;
-    for (size_t i = 0; i < floors.size(); ++i) {
-        std::cout << (i + 1) << ". " << floors[i].getName() 
+    for (size_t i = 1; i <= site.floorCount(); ++i) {
+        const Floor& floor = site.getFloor(site.floorAt(i));
+        std::cout << i << ". " << floor.getName() 
                   << " (Clearance: " 
-                  << clearanceLevelToInt(floors[i].getRequiredClearance()) << ")" 
-                  << std::endl;
+                  << clearanceLevelToInt(floor.getRequiredClearance());
+        size_t windows = floor.getSchedule().getRules().size();
+        if (windows > 0) {
+            std::cout << ", " << windows << " scheduled window(s)";
+        }
+        std::cout << ")" << std::endl;
     }
     
     std::cout << "\nEnter floor number to manage (or 0 to go back): ";
@@ -354,7 +603,7 @@ void SystemManager::listFloorsForAdmin() {
     try {
         int num = std::stoi(floorNum);
         if (num == 0) return;
-        if (num < 1 || num > static_cast<int>(floors.size())) {
+        if (num < 1 || num > static_cast<int>(site.floorCount())) {
             std::cout << "Invalid floor number." << std::endl;
             return;
         }
@@ -371,18 +620,22 @@ void SystemManager::manageFloor() {
     std::getline(std::cin, searchTerm);
     checkSaveCommand(searchTerm);
     
-    Floor* floor = findFloor(searchTerm);
-    if (!floor) {
+    SiteId floorNode = findFloor(searchTerm);
+    if (floorNode == NO_SITE) {
         std::cout << "Floor not found." << std::endl;
         return;
     }
+    Floor* floor = &site.getFloor(floorNode);
     
     while (true) {
         std::cout << "\n=== Manage Floor: " << floor->getName() << " ===" << std::endl;
         std::cout << "1. View access history" << std::endl;
         std::cout << "2. Change floor name" << std::endl;
         std::cout << "3. Change clearance level" << std::endl;
-        std::cout << "4. Back" << std::endl;
+        std::cout << "4. Allow/deny lists" << std::endl;
+        std::cout << "5. Access schedule" << std::endl;
+        std::cout << "6. Zones and doors" << std::endl;
+        std::cout << "7. Back" << std::endl;
         std::cout << "Choice: ";
         
         std::string choice;
@@ -390,13 +643,18 @@ void SystemManager::manageFloor() {
         checkSaveCommand(choice);
         
         if (choice == "1") {
-            floor->displayAccessHistory();
+            // Removed users keep their fields until the roster is compacted
+            floor->displayAccessHistory([this](UserHandle user) {
+                std::lock_guard<std::mutex> lock(systemMutex);
+                if (user >= users.handleLimit()) return std::pair<std::string, std::string>();
+                return std::make_pair(std::string(users.getId(user)), std::string(users.getName(user)));
+            });
         } else if (choice == "2") {
             std::cout << "Enter new floor name: ";
             std::string newName;
             std::getline(std::cin, newName);
             checkSaveCommand(newName);
-            floor->setName(newName);
+            site.rename(floorNode, newName);
             std::cout << "Floor name updated." << std::endl;
         } else if (choice == "3") {
             std::cout << "Enter new clearance level (0-3): ";
@@ -408,6 +666,11 @@ void SystemManager::manageFloor() {
                 int level = std::stoi(levelStr);
                 if (level >= 0 && level <= 3) {
                     floor->setRequiredClearance(intToClearanceLevel(level));
+                    std::string floorId = floor->getId();
+                    accessTables.update([&](AccessEngine& engine) {
+                        engine.addFloor(floorId, intToClearanceLevel(level));
+                        engine.setFloorSchedule(*floor);
+                    });
                     std::cout << "Clearance level updated." << std::endl;
                 } else {
                     std::cout << "Invalid clearance level." << std::endl;
@@ -416,11 +679,331 @@ void SystemManager::manageFloor() {
                 std::cout << "Invalid input." << std::endl;
             }
         } else if (choice == "4") {
+            manageFloorExceptions(*floor);
+        } else if (choice == "5") {
+            manageFloorSchedule(*floor);
+        } else if (choice == "6") {
+            manageFloorSite(floorNode);
+        } else if (choice == "7") {
             return;
         }
     }
 }
 
+void SystemManager::manageFloorExceptions(Floor& floor) {
+    while (true) {
+        std::cout << "\n=== Allow/Deny Lists: " << floor.getName() << " ===" << std::endl;
+        std::cout << "Allowed below clearance: " << floor.getAllowList().cardinality()
+                  << ", Denied: " << floor.getDenyList().cardinality() << std::endl;
+        std::cout << "1. Allow users" << std::endl;
+        std::cout << "2. Deny users" << std::endl;
+        std::cout << "3. Remove users from both lists" << std::endl;
+        std::cout << "4. Show lists" << std::endl;
+        std::cout << "5. Back" << std::endl;
+        std::cout << "Choice: ";
+
+        std::string choice;
+        std::getline(std::cin, choice);
+        checkSaveCommand(choice);
+
+        if (choice == "1" || choice == "2" || choice == "3") {
+            std::cout << "Enter IDs, names or card IDs (comma-separated), "
+                      << "or level:<0-3> for everyone at a level: ";
+            std::string spec;
+            std::getline(std::cin, spec);
+            checkSaveCommand(spec);
+
+            RoaringBitmap group;
+            if (!collectUsers(spec, group)) {
+                std::cout << "No matching users." << std::endl;
+                continue;
+            }
+            if (choice == "1") {
+                floor.allowUsers(group);
+            } else if (choice == "2") {
+                floor.denyUsers(group);
+            } else {
+                floor.clearExceptions(group);
+            }
+            publishFloorExceptions(floor);
+            saveFloorExceptions();
+            std::cout << group.cardinality() << " user(s) updated." << std::endl;
+        } else if (choice == "4") {
+            showFloorExceptions(floor);
+        } else if (choice == "5") {
+            return;
+        }
+    }
+}
+
+void SystemManager::showFloorExceptions(const Floor& floor) {
+    std::lock_guard<std::mutex> lock(systemMutex);
+    auto show = [&](const char* title, const RoaringBitmap& list) {
+        std::cout << "\n" << title << " (" << list.cardinality() << "):" << std::endl;
+        size_t shown = 0;
+        list.forEach([&](UserHandle user) {
+            if (shown++ < EXCEPTION_DISPLAY_LIMIT && users.contains(user)) {
+                std::cout << "  " << std::left << std::setw(15) << users.getId(user)
+                          << users.getName(user) << std::endl;
+            }
+        });
+        if (shown > EXCEPTION_DISPLAY_LIMIT) {
+            std::cout << "  ... and " << (shown - EXCEPTION_DISPLAY_LIMIT) << " more" << std::endl;
+        }
+    };
+    show("Allowed below clearance", floor.getAllowList());
+    show("Denied", floor.getDenyList());
+}
+
+void SystemManager::showFloorSite(SiteId floorNode) {
+    std::cout << "\n=== Zones and Doors: " << site.getName(floorNode) << " ===" << std::endl;
+    if (site.getChildren(floorNode).empty()) {
+        std::cout << "(none)" << std::endl;
+        return;
+    }
+
+    // Depth-first, children in the order they were added
+    std::vector<std::pair<SiteId, int>> stack;
+    const std::vector<SiteId>& top = site.getChildren(floorNode);
+    for (auto it = top.rbegin(); it != top.rend(); ++it) stack.push_back({*it, 0});
+    size_t shown = 0;
+    while (!stack.empty() && shown < SITE_DISPLAY_LIMIT) {
+        SiteId node = stack.back().first;
+        int depth = stack.back().second;
+        stack.pop_back();
+        std::cout << std::string(2 * depth, ' ')
+                  << (site.getKind(node) == SiteKind::ZONE ? "Zone " : "Door ")
+                  << site.getId(node) << " - " << site.getName(node)
+                  << " (Minimum: " << clearanceLevelToInt(site.getMinimum(node));
+        if (site.hasPolicy(node)) {
+            std::cout << ", own " << clearanceLevelToInt(site.getPolicy(node));
+        }
+        std::cout << ")" << std::endl;
+        ++shown;
+        const std::vector<SiteId>& children = site.getChildren(node);
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            stack.push_back({*it, depth + 1});
+        }
+    }
+    if (!stack.empty()) {
+        std::cout << "... (showing the first " << SITE_DISPLAY_LIMIT << ")" << std::endl;
+    }
+}
+
+void SystemManager::manageFloorSite(SiteId floorNode) {
+    while (true) {
+        std::cout << "\n=== Zones and Doors (" << site.doorCount() << " doors on site) ===" << std::endl;
+        std::cout << "1. Show zones and doors" << std::endl;
+        std::cout << "2. Add zone" << std::endl;
+        std::cout << "3. Add door" << std::endl;
+        std::cout << "4. Set minimum clearance" << std::endl;
+        std::cout << "5. Remove zone or door" << std::endl;
+        std::cout << "6. Back" << std::endl;
+        std::cout << "Choice: ";
+
+        std::string choice;
+        std::getline(std::cin, choice);
+        checkSaveCommand(choice);
+
+        if (choice == "1") {
+            showFloorSite(floorNode);
+        } else if (choice == "2" || choice == "3") {
+            std::cout << "Parent zone ID (blank for the floor): ";
+            std::string parentId;
+            std::getline(std::cin, parentId);
+            checkSaveCommand(parentId);
+            SiteId parent = parentId.empty() ? floorNode : site.findById(parentId);
+            if (parent == NO_SITE || site.getKind(parent) != (parentId.empty() ? SiteKind::FLOOR : SiteKind::ZONE) ||
+                site.getFloorOf(parent) != floorNode) {
+                std::cout << "No such zone on this floor." << std::endl;
+                continue;
+            }
+
+            std::cout << "ID (up to " << SITE_ID_MAX << " characters): ";
+            std::string id;
+            std::getline(std::cin, id);
+            checkSaveCommand(id);
+            std::cout << "Name: ";
+            std::string name;
+            std::getline(std::cin, name);
+            checkSaveCommand(name);
+
+            SiteId node = (choice == "2") ? site.addZone(parent, id, name)
+                                          : site.addDoor(parent, id, name);
+            if (node == NO_SITE) {
+                continue;
+            }
+            if (choice == "3") {
+                publishDoors(node);
+            }
+            std::cout << (choice == "2" ? "Zone" : "Door") << " added." << std::endl;
+        } else if (choice == "4") {
+            std::cout << "Zone or door ID: ";
+            std::string id;
+            std::getline(std::cin, id);
+            checkSaveCommand(id);
+            SiteId node = site.findById(id);
+            if (node == NO_SITE || site.getKind(node) == SiteKind::FLOOR ||
+                site.getFloorOf(node) != floorNode) {
+                std::cout << "No such zone or door on this floor." << std::endl;
+                continue;
+            }
+
+            std::cout << "Minimum clearance (0-3, or 'none'): ";
+            std::string levelStr;
+            std::getline(std::cin, levelStr);
+            checkSaveCommand(levelStr);
+            if (levelStr == "none") {
+                site.clearPolicy(node);
+            } else {
+                try {
+                    int level = std::stoi(levelStr);
+                    if (level < 0 || level > 3) {
+                        std::cout << "Invalid clearance level." << std::endl;
+                        continue;
+                    }
+                    site.setPolicy(node, intToClearanceLevel(level));
+                } catch (...) {
+                    std::cout << "Invalid input." << std::endl;
+                    continue;
+                }
+            }
+            publishDoors(node);
+            std::cout << "Minimum clearance updated." << std::endl;
+        } else if (choice == "5") {
+            std::cout << "Zone or door ID: ";
+            std::string id;
+            std::getline(std::cin, id);
+            checkSaveCommand(id);
+            SiteId node = site.findById(id);
+            if (node == NO_SITE || site.getKind(node) == SiteKind::FLOOR ||
+                site.getFloorOf(node) != floorNode) {
+                std::cout << "No such zone or door on this floor." << std::endl;
+                continue;
+            }
+
+            // Readers forget the doors before the IDs can be reused
+            std::vector<std::string> doorIds;
+            site.forEachDoor(node, [&](SiteId door) { doorIds.push_back(site.getId(door)); });
+            site.remove(node);
+            {
+                std::lock_guard<std::mutex> lock(systemMutex);
+                accessTables.update([&](AccessEngine& engine) {
+                    for (const auto& doorId : doorIds) engine.removeDoor(doorId);
+                });
+            }
+            std::cout << "Removed " << id << " (" << doorIds.size() << " door(s))." << std::endl;
+        } else if (choice == "6") {
+            return;
+        } else {
+            std::cout << "Invalid choice." << std::endl;
+        }
+    }
+}
+
+void SystemManager::manageFloorSchedule(Floor& floor) {
+    while (true) {
+        const AccessSchedule& schedule = floor.getSchedule();
+        std::cout << "\n=== Access Schedule: " << floor.getName() << " ===" << std::endl;
+        std::cout << "Outside scheduled windows: level "
+                  << clearanceLevelToInt(schedule.getBaseLevel()) << std::endl;
+        std::cout << "Required now: level "
+                  << clearanceLevelToInt(floor.getRequiredClearanceAt(getCurrentEpochSeconds()))
+                  << std::endl;
+        std::cout << "Windows (later ones win where they overlap):" << std::endl;
+        const auto& rules = schedule.getRules();
+        if (rules.empty()) {
+            std::cout << "  (none)" << std::endl;
+        }
+        for (size_t i = 0; i < rules.size(); ++i) {
+            std::cout << "  " << (i + 1) << ". " << AccessSchedule::describe(rules[i]) << std::endl;
+        }
+
+        std::cout << "\nOptions:" << std::endl;
+        std::cout << "1. Add window" << std::endl;
+        std::cout << "2. Edit window" << std::endl;
+        std::cout << "3. Remove window" << std::endl;
+        std::cout << "4. Back" << std::endl;
+        std::cout << "Choice: ";
+
+        std::string choice;
+        std::getline(std::cin, choice);
+        checkSaveCommand(choice);
+
+        if (choice == "4") return;
+        if (choice != "1" && choice != "2" && choice != "3") continue;
+
+        size_t index = 0;
+        if (choice != "1") {
+            std::cout << "Enter window number: ";
+            std::string numStr;
+            std::getline(std::cin, numStr);
+            checkSaveCommand(numStr);
+            try {
+                int num = std::stoi(numStr);
+                if (num < 1 || num > static_cast<int>(rules.size())) throw std::out_of_range(numStr);
+                index = static_cast<size_t>(num - 1);
+            } catch (const std::exception& e) {
+                std::cout << "Invalid window number." << std::endl;
+                continue;
+            }
+        }
+
+        ScheduleRule rule;
+        if (choice == "1") {
+            if (!readScheduleRule(rule)) continue;
+            floor.addScheduleRule(rule);
+            std::cout << "Window added." << std::endl;
+        } else if (choice == "2") {
+            if (!readScheduleRule(rule)) continue;
+            floor.replaceScheduleRule(index, rule);
+            std::cout << "Window updated." << std::endl;
+        } else {
+            floor.removeScheduleRule(index);
+            std::cout << "Window removed." << std::endl;
+        }
+        accessTables.update([&](AccessEngine& engine) {
+            engine.setFloorSchedule(floor);
+        });
+    }
+}
+
+bool SystemManager::readScheduleRule(ScheduleRule& rule) {
+    std::string days, start, end, levelStr;
+    std::cout << "Days (e.g. Mon-Fri, Sat,Sun or all): ";
+    std::getline(std::cin, days);
+    checkSaveCommand(days);
+    if (!AccessSchedule::parseDays(days, rule.days)) {
+        std::cout << "Invalid days." << std::endl;
+        return false;
+    }
+
+    std::cout << "Opens at (HH:MM): ";
+    std::getline(std::cin, start);
+    checkSaveCommand(start);
+    std::cout << "Closes at (HH:MM, earlier than opening runs past midnight): ";
+    std::getline(std::cin, end);
+    checkSaveCommand(end);
+    if (!AccessSchedule::parseTime(start, rule.startMinute) ||
+        !AccessSchedule::parseTime(end, rule.endMinute)) {
+        std::cout << "Invalid time." << std::endl;
+        return false;
+    }
+
+    std::cout << "Required clearance inside the window (0-3): ";
+    std::getline(std::cin, levelStr);
+    checkSaveCommand(levelStr);
+    try {
+        int level = std::stoi(levelStr);
+        if (level < 0 || level > 3) throw std::out_of_range(levelStr);
+        rule.level = intToClearanceLevel(level);
+    } catch (const std::exception& e) {
+        std::cout << "Invalid clearance level." << std::endl;
+        return false;
+    }
+    return true;
+}
+
 void SystemManager::listUsers() {
     std::cout << "\n=== All Users ===" << std::endl;
     std::cout << std::left << std::setw(10) << "ID" 
@@ -429,12 +1012,13 @@ void SystemManager::listUsers() {
               << "Clearance" << std::endl;
     std::cout << std::string(80, '-') << std::endl;
     
-    for (const auto& user : users) {
-        std::cout << std::left << std::setw(10) << user->getId()
-                  << std::setw(25) << user->getName()
-                  << std::setw(30) << user->getEmail()
-                  << user->getCard()->getClearanceLevelInt() << std::endl;
-    }
+    // One pass over the record array, fields read straight from the pool
+    users.forEach([this](UserHandle user) {
+        std::cout << std::left << std::setw(10) << users.getId(user)
+                  << std::setw(25) << users.getName(user)
+                  << std::setw(30) << users.getEmail(user)
+                  << clearanceLevelToInt(users.getClearanceLevel(user)) << std::endl;
+    });
     
     std::cout << "\nEnter user ID or name to manage (or 'back' to return): ";
     std::string searchTerm;
@@ -443,28 +1027,74 @@ void SystemManager::listUsers() {
     
     if (searchTerm == "back") return;
     
-    auto user = findUser(searchTerm);
-    if (user) {
+    if (findUser(searchTerm) != NO_USER) {
         manageUser();
     } else {
         std::cout << "User not found." << std::endl;
     }
 }
 
+void SystemManager::searchUsers() {
+    std::cout << "\n=== Search Users ===" << std::endl;
+    std::cout << "Enter part of an ID, name or email: ";
+    std::string query;
+    std::getline(std::cin, query);
+    checkSaveCommand(query);
+
+    std::vector<SearchHit> hits = findUsers(query, SEARCH_RESULT_LIMIT);
+    if (hits.empty()) {
+        std::cout << "No matching users." << std::endl;
+        return;
+    }
+
+    std::cout << std::left << std::setw(4) << "#"
+              << std::setw(10) << "ID"
+              << std::setw(25) << "Name"
+              << "Email" << std::endl;
+    std::cout << std::string(80, '-') << std::endl;
+    for (size_t i = 0; i < hits.size(); ++i) {
+        std::cout << std::left << std::setw(4) << (i + 1)
+                  << std::setw(10) << users.getId(hits[i].user)
+                  << std::setw(25) << users.getName(hits[i].user)
+                  << users.getEmail(hits[i].user) << std::endl;
+    }
+
+    std::cout << "\nEnter a number to manage that user (or 'back' to return): ";
+    std::string choice;
+    std::getline(std::cin, choice);
+    checkSaveCommand(choice);
+
+    if (choice == "back") return;
+
+    try {
+        int number = std::stoi(choice);
+        if (number >= 1 && static_cast<size_t>(number) <= hits.size()) {
+            manageUser(hits[number - 1].user);
+            return;
+        }
+    } catch (const std::exception& e) {
+        // Not a number; reported below
+    }
+    std::cout << "Invalid choice." << std::endl;
+}
+
 void SystemManager::manageUser() {
     std::cout << "Enter user ID or name: ";
     std::string searchTerm;
     std::getline(std::cin, searchTerm);
     checkSaveCommand(searchTerm);
     
-    auto user = findUser(searchTerm);
-    if (!user) {
+    UserHandle user = findUser(searchTerm);
+    if (user == NO_USER) {
         std::cout << "User not found." << std::endl;
         return;
     }
-    
+    manageUser(user);
+}
+
+void SystemManager::manageUser(UserHandle user) {
     while (true) {
-        std::cout << "\n=== Manage User: " << user->getName() << " ===" << std::endl;
+        std::cout << "\n=== Manage User: " << users.getName(user) << " ===" << std::endl;
         std::cout << "1. Change name" << std::endl;
         std::cout << "2. Change email" << std::endl;
         std::cout << "3. Change phone" << std::endl;
@@ -481,8 +1111,11 @@ void SystemManager::manageUser() {
             std::string newName;
             std::getline(std::cin, newName);
             checkSaveCommand(newName);
-            user->setName(newName);
-            std::cout << "Name updated." << std::endl;
+            if (renameUser(user, newName)) {
+                std::cout << "Name updated." << std::endl;
+            } else {
+                std::cout << "Name too long." << std::endl;
+            }
         } else if (choice == "2") {
             std::cout << "Enter new email: ";
             std::string newEmail;
@@ -490,8 +1123,11 @@ void SystemManager::manageUser() {
             checkSaveCommand(newEmail);
             
             if (Validator::validateEmail(newEmail)) {
-                user->setEmail(newEmail);
-                std::cout << "Email updated." << std::endl;
+                if (setUserEmail(user, newEmail)) {
+                    std::cout << "Email updated." << std::endl;
+                } else {
+                    std::cout << "Email too long." << std::endl;
+                }
             } else {
                 std::cout << "Invalid email format." << std::endl;
             }
@@ -502,8 +1138,11 @@ void SystemManager::manageUser() {
             checkSaveCommand(newPhone);
             
             if (Validator::validatePhone(newPhone)) {
-                user->setPhone(newPhone);
-                std::cout << "Phone updated." << std::endl;
+                if (setUserPhone(user, newPhone)) {
+                    std::cout << "Phone updated." << std::endl;
+                } else {
+                    std::cout << "Phone too long." << std::endl;
+                }
             } else {
                 std::cout << "Invalid phone format." << std::endl;
             }
@@ -517,8 +1156,6 @@ void SystemManager::manageUser() {
 }
 
 void SystemManager::createUser() {
-    std::lock_guard<std::mutex> lock(systemMutex);
-    
     std::cout << "\n=== Create New User ===" << std::endl;
     
     std::cout << "Enter name: ";
@@ -558,17 +1195,33 @@ void SystemManager::createUser() {
             return;
         }
         
+        // Prompts are done; only the roster update needs the lock
+        std::lock_guard<std::mutex> lock(systemMutex);
+
         // Generate unique ID
-        std::string userId = dataManager.generateUniqueId(name, users);
-        
-        // Create card
-        std::string cardId = "CARD" + std::to_string(users.size() + 1);
-        auto card = std::make_shared<Card>(cardId, intToClearanceLevel(level));
-        
-        // Create user
-        auto newUser = std::make_shared<User>(userId, name, email, phone, card);
-        users.push_back(newUser);
+        std::string userId = dataManager.generateUniqueId(name);
         
+        // Create user; the card lives in the user's record. After deletions
+        // CARD<n+1> may still be held by someone, so take the next free one.
+        size_t cardNumber = users.size() + 1;
+        while (cardIndex.find("CARD" + std::to_string(cardNumber)) != NO_USER) {
+            ++cardNumber;
+        }
+        std::string cardId = "CARD" + std::to_string(cardNumber);
+        UserHandle user = users.add(userId, name, email, phone, cardId, intToClearanceLevel(level));
+        if (user == NO_USER) {
+            dataManager.releaseId(userId);
+            std::cout << "Name, email or phone too long. User not created." << std::endl;
+            return;
+        }
+        cardIndex.add(cardId, user);
+        if (userSearchBuilt) userSearch.add(users, user);
+        publishUsers();
+        userCache.invalidate();  // Cached misses may now match
+        accessTables.update([&](AccessEngine& engine) {
+            engine.addCard(cardId, userId, intToClearanceLevel(level));
+        });
+
         std::cout << "User created successfully with ID: " << userId << std::endl;
     } catch (const std::exception& e) {
         std::cout << "Error creating user: " << e.what() << std::endl;
@@ -576,25 +1229,46 @@ void SystemManager::createUser() {
 }
 
 void SystemManager::deleteUser() {
-    std::lock_guard<std::mutex> lock(systemMutex);
-    
     std::cout << "Enter user ID to delete: ";
     std::string userId;
     std::getline(std::cin, userId);
     checkSaveCommand(userId);
     
-    auto it = std::find_if(users.begin(), users.end(),
-        [&userId](const std::shared_ptr<User>& u) { return u->getId() == userId; });
-    
-    if (it != users.end()) {
-        std::cout << "Are you sure you want to delete user " 
-                  << (*it)->getName() << "? (yes/no): ";
+    UserHandle user;
+    {
+        std::lock_guard<std::mutex> lock(systemMutex);
+        user = findUserById(userId);
+    }
+
+    if (user != NO_USER) {
+        std::cout << "Are you sure you want to delete user "
+                  << users.getName(user) << "? (yes/no): ";
         std::string confirm;
         std::getline(std::cin, confirm);
         checkSaveCommand(confirm);
-        
+
         if (confirm == "yes") {
-            users.erase(it);
+            bool listed = false;
+            {
+                std::lock_guard<std::mutex> lock(systemMutex);
+                std::string cardId(users.getCardId(user));
+                cardIndex.remove(cardId);
+                removeUser(user);
+                RoaringBitmap deleted;
+                deleted.add(user);
+                site.forEachFloor([&](Floor& floor) {
+                    listed = listed || floor.getAllowList().contains(user) ||
+                             floor.getDenyList().contains(user);
+                    floor.clearExceptions(deleted);
+                });
+                accessTables.update([&](AccessEngine& engine) {
+                    engine.revokeCard(cardId);
+                });
+                publishUsers();
+                userCache.invalidate();  // Cached lookups may point at the deleted user
+            }
+            // A later user given the same ID must not inherit the entries
+            if (listed) saveFloorExceptions();
             std::cout << "User and their card deleted successfully." << std::endl;
         } else {
             std::cout << "Deletion cancelled." << std::endl;
@@ -608,41 +1282,320 @@ void SystemManager::deleteUser() {
 // FILE: src/SystemManager.cpp (Part 4 - Helper Functions)
 // ============================================================================
 
-std::shared_ptr<User> SystemManager::findUser(const std::string& searchTerm) {
-    // Check cache first
+UserHandle SystemManager::findUser(const std::string& searchTerm) {
+    ScopedTimer timer(*findUserLatency);
+
+    // Check cache first (a cached NO_USER is a known miss)
     auto cachedUser = userCache.get(searchTerm);
     if (cachedUser) {
         return *cachedUser;
     }
     
-    // Search in users list
-    for (const auto& user : users) {
-        if (user->getId() == searchTerm || user->getName() == searchTerm) {
-            userCache.put(searchTerm, user);  // Add to cache
-            return user;
+    // Exact ID first, then exact name, in the published roster: no lock, so
+    // an admin edit never holds a login up
+    auto roster = userTables.read();
+    UserHandle user = roster->findById(searchTerm);
+    if (user == NO_USER) user = roster->findByName(searchTerm);
+
+    // Misses too. Writers publish before they invalidate the cache, so if a
+    // newer roster is out by now this answer may have missed the
+    // invalidate(): take it back out
+    userCache.put(searchTerm, user);
+    if (userTables.read().get() != roster.get()) {
+        userCache.erase(searchTerm);
+    }
+
+    return user;
+}
+
+UserHandle SystemManager::findUserById(const std::string& userId) {
+    return users.findById(userId);
+}
+
+std::vector<SearchHit> SystemManager::findUsers(const std::string& query, size_t limit) {
+    ScopedTimer timer(*userSearchLatency);
+
+    // Built by the first search rather than at startup: a badge-only
+    // server never pays for it. The build takes seconds for a large
+    // roster, so it runs on a copy outside the lock; roster edits only
+    // come from the menu thread, which is the one searching, so the copy
+    // can't go stale before it is swapped in
+    bool built;
+    {
+        std::lock_guard<std::mutex> lock(systemMutex);
+        built = userSearchBuilt;
+    }
+    if (!built) {
+        UserStore rosterCopy;
+        {
+            std::lock_guard<std::mutex> lock(systemMutex);
+            rosterCopy = users;
         }
+        UserSearch index;
+        index.rebuild(rosterCopy);
+
+        std::lock_guard<std::mutex> lock(systemMutex);
+        userSearch = std::move(index);
+        userSearchBuilt = true;
     }
-    
-    return nullptr;
+
+    std::lock_guard<std::mutex> lock(systemMutex);
+    return userSearch.search(users, query, limit);
+}
+
+void SystemManager::rebuildCardIndex() {
+    std::vector<CardEntry> entries;
+    entries.reserve(users.size() + 1);
+    users.forEach([&](UserHandle user) {
+        entries.push_back({users.getCardId(user), user});
+    });
+    if (admin) {
+        entries.push_back({admin->getCard()->getId(), ADMIN_USER});
+    }
+    cardIndex.build(entries);
+}
+
+const UserStore& SystemManager::getUsers() const {
+    return users;
+}
+
+void SystemManager::removeUser(UserHandle user) {
+    dataManager.releaseId(std::string(users.getId(user)));
+    if (userSearchBuilt) userSearch.remove(users, user);
+    users.remove(user);
+}
+
+void SystemManager::compactRoster() {
+    std::lock_guard<std::mutex> lock(systemMutex);
+    if (!users.needsCompaction()) return;
+
+    std::vector<UserHandle> remap = users.compact();
+    ++rosterCompactions;
+    cardIndex.remapHolders(remap);
+    if (userSearchBuilt) userSearch.remapUsers(remap);
+    site.forEachFloor([&](Floor& floor) {
+        floor.remapUsers(remap);
+    });
+    publishUsers();
+    userCache.invalidate();  // Cached handles are the old numbers
+}
+
+void SystemManager::replayJournal() {
+    auto records = dataManager.readJournal();
+    size_t rejected = 0;
+
+    for (const auto& record : records) {
+        if (record.isDelete) {
+            UserHandle user = findUserById(record.payload);
+            if (user != NO_USER) removeUser(user);
+            continue;
+        }
+
+        // Rows are exactly User::toCSV (7 fields) or Admin::toCSV (8);
+        // anything else is corrupt and would put garbage in the roster
+        auto fields = dataManager.parseCSVLine(record.payload);
+        bool isAdmin = fields.size() == 8 && fields[6] == "ADMIN";
+        if (!isAdmin && !(fields.size() == 7 && fields[6] == "USER")) {
+            ++rejected;
+            continue;
+        }
+        const std::string& level = fields[5];
+        if (level.size() != 1 || level[0] < '0' || level[0] > '3') {
+            ++rejected;
+            continue;
+        }
+        int clearance = level[0] - '0';
+        bool fits = true;
+        for (size_t i = 0; i < 5; ++i) fits = fits && UserStore::fits(fields[i]);
+        if (!fits) {
+            ++rejected;
+            continue;
+        }
+
+        if (isAdmin) {
+            auto card = std::make_shared<Card>(fields[4], intToClearanceLevel(clearance));
+            admin = std::make_shared<Admin>(fields[0], fields[1], fields[2], fields[3], card, fields[7]);
+            continue;
+        }
+
+        // Upsert by employee ID: the row replaces every field
+        UserHandle user = findUserById(fields[0]);
+        if (user != NO_USER) {
+            if (users.getName(user) != fields[1]) users.setName(user, fields[1]);
+            users.setEmail(user, fields[2]);
+            users.setPhone(user, fields[3]);
+            users.setCardId(user, fields[4]);
+            users.setClearanceLevel(user, intToClearanceLevel(clearance));
+        } else {
+            users.add(fields[0], fields[1], fields[2], fields[3], fields[4],
+                      intToClearanceLevel(clearance));
+            dataManager.reserveId(fields[0]);
+        }
+    }
+    users.drainChanges([](UserHandle, bool) {});  // Already persisted in the journal
+
+    if (!records.empty()) {
+        std::cout << "Replayed " << records.size() - rejected << " journal record(s)." << std::endl;
+    }
+    if (rejected > 0) {
+        std::cerr << "Warning: Skipped " << rejected << " corrupt journal record(s)." << std::endl;
+    }
+}
+
+// Edits go through systemMutex so the flush worker never copies a half-written user.
+// Each returns false, changing nothing, if the value is too long to store.
+bool SystemManager::renameUser(UserHandle user, const std::string& newName) {
+    if (!UserStore::fits(newName)) return false;
+    std::lock_guard<std::mutex> lock(systemMutex);
+    if (userSearchBuilt) userSearch.remove(users, user);  // Indexed under the old name
+    users.setName(user, newName);
+    if (userSearchBuilt) userSearch.add(users, user);
+    publishUsers();
+    userCache.invalidate();  // Cached name lookups and misses may now be stale
+    return true;
+}
+
+bool SystemManager::setUserEmail(UserHandle user, const std::string& newEmail) {
+    if (!UserStore::fits(newEmail)) return false;
+    std::lock_guard<std::mutex> lock(systemMutex);
+    if (userSearchBuilt) userSearch.remove(users, user);
+    users.setEmail(user, newEmail);
+    if (userSearchBuilt) userSearch.add(users, user);
+    return true;
+}
+
+bool SystemManager::setUserPhone(UserHandle user, const std::string& newPhone) {
+    std::lock_guard<std::mutex> lock(systemMutex);
+    return users.setPhone(user, newPhone);
+}
+
+bool SystemManager::collectUsers(const std::string& spec, RoaringBitmap& group) {
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item.erase(0, item.find_first_not_of(' '));
+        item.erase(item.find_last_not_of(' ') + 1);
+        if (item.empty()) continue;
+
+        if (item.compare(0, 6, "level:") == 0) {
+            int level = -1;
+            try {
+                level = std::stoi(item.substr(6));
+            } catch (...) {
+                // Reported below
+            }
+            if (level < 0 || level > 3) {
+                std::cout << "Invalid clearance level: " << item << std::endl;
+                continue;
+            }
+            ClearanceLevel clearance = intToClearanceLevel(level);
+            std::lock_guard<std::mutex> lock(systemMutex);
+            users.forEach([&](UserHandle user) {
+                if (users.getClearanceLevel(user) == clearance) group.add(user);
+            });
+            continue;
+        }
+
+        UserHandle user = findUser(item);
+        if (user == NO_USER) {
+            std::cout << "User not found: " << item << std::endl;
+        } else {
+            group.add(user);
+        }
+    }
+    return !group.empty();
 }
 
-Floor* SystemManager::findFloor(const std::string& searchTerm) {
-    // Try to find by name first
-    for (auto& floor : floors) {
-        if (floor.getName() == searchTerm) {
-            return &floor;
+void SystemManager::publishFloorExceptions(const Floor& floor) {
+    std::lock_guard<std::mutex> lock(systemMutex);
+    accessTables.update([&](AccessEngine& engine) {
+        engine.setFloorExceptions(floor, users);
+    });
+}
+
+void SystemManager::saveFloorExceptions() {
+    std::vector<FloorException> exceptions;
+    {
+        std::lock_guard<std::mutex> lock(systemMutex);
+        site.forEachFloor([&](const Floor& floor) {
+            auto add = [&](const RoaringBitmap& list, bool allowed) {
+                list.forEach([&](UserHandle user) {
+                    if (users.contains(user)) {
+                        exceptions.push_back({floor.getId(), std::string(users.getId(user)), allowed});
+                    }
+                });
+            };
+            add(floor.getAllowList(), true);
+            add(floor.getDenyList(), false);
+        });
+    }
+    dataManager.saveFloorExceptions(exceptions);
+}
+
+void SystemManager::loadFloorExceptions() {
+    std::vector<FloorException> exceptions = dataManager.loadFloorExceptions();
+    if (exceptions.empty()) return;
+
+    // Group by floor so each list is applied as one bitmap
+    std::map<std::string, std::pair<RoaringBitmap, RoaringBitmap>> byFloor;
+    size_t dropped = 0;
+    for (const auto& exception : exceptions) {
+        UserHandle user = findUserById(exception.userId);
+        SiteId floor = site.findById(exception.floorId);
+        if (user == NO_USER || floor == NO_SITE || site.getKind(floor) != SiteKind::FLOOR) {
+            ++dropped;
+            continue;
         }
+        auto& lists = byFloor[exception.floorId];
+        (exception.allowed ? lists.first : lists.second).add(user);
+    }
+    for (auto& entry : byFloor) {
+        Floor& floor = site.getFloor(site.findById(entry.first));
+        floor.allowUsers(entry.second.first);
+        floor.denyUsers(entry.second.second);
+    }
+    if (dropped > 0) {
+        std::cerr << "Warning: Dropped " << dropped << " entr" << (dropped == 1 ? "y" : "ies")
+                  << " for unknown floors or users from " << EXCEPTIONS_FILE << "." << std::endl;
+    }
+}
+
+SiteId SystemManager::findFloor(const std::string& searchTerm) {
+    // Try to find by name first, then by ID
+    SiteId floor = site.findByName(searchTerm, SiteKind::FLOOR);
+    if (floor != NO_SITE) {
+        return floor;
+    }
+    floor = site.findById(searchTerm);
+    if (floor != NO_SITE && site.getKind(floor) == SiteKind::FLOOR) {
+        return floor;
     }
     
     // Try to find by number
     try {
         int num = std::stoi(searchTerm);
-        if (num >= 1 && num <= static_cast<int>(floors.size())) {
-            return &floors[num - 1];
+        if (num >= 1) {
+            return site.floorAt(static_cast<size_t>(num));
         }
     } catch (...) {
         // Not a number, continue
     }
     
-    return nullptr;
+    return NO_SITE;
+}
+
+SiteModel& SystemManager::getSite() {
+    return site;
+}
+
+void SystemManager::publishDoors(SiteId root) {
+    std::lock_guard<std::mutex> lock(systemMutex);
+    accessTables.update([&](AccessEngine& engine) {
+        site.forEachDoor(root, [&](SiteId door) {
+            FloorHandle floor;
+            if (engine.findFloor(site.getFloor(door).getId(), floor)) {
+                engine.addDoor(site.getId(door), floor, site.getMinimum(door));
+            }
+        });
+    });
 }
\ No newline at end of file
@@ -4,21 +4,25 @@
 
 #include "User.h"
 
-User::User(const std::string& userId, const std::string& userName,
-           const std::string& userEmail, const std::string& userPhone,
+User::User(std::string userId, std::string userName,
+           std::string userEmail, std::string userPhone,
            std::shared_ptr<Card> userCard)
-    : id(userId), name(userName), email(userEmail), 
-      phone(userPhone), card(userCard) {}
+    : id(std::move(userId)), name(std::move(userName)), email(std::move(userEmail)),
+      phone(std::move(userPhone)), card(std::move(userCard)), dirty(false) {}
 
-std::string User::getId() const { return id; }
-std::string User::getName() const { return name; }
-std::string User::getEmail() const { return email; }
-std::string User::getPhone() const { return phone; }
+const std::string& User::getId() const { return id; }
+const std::string& User::getName() const { return name; }
+const std::string& User::getEmail() const { return email; }
+const std::string& User::getPhone() const { return phone; }
 std::shared_ptr<Card> User::getCard() const { return card; }
 
-void User::setName(const std::string& newName) { name = newName; }
-void User::setEmail(const std::string& newEmail) { email = newEmail; }
-void User::setPhone(const std::string& newPhone) { phone = newPhone; }
+void User::setName(const std::string& newName) { name = newName; dirty = true; }
+void User::setEmail(const std::string& newEmail) { email = newEmail; dirty = true; }
+void User::setPhone(const std::string& newPhone) { phone = newPhone; dirty = true; }
+
+bool User::isDirty() const { return dirty; }
+void User::markDirty() { dirty = true; }
+void User::clearDirty() { dirty = false; }
 
 void User::displayInfo() const {
     std::cout << "\n=== Employee Information ===" << std::endl;
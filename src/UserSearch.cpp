@@ -0,0 +1,688 @@
+// ============================================================================
+// FILE: src/UserSearch.cpp
+// Description: Implementation of the roster search index
+// ============================================================================
+
+#include "UserSearch.h"
+#include <queue>
+#include <unordered_set>
+
+namespace {
+
+// Typos forgiven in a word of this length (short words must match as typed)
+uint32_t editsAllowed(size_t length) {
+    if (length < 4) return 0;
+    return length < 8 ? 1 : 2;
+}
+
+uint32_t packScore(uint32_t edits, uint32_t prefixes, uint32_t completion) {
+    return (std::min<uint32_t>(edits, 0xFF) << 24) | (std::min<uint32_t>(prefixes, 0xFF) << 16) |
+           std::min<uint32_t>(completion, 0xFFFF);
+}
+
+void lowercaseInPlace(std::string& text) {
+    for (char& c : text) c = static_cast<char>(::tolower(static_cast<unsigned char>(c)));
+}
+
+// Distinct trigrams of "\0\0" + text + "\0", three bytes packed per trigram
+std::vector<uint32_t> trigramsOf(const std::string& text) {
+    std::string padded(2, '\0');
+    padded += text;
+    padded += '\0';
+    std::vector<uint32_t> grams;
+    grams.reserve(text.size() + 1);
+    for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+        grams.push_back((static_cast<uint32_t>(static_cast<unsigned char>(padded[i])) << 16) |
+                        (static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 1])) << 8) |
+                        static_cast<unsigned char>(padded[i + 2]));
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+}  // namespace
+
+UserSearch::UserSearch() {
+    clear();
+}
+
+size_t UserSearch::userTerms(const UserStore& users, UserHandle user, std::vector<Term>& terms) {
+    size_t used = 0;
+    auto put = [&](std::string_view text, bool fuzzy) {
+        if (used == terms.size()) terms.emplace_back();
+        Term& term = terms[used++];
+        term.text.assign(text.data(), text.size());
+        lowercaseInPlace(term.text);
+        term.fuzzy = fuzzy;
+    };
+
+    std::string_view id = users.getId(user);
+    if (!id.empty()) put(id, false);
+
+    std::string_view name = users.getName(user);
+    size_t pos = 0;
+    while (pos < name.size()) {
+        while (pos < name.size() && ::isspace(static_cast<unsigned char>(name[pos]))) ++pos;
+        size_t end = pos;
+        while (end < name.size() && !::isspace(static_cast<unsigned char>(name[end]))) ++end;
+        if (end > pos) put(name.substr(pos, end - pos), true);
+        pos = end;
+    }
+
+    std::string_view email = users.getEmail(user);
+    if (!email.empty()) put(email, true);
+    return used;
+}
+
+uint32_t UserSearch::newNode(uint32_t labelStart, size_t labelLength, size_t depth) {
+    // Terms come from StringPool fields, so lengths fit in 16 bits
+    char first = labelLength ? labels[labelStart] : '\0';
+    nodes.push_back({labelStart, NO_NODE, NO_NODE, 0, 0, 0, NO_NODE,
+                     static_cast<uint16_t>(labelLength), static_cast<uint16_t>(depth), first, false});
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+uint32_t UserSearch::childStartingWith(uint32_t node, char first) const {
+    const unsigned char wanted = static_cast<unsigned char>(first);
+    for (uint32_t child = nodes[node].firstChild; child != NO_NODE; child = nodes[child].nextSibling) {
+        unsigned char have = static_cast<unsigned char>(nodes[child].first);
+        if (have == wanted) return child;
+        if (have > wanted) break;
+    }
+    return NO_NODE;
+}
+
+void UserSearch::linkChild(uint32_t parent, uint32_t child) {
+    const unsigned char first = static_cast<unsigned char>(nodes[child].first);
+    uint32_t prev = NO_NODE;
+    uint32_t next = nodes[parent].firstChild;
+    while (next != NO_NODE && static_cast<unsigned char>(nodes[next].first) < first) {
+        prev = next;
+        next = nodes[next].nextSibling;
+    }
+    nodes[child].nextSibling = next;
+    if (prev == NO_NODE) {
+        nodes[parent].firstChild = child;
+    } else {
+        nodes[prev].nextSibling = child;
+    }
+}
+
+uint32_t UserSearch::findPrefix(std::string_view text) const {
+    uint32_t node = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        node = childStartingWith(node, text[pos]);
+        if (node == NO_NODE) return NO_NODE;
+        const Node& n = nodes[node];
+        size_t length = std::min<size_t>(n.labelLength, text.size() - pos);
+        if (labels.compare(n.labelStart, length, text.data() + pos, length) != 0) return NO_NODE;
+        pos += length;
+    }
+    return node;
+}
+
+uint32_t UserSearch::findTerm(std::string_view text, std::vector<uint32_t>& path) const {
+    path.assign(1, 0);
+    uint32_t node = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        node = childStartingWith(node, text[pos]);
+        if (node == NO_NODE) return NO_NODE;
+        const Node& n = nodes[node];
+        if (n.labelLength > text.size() - pos ||
+            labels.compare(n.labelStart, n.labelLength, text.data() + pos, n.labelLength) != 0) {
+            return NO_NODE;
+        }
+        pos += n.labelLength;
+        path.push_back(node);
+    }
+    return node;
+}
+
+uint32_t UserSearch::insertTerm(std::string_view text, std::vector<uint32_t>& path) {
+    path.assign(1, 0);
+    uint32_t node = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        uint32_t child = childStartingWith(node, text[pos]);
+        if (child == NO_NODE) {
+            uint32_t start = static_cast<uint32_t>(labels.size());
+            labels.append(text.data() + pos, text.size() - pos);
+            uint32_t leaf = newNode(start, text.size() - pos, text.size());
+            linkChild(node, leaf);
+            path.push_back(leaf);
+            return leaf;
+        }
+
+        const Node edge = nodes[child];
+        size_t limit = std::min<size_t>(edge.labelLength, text.size() - pos);
+        size_t shared = 1;
+        while (shared < limit && labels[edge.labelStart + shared] == text[pos + shared]) ++shared;
+
+        if (shared < edge.labelLength) {
+            // Split the edge: child keeps the shared part (and its hub, as
+            // the users below don't change), a new node takes the rest of
+            // the label, the term and everything under it
+            uint32_t lower = newNode(edge.labelStart + static_cast<uint32_t>(shared),
+                                     edge.labelLength - shared, edge.depth);
+            Node& moved = nodes[lower];
+            moved.firstChild = edge.firstChild;
+            moved.postings = edge.postings;
+            moved.count = edge.count;
+            moved.users = edge.users;
+            moved.listed = edge.listed;
+
+            Node& upper = nodes[child];
+            upper.labelLength = static_cast<uint16_t>(shared);
+            upper.depth = static_cast<uint16_t>(edge.depth - (edge.labelLength - shared));
+            upper.firstChild = lower;
+            upper.count = 0;
+            upper.users = 0;
+            upper.listed = false;
+
+            auto fuzzy = fuzzyByNode.find(child);
+            if (fuzzy != fuzzyByNode.end()) {
+                uint32_t index = fuzzy->second;
+                fuzzyByNode.erase(fuzzy);
+                fuzzyByNode[lower] = index;
+                fuzzyTerms[index].node = lower;
+            }
+        }
+        node = child;
+        pos += shared;
+        path.push_back(node);
+    }
+    return node;
+}
+
+uint32_t UserSearch::markFuzzy(uint32_t node, const std::string& text) {
+    auto known = fuzzyByNode.find(node);
+    if (known != fuzzyByNode.end()) return known->second;
+
+    uint32_t index = static_cast<uint32_t>(fuzzyTerms.size());
+    fuzzyByNode[node] = index;
+    fuzzyTerms.push_back({text, node});
+    for (uint32_t gram : trigramsOf(text)) trigrams[gram].push_back(index);
+    return index;
+}
+
+bool UserSearch::insertUser(uint32_t node, UserHandle user) {
+    Node& n = nodes[node];
+    if (!n.listed) {
+        if (n.count == 0) {
+            n.users = user;
+            n.count = 1;
+            return true;
+        }
+        if (n.users == user) return false;
+
+        // A second holder: the term gets a bitmap
+        RoaringBitmap both;
+        both.add(n.users);
+        both.add(user);
+        holders.push_back(std::move(both));
+        n.users = static_cast<uint32_t>(holders.size() - 1);
+        n.listed = true;
+        n.count = 2;
+        return true;
+    }
+
+    if (!holders[n.users].add(user)) return false;
+    ++n.count;
+    return true;
+}
+
+bool UserSearch::eraseUser(uint32_t node, UserHandle user) {
+    Node& n = nodes[node];
+    if (!n.listed) {
+        if (n.count == 0 || n.users != user) return false;
+        n.count = 0;
+        return true;
+    }
+
+    if (!holders[n.users].remove(user)) return false;
+    --n.count;
+    return true;
+}
+
+void UserSearch::gatherSubtree(uint32_t node, RoaringBitmap& out) const {
+    std::vector<uint32_t> stack(1, node);
+    while (!stack.empty()) {
+        const Node& n = nodes[stack.back()];
+        stack.pop_back();
+        if (n.hub != NO_NODE) {
+            out.unionWith(hubs[n.hub]);
+            continue;
+        }
+        if (n.listed) {
+            out.unionWith(holders[n.users]);
+        } else if (n.count) {
+            out.add(n.users);
+        }
+        for (uint32_t child = n.firstChild; child != NO_NODE; child = nodes[child].nextSibling) {
+            if (nodes[child].postings) stack.push_back(child);
+        }
+    }
+}
+
+void UserSearch::countPostings() {
+    // Children before parents. An edge split can leave a child with a lower
+    // index than its parent, so this walks the tree rather than the array
+    std::vector<std::pair<uint32_t, bool>> stack(1, {0, false});  // (node, children done)
+    while (!stack.empty()) {
+        auto [node, childrenDone] = stack.back();
+        stack.pop_back();
+        if (!childrenDone) {
+            stack.push_back({node, true});
+            for (uint32_t child = nodes[node].firstChild; child != NO_NODE;
+                 child = nodes[child].nextSibling) {
+                stack.push_back({child, false});
+            }
+            continue;
+        }
+
+        uint32_t postings = nodes[node].count;
+        for (uint32_t child = nodes[node].firstChild; child != NO_NODE;
+             child = nodes[child].nextSibling) {
+            postings += nodes[child].postings;
+        }
+        nodes[node].postings = postings;
+        if (postings >= SEARCH_HUB_POSTINGS) {
+            RoaringBitmap below;
+            gatherSubtree(node, below);
+            hubs.push_back(std::move(below));
+            nodes[node].hub = static_cast<uint32_t>(hubs.size() - 1);
+        }
+    }
+}
+
+void UserSearch::rebuild(const UserStore& users) {
+    clear();
+
+    // Terms and holders first, postings and hubs in one pass at the end.
+    // Name words and emails repeat a lot, so those seen before skip the
+    // trie walk (fuzzyTerms tracks their node through edge splits)
+    std::unordered_map<std::string, uint32_t> seenFuzzy;  // Term -> fuzzyTerms index
+    std::vector<Term> terms;
+    std::vector<uint32_t> path;
+    users.forEach([&](UserHandle user) {
+        size_t termTotal = userTerms(users, user, terms);
+        for (size_t i = 0; i < termTotal; ++i) {
+            const Term& term = terms[i];
+            uint32_t node;
+            if (!term.fuzzy) {
+                node = insertTerm(term.text, path);
+            } else {
+                auto seen = seenFuzzy.find(term.text);
+                if (seen != seenFuzzy.end()) {
+                    node = fuzzyTerms[seen->second].node;
+                } else {
+                    node = insertTerm(term.text, path);
+                    seenFuzzy.emplace(term.text, markFuzzy(node, term.text));
+                }
+            }
+            insertUser(node, user);
+        }
+    });
+    countPostings();
+}
+
+void UserSearch::add(const UserStore& users, UserHandle user) {
+    if (!users.contains(user)) return;
+
+    thread_local std::vector<Term> terms;
+    thread_local std::vector<uint32_t> path, touched;
+    size_t termTotal = userTerms(users, user, terms);
+    touched.clear();
+    for (size_t i = 0; i < termTotal; ++i) {
+        const Term& term = terms[i];
+        uint32_t node = insertTerm(term.text, path);
+
+        // Also when the user already holds the term non-fuzzily (an ID that
+        // is also a name word); a repeated term is only counted once
+        if (term.fuzzy) markFuzzy(node, term.text);
+        if (!insertUser(node, user)) continue;
+        for (uint32_t step : path) ++nodes[step].postings;
+        touched.insert(touched.end(), path.begin(), path.end());
+    }
+
+    // Existing hubs first, so a hub built now from the ones below is current
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (uint32_t node : touched) {
+        if (nodes[node].hub != NO_NODE) hubs[nodes[node].hub].add(user);
+    }
+    for (uint32_t node : touched) {
+        if (nodes[node].hub != NO_NODE || nodes[node].postings < SEARCH_HUB_POSTINGS) continue;
+        RoaringBitmap below;
+        gatherSubtree(node, below);
+        hubs.push_back(std::move(below));
+        nodes[node].hub = static_cast<uint32_t>(hubs.size() - 1);
+    }
+}
+
+void UserSearch::remove(const UserStore& users, UserHandle user) {
+    thread_local std::vector<Term> terms;
+    thread_local std::vector<uint32_t> path, touched;
+    size_t termTotal = userTerms(users, user, terms);
+    touched.clear();
+    for (size_t i = 0; i < termTotal; ++i) {
+        uint32_t node = findTerm(terms[i].text, path);
+        if (node == NO_NODE || !eraseUser(node, user)) continue;
+        for (uint32_t step : path) --nodes[step].postings;
+        touched.insert(touched.end(), path.begin(), path.end());
+    }
+
+    // All of the user's terms are gone, so they leave every hub above them
+    // (hubs stay once made, even if the subtree thins out)
+    for (uint32_t node : touched) {
+        if (nodes[node].hub != NO_NODE) hubs[nodes[node].hub].remove(user);
+    }
+}
+
+std::vector<std::string> UserSearch::queryWords(std::string_view query) {
+    std::vector<std::string> words;
+    size_t pos = 0;
+    while (pos < query.size()) {
+        while (pos < query.size() && ::isspace(static_cast<unsigned char>(query[pos]))) ++pos;
+        size_t end = pos;
+        while (end < query.size() && !::isspace(static_cast<unsigned char>(query[end]))) ++end;
+        if (end > pos) {
+            words.emplace_back(query.substr(pos, end - pos));
+            lowercaseInPlace(words.back());
+        }
+        pos = end;
+    }
+    return words;
+}
+
+uint32_t UserSearch::boundedDistance(const std::string& a, const std::string& b, uint32_t maxEdits) {
+    size_t la = a.size(), lb = b.size();
+    if ((la > lb ? la - lb : lb - la) > maxEdits) return maxEdits + 1;
+
+    // Two rows of the edit-distance table; give up once a row is all over
+    thread_local std::vector<uint32_t> prev, cur;
+    prev.resize(lb + 1);
+    cur.resize(lb + 1);
+    for (size_t j = 0; j <= lb; ++j) prev[j] = static_cast<uint32_t>(j);
+    for (size_t i = 1; i <= la; ++i) {
+        cur[0] = static_cast<uint32_t>(i);
+        uint32_t rowMin = cur[0];
+        for (size_t j = 1; j <= lb; ++j) {
+            uint32_t substitute = prev[j - 1] + (a[i - 1] != b[j - 1]);
+            cur[j] = std::min({substitute, prev[j] + 1, cur[j - 1] + 1});
+            rowMin = std::min(rowMin, cur[j]);
+        }
+        if (rowMin > maxEdits) return maxEdits + 1;
+        std::swap(prev, cur);
+    }
+    return std::min(prev[lb], maxEdits + 1);
+}
+
+uint32_t UserSearch::wordCost(const std::string& word, const std::string& term, bool fuzzy) {
+    if (term.size() >= word.size() && term.compare(0, word.size(), word) == 0) {
+        if (term.size() == word.size()) return 0;
+        return packScore(0, 1, static_cast<uint32_t>(term.size() - word.size()));
+    }
+    uint32_t maxEdits = editsAllowed(word.size());
+    if (fuzzy && maxEdits) {
+        uint32_t edits = boundedDistance(word, term, maxEdits);
+        if (edits <= maxEdits) return packScore(edits, 0, 0);
+    }
+    return UINT32_MAX;
+}
+
+bool UserSearch::score(const UserStore& users, UserHandle user,
+                       const std::vector<std::string>& words, uint32_t& result) {
+    if (!users.contains(user)) return false;
+
+    thread_local std::vector<Term> terms;
+    size_t termTotal = userTerms(users, user, terms);
+    uint32_t edits = 0, prefixes = 0, completion = 0;
+    for (const std::string& word : words) {
+        uint32_t best = UINT32_MAX;
+        for (size_t i = 0; i < termTotal && best; ++i) {
+            best = std::min(best, wordCost(word, terms[i].text, terms[i].fuzzy));
+        }
+        if (best == UINT32_MAX) return false;
+        edits += best >> 24;
+        prefixes += (best >> 16) & 0xFF;
+        completion += best & 0xFFFF;
+    }
+    result = packScore(edits, prefixes, completion);
+    return true;
+}
+
+UserSearch::FuzzyMatches UserSearch::fuzzyMatches(const std::string& word, uint32_t maxEdits) const {
+    FuzzyMatches matches;
+    if (maxEdits == 0) return matches;
+
+    auto check = [&](uint32_t index) {
+        const FuzzyTerm& term = fuzzyTerms[index];
+        if (nodes[term.node].count == 0) return;
+        uint32_t edits = boundedDistance(word, term.text, maxEdits);
+        if (edits <= maxEdits) matches.push_back({edits, term.node});
+    };
+
+    // An edit touches at most 3 trigrams, so a term within maxEdits shares
+    // all but 3 * maxEdits of the word's
+    std::vector<uint32_t> grams = trigramsOf(word);
+    int64_t needed = static_cast<int64_t>(grams.size()) - 3 * static_cast<int64_t>(maxEdits);
+    if (needed <= 0) {
+        for (uint32_t index = 0; index < fuzzyTerms.size(); ++index) check(index);
+    } else {
+        std::unordered_map<uint32_t, uint32_t> shared;
+        for (uint32_t gram : grams) {
+            auto it = trigrams.find(gram);
+            if (it == trigrams.end()) continue;
+            for (uint32_t index : it->second) ++shared[index];
+        }
+        for (const auto& entry : shared) {
+            if (entry.second >= needed) check(entry.first);
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+uint32_t UserSearch::minimumCost(uint32_t prefix, size_t wordLength, const FuzzyMatches& fuzzy) const {
+    // The shortest term under the prefix node
+    if (prefix != NO_NODE && nodes[prefix].postings) {
+        typedef std::pair<uint32_t, uint32_t> Entry;  // (depth, node)
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> frontier;
+        frontier.push({nodes[prefix].depth, prefix});
+        while (!frontier.empty()) {
+            auto [depth, node] = frontier.top();
+            frontier.pop();
+            if (nodes[node].count) {
+                uint32_t completion = depth - static_cast<uint32_t>(wordLength);
+                return completion == 0 ? 0 : packScore(0, 1, completion);
+            }
+            for (uint32_t child = nodes[node].firstChild; child != NO_NODE;
+                 child = nodes[child].nextSibling) {
+                if (nodes[child].postings) frontier.push({nodes[child].depth, child});
+            }
+        }
+    }
+    return fuzzy.empty() ? UINT32_MAX : packScore(fuzzy.front().first, 0, 0);
+}
+
+std::vector<SearchHit> UserSearch::search(const UserStore& users, std::string_view query,
+                                          size_t k) const {
+    std::vector<SearchHit> hits;
+    std::vector<std::string> words = queryWords(query);
+    if (words.empty() || k == 0) return hits;
+
+    // Per word: its prefix node, fuzzy matches and cheapest possible cost.
+    // A word that matches nothing means there are no hits; the word with
+    // the fewest holders drives
+    std::vector<uint32_t> prefix(words.size()), floor(words.size());
+    std::vector<FuzzyMatches> fuzzy(words.size());
+    std::vector<size_t> estimate(words.size(), 0);
+    for (size_t i = 0; i < words.size(); ++i) {
+        prefix[i] = findPrefix(words[i]);
+        fuzzy[i] = fuzzyMatches(words[i], editsAllowed(words[i].size()));
+        floor[i] = minimumCost(prefix[i], words[i].size(), fuzzy[i]);
+        if (floor[i] == UINT32_MAX) return hits;
+
+        if (prefix[i] != NO_NODE) estimate[i] = nodes[prefix[i]].postings;
+        for (const auto& match : fuzzy[i]) estimate[i] += nodes[match.second].count;
+    }
+    std::vector<size_t> order(words.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return estimate[a] < estimate[b]; });
+    const size_t drive = order[0];
+
+    // Users must hold a match for every other word: intersect those words'
+    // holders, rarest first so the set only shrinks (hubs keep that cheap
+    // for short prefixes), and count their cheapest costs towards every
+    // user's lower bound
+    uint32_t otherEdits = 0, otherPrefixes = 0, otherCompletion = 0;
+    RoaringBitmap allowed;
+    bool filtered = false;
+    for (size_t i : order) {
+        if (i == drive) continue;
+        otherEdits += floor[i] >> 24;
+        otherPrefixes += (floor[i] >> 16) & 0xFF;
+        otherCompletion += floor[i] & 0xFFFF;
+
+        // An exact fuzzy match is the word's own term, already in the prefix
+        // subtree
+        RoaringBitmap matching;
+        bool gathered = prefix[i] != NO_NODE && nodes[prefix[i]].postings;
+        if (gathered) gatherSubtree(prefix[i], matching);
+        for (const auto& match : fuzzy[i]) {
+            if (match.first > 0 || !gathered) gatherSubtree(match.second, matching);
+        }
+        if (filtered) {
+            allowed.intersectWith(matching);
+        } else {
+            allowed = std::move(matching);
+            filtered = true;
+        }
+        if (allowed.empty()) return hits;
+    }
+    auto bound = [&](uint32_t cost) {
+        return packScore((cost >> 24) + otherEdits, ((cost >> 16) & 0xFF) + otherPrefixes,
+                         (cost & 0xFFFF) + otherCompletion);
+    };
+
+    // The driving word's terms are visited in order of what they cost it,
+    // so no user still to come scores below bound(cost): once the k best so
+    // far all beat that, the rest of the stream can't get in
+    std::priority_queue<std::pair<uint32_t, UserHandle>> best;  // Worst on top
+    std::unordered_set<UserHandle> seen;
+    auto beaten = [&](uint32_t cost) { return best.size() >= k && bound(cost) > best.top().first; };
+    auto visit = [&](uint32_t node, uint32_t cost) {
+        uint32_t least = bound(cost);
+        auto consider = [&](UserHandle user) {
+            // Handles ascend, so past the worst kept hit at this bound, stop
+            if (best.size() >= k && std::make_pair(least, user) > best.top()) return false;
+            if (!seen.insert(user).second) return true;
+            uint32_t result;
+            if (!score(users, user, words, result)) return true;
+            if (best.size() < k) {
+                best.push({result, user});
+            } else if (std::make_pair(result, user) < best.top()) {
+                best.pop();
+                best.push({result, user});
+            }
+            return true;
+        };
+
+        const Node& n = nodes[node];
+        if (filtered && n.listed) {
+            // Intersected a group at a time: once consider stops, the rest
+            // of the holders are never touched
+            holders[n.users].forEachCommon(allowed, consider);
+        } else {
+            forEachUser(node, [&](UserHandle user) {
+                return (filtered && !allowed.contains(user)) || consider(user);
+            });
+        }
+    };
+
+    // Exact and prefix matches, shortest terms (least left to complete) first
+    bool done = false;
+    typedef std::pair<uint32_t, uint32_t> Entry;  // (depth, node)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> frontier;
+    const uint32_t root = prefix[drive];
+    const uint32_t wordLength = static_cast<uint32_t>(words[drive].size());
+    if (root != NO_NODE && nodes[root].postings) frontier.push({nodes[root].depth, root});
+    while (!frontier.empty()) {
+        auto [depth, node] = frontier.top();
+        frontier.pop();
+        uint32_t cost = depth == wordLength ? 0 : packScore(0, 1, depth - wordLength);
+        if (beaten(cost)) {
+            done = true;
+            break;
+        }
+        if (nodes[node].count) visit(node, cost);
+        for (uint32_t child = nodes[node].firstChild; child != NO_NODE;
+             child = nodes[child].nextSibling) {
+            if (nodes[child].postings) frontier.push({nodes[child].depth, child});
+        }
+    }
+
+    // Then terms within a typo or two, nearest first
+    if (!done) {
+        for (const auto& match : fuzzy[drive]) {
+            uint32_t cost = packScore(match.first, 0, 0);
+            if (beaten(cost)) break;
+            visit(match.second, cost);
+        }
+    }
+
+    hits.resize(best.size());
+    for (size_t i = hits.size(); i-- > 0; best.pop()) {
+        hits[i] = {best.top().second, best.top().first};
+    }
+    return hits;
+}
+
+void UserSearch::remapUsers(const std::vector<UserHandle>& remap) {
+    for (Node& node : nodes) {
+        if (node.count && !node.listed) node.users = remap[node.users];
+    }
+    for (auto& users : holders) users.remap(remap);
+    for (auto& users : hubs) users.remap(remap);
+}
+
+size_t UserSearch::termCount() const {
+    size_t terms = 0;
+    for (const Node& node : nodes) terms += node.count > 0;
+    return terms;
+}
+
+size_t UserSearch::nodeCount() const {
+    return nodes.size();
+}
+
+size_t UserSearch::memoryBytes() const {
+    size_t bytes = nodes.capacity() * sizeof(Node) + labels.capacity() +
+                   (holders.capacity() + hubs.capacity()) * sizeof(RoaringBitmap) +
+                   fuzzyTerms.capacity() * sizeof(FuzzyTerm);
+    for (const auto& users : holders) bytes += users.memoryBytes();
+    for (const auto& users : hubs) bytes += users.memoryBytes();
+    for (const auto& term : fuzzyTerms) bytes += term.text.capacity();
+    bytes += (fuzzyByNode.bucket_count() + trigrams.bucket_count()) * sizeof(void*) +
+             fuzzyByNode.size() * (sizeof(std::pair<uint32_t, uint32_t>) + sizeof(void*));
+    for (const auto& entry : trigrams) {
+        bytes += sizeof(entry) + 2 * sizeof(void*) + entry.second.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+void UserSearch::clear() {
+    nodes.clear();
+    labels.clear();
+    newNode(0, 0, 0);
+    holders.clear();
+    hubs.clear();
+    fuzzyTerms.clear();
+    fuzzyByNode.clear();
+    trigrams.clear();
+}
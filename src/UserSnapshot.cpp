@@ -0,0 +1,355 @@
+// ============================================================================
+// FILE: src/UserSnapshot.cpp
+// ============================================================================
+
+#include "UserSnapshot.h"
+#include "FileSync.h"
+#include <cstring>
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = {'S', 'C', 'S', 'S', 'N', 'A', 'P', '\0'};
+
+// FNV-1a, used for both on-disk hash indexes
+uint64_t hashKey(std::string_view key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char ch : key) {
+        hash ^= ch;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t align8(uint64_t n) {
+    return (n + 7) & ~uint64_t(7);
+}
+
+// Value of a string column for one user (password only exists for the admin)
+std::string_view columnValue(const User& user, const Admin* admin, SnapshotColumn column) {
+    switch (column) {
+        case COL_ID: return user.getId();
+        case COL_NAME: return user.getName();
+        case COL_EMAIL: return user.getEmail();
+        case COL_PHONE: return user.getPhone();
+        case COL_CARD_ID: return user.getCard()->getId();
+        default: return admin ? std::string_view(admin->getPassword()) : std::string_view();
+    }
+}
+
+std::string_view columnValue(const UserStore& store, UserHandle user, SnapshotColumn column) {
+    switch (column) {
+        case COL_ID: return store.getId(user);
+        case COL_NAME: return store.getName(user);
+        case COL_EMAIL: return store.getEmail(user);
+        case COL_PHONE: return store.getPhone(user);
+        case COL_CARD_ID: return store.getCardId(user);
+        default: return std::string_view();
+    }
+}
+
+// A column's offsets run in order within the heap, and its user-row fields
+// are short enough for a StringPool (the admin row never goes into one)
+bool validColumn(const uint64_t* offsets, uint64_t rows, uint64_t userCount, uint64_t heapSize) {
+    if (offsets[rows] > heapSize) return false;
+    for (uint64_t row = 0; row < rows; ++row) {
+        if (offsets[row] > offsets[row + 1]) return false;
+        if (row < userCount && offsets[row + 1] - offsets[row] > StringPool::MAX_LENGTH) return false;
+    }
+    return true;
+}
+
+// Every entry is empty or a user row + 1, and at least one slot is empty
+// so probes end
+bool validIndex(const uint32_t* index, uint64_t slots, uint64_t userCount) {
+    uint64_t used = 0;
+    for (uint64_t slot = 0; slot < slots; ++slot) {
+        if (index[slot] > userCount) return false;
+        used += index[slot] != 0;
+    }
+    return used < slots;
+}
+
+void writePadding(std::ofstream& out, uint64_t from, uint64_t to) {
+    static const char zeros[8] = {};
+    out.write(zeros, static_cast<std::streamsize>(to - from));
+}
+
+// userCount user rows, where fieldOf(row, column) and levelOf(row) read a
+// user row, then the admin (if any) as the last row
+template <typename FieldFn, typename LevelFn>
+bool writeSnapshotRows(const std::string& path, uint64_t userCount, const Admin* admin,
+                       FieldFn fieldOf, LevelFn levelOf, uint64_t csvSize, int64_t csvMtime) {
+    uint64_t rows = userCount + (admin ? 1 : 0);
+    auto rowField = [&](uint64_t row, SnapshotColumn column) -> std::string_view {
+        return row < userCount ? fieldOf(row, column) : columnValue(*admin, admin, column);
+    };
+    auto rowLevel = [&](uint64_t row) -> int {
+        return row < userCount ? levelOf(row) : admin->getCard()->getClearanceLevelInt();
+    };
+
+    // Section layout
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.flags = admin ? SNAPSHOT_HAS_ADMIN : 0;
+    header.userCount = userCount;
+    header.csvSize = csvSize;
+    header.csvMtime = csvMtime;
+    header.indexSlots = 16;
+    while (header.indexSlots < userCount * 2) header.indexSlots *= 2;
+
+    uint64_t columnBytes[SNAPSHOT_COLUMNS] = {};
+    for (uint64_t row = 0; row < rows; ++row) {
+        for (int c = 0; c < SNAPSHOT_COLUMNS; ++c) {
+            columnBytes[c] += rowField(row, SnapshotColumn(c)).size();
+        }
+    }
+
+    uint64_t offset = align8(sizeof(SnapshotHeader));
+    header.clearanceOffset = offset;
+    offset = align8(offset + rows);
+    for (int c = 0; c < SNAPSHOT_COLUMNS; ++c) {
+        header.stringOffsets[c] = offset;
+        offset += (rows + 1) * sizeof(uint64_t);
+    }
+    header.heapOffset = offset;
+    for (int c = 0; c < SNAPSHOT_COLUMNS; ++c) header.heapSize += columnBytes[c];
+    offset = align8(offset + header.heapSize);
+    header.idIndexOffset = offset;
+    offset += header.indexSlots * sizeof(uint32_t);
+    header.nameIndexOffset = offset;
+    offset += header.indexSlots * sizeof(uint32_t);
+    header.fileSize = offset;
+
+    // Hash indexes over user rows (the admin is not searchable, as before)
+    uint64_t mask = header.indexSlots - 1;
+    std::vector<uint32_t> ids(header.indexSlots, 0), names(header.indexSlots, 0);
+    for (uint64_t row = 0; row < userCount; ++row) {
+        std::string_view id = fieldOf(row, COL_ID);
+        uint64_t slot = hashKey(id) & mask;
+        bool duplicate = false;
+        while (ids[slot] != 0 && !duplicate) {
+            duplicate = fieldOf(ids[slot] - 1, COL_ID) == id;  // First row with an ID wins
+            slot = (slot + 1) & mask;
+        }
+        if (!duplicate) ids[slot] = static_cast<uint32_t>(row + 1);
+
+        slot = hashKey(fieldOf(row, COL_NAME)) & mask;
+        while (names[slot] != 0) slot = (slot + 1) & mask;
+        names[slot] = static_cast<uint32_t>(row + 1);
+    }
+
+    // Write to a temp file and rename it over the old snapshot
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writePadding(out, sizeof(header), header.clearanceOffset);
+
+    std::vector<uint8_t> levels(rows);
+    for (uint64_t row = 0; row < rows; ++row) {
+        levels[row] = static_cast<uint8_t>(rowLevel(row));
+    }
+    out.write(reinterpret_cast<const char*>(levels.data()), static_cast<std::streamsize>(rows));
+    writePadding(out, header.clearanceOffset + rows, header.stringOffsets[0]);
+
+    std::vector<uint64_t> columnOffsets(rows + 1);
+    uint64_t heapPos = 0;
+    for (int c = 0; c < SNAPSHOT_COLUMNS; ++c) {
+        for (uint64_t row = 0; row < rows; ++row) {
+            columnOffsets[row] = heapPos;
+            heapPos += rowField(row, SnapshotColumn(c)).size();
+        }
+        columnOffsets[rows] = heapPos;
+        out.write(reinterpret_cast<const char*>(columnOffsets.data()),
+                  static_cast<std::streamsize>(columnOffsets.size() * sizeof(uint64_t)));
+    }
+
+    for (int c = 0; c < SNAPSHOT_COLUMNS; ++c) {
+        for (uint64_t row = 0; row < rows; ++row) {
+            std::string_view value = rowField(row, SnapshotColumn(c));
+            out.write(value.data(), static_cast<std::streamsize>(value.size()));
+        }
+    }
+    writePadding(out, header.heapOffset + header.heapSize, header.idIndexOffset);
+
+    out.write(reinterpret_cast<const char*>(ids.data()),
+              static_cast<std::streamsize>(ids.size() * sizeof(uint32_t)));
+    out.write(reinterpret_cast<const char*>(names.data()),
+              static_cast<std::streamsize>(names.size() * sizeof(uint32_t)));
+    out.close();
+
+    if (!out) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return replaceFile(tempPath, path);
+}
+
+} // namespace
+
+UserSnapshot::UserSnapshot()
+    : header(nullptr), clearance(nullptr), offsets(), heap(nullptr),
+      idIndex(nullptr), nameIndex(nullptr) {}
+
+bool UserSnapshot::open(const std::string& path) {
+    if (!file.open(path) || file.size() < sizeof(SnapshotHeader)) return false;
+
+    header = reinterpret_cast<const SnapshotHeader*>(file.data());
+    uint64_t size = file.size();
+    uint64_t rows = header->userCount + ((header->flags & SNAPSHOT_HAS_ADMIN) ? 1 : 0);
+    uint64_t slots = header->indexSlots;
+
+    // Header sanity and section bounds first, then the row data itself:
+    // loadInto adopts the offsets, levels and indexes as they are
+    auto fits = [size](uint64_t offset, uint64_t bytes) {
+        return offset <= size && bytes <= size - offset && offset % 8 == 0;
+    };
+    bool valid = std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0 &&
+                 header->version == SNAPSHOT_VERSION &&
+                 header->fileSize == size &&
+                 slots > 0 && (slots & (slots - 1)) == 0 && slots > header->userCount &&
+                 fits(header->clearanceOffset, rows) &&
+                 fits(header->heapOffset, header->heapSize) &&
+                 fits(header->idIndexOffset, slots * sizeof(uint32_t)) &&
+                 fits(header->nameIndexOffset, slots * sizeof(uint32_t));
+    for (int c = 0; valid && c < SNAPSHOT_COLUMNS; ++c) {
+        valid = fits(header->stringOffsets[c], (rows + 1) * sizeof(uint64_t));
+    }
+
+    if (valid) {
+        const char* base = file.data();
+        clearance = reinterpret_cast<const uint8_t*>(base + header->clearanceOffset);
+        for (int c = 0; c < SNAPSHOT_COLUMNS; ++c) {
+            offsets[c] = reinterpret_cast<const uint64_t*>(base + header->stringOffsets[c]);
+        }
+        heap = base + header->heapOffset;
+        idIndex = reinterpret_cast<const uint32_t*>(base + header->idIndexOffset);
+        nameIndex = reinterpret_cast<const uint32_t*>(base + header->nameIndexOffset);
+
+        for (uint64_t row = 0; valid && row < rows; ++row) {
+            valid = clearance[row] <= 3;
+        }
+        for (int c = 0; valid && c < SNAPSHOT_COLUMNS; ++c) {
+            valid = validColumn(offsets[c], rows, header->userCount, header->heapSize);
+        }
+        valid = valid && validIndex(idIndex, slots, header->userCount) &&
+                validIndex(nameIndex, slots, header->userCount);
+    }
+    if (!valid) {
+        file.close();
+        header = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool UserSnapshot::write(const std::string& path, const UserStore& users,
+                         const std::shared_ptr<Admin>& admin,
+                         uint64_t csvSize, int64_t csvMtime) {
+    // Rows are the live users in handle order, without tombstones
+    std::vector<UserHandle> handles;
+    handles.reserve(users.size());
+    users.forEach([&](UserHandle user) { handles.push_back(user); });
+
+    return writeSnapshotRows(
+        path, handles.size(), admin.get(),
+        [&](uint64_t row, SnapshotColumn column) { return columnValue(users, handles[row], column); },
+        [&](uint64_t row) { return clearanceLevelToInt(users.getClearanceLevel(handles[row])); },
+        csvSize, csvMtime);
+}
+
+bool UserSnapshot::matchesCsv(uint64_t csvSize, int64_t csvMtime) const {
+    return header && header->csvSize == csvSize && header->csvMtime == csvMtime;
+}
+
+size_t UserSnapshot::userCount() const {
+    return header ? header->userCount : 0;
+}
+
+bool UserSnapshot::hasAdmin() const {
+    return header && (header->flags & SNAPSHOT_HAS_ADMIN);
+}
+
+std::string_view UserSnapshot::field(size_t row, SnapshotColumn column) const {
+    uint64_t begin = offsets[column][row];
+    uint64_t end = offsets[column][row + 1];
+    return std::string_view(heap + begin, end - begin);
+}
+
+int UserSnapshot::clearanceLevel(size_t row) const {
+    return clearance[row];
+}
+
+long UserSnapshot::findById(std::string_view id) const {
+    uint64_t mask = header->indexSlots - 1;
+    for (uint64_t slot = hashKey(id) & mask; idIndex[slot] != 0; slot = (slot + 1) & mask) {
+        size_t row = idIndex[slot] - 1;
+        if (field(row, COL_ID) == id) return static_cast<long>(row);
+    }
+    return -1;
+}
+
+std::vector<size_t> UserSnapshot::findByName(std::string_view name) const {
+    // Linear probing keeps equal names in insertion (row) order
+    std::vector<size_t> rows;
+    uint64_t mask = header->indexSlots - 1;
+    for (uint64_t slot = hashKey(name) & mask; nameIndex[slot] != 0; slot = (slot + 1) & mask) {
+        size_t row = nameIndex[slot] - 1;
+        if (field(row, COL_NAME) == name) rows.push_back(row);
+    }
+    return rows;
+}
+
+std::shared_ptr<User> UserSnapshot::materialize(size_t row) const {
+    auto card = std::make_shared<Card>(std::string(field(row, COL_CARD_ID)),
+                                       intToClearanceLevel(clearanceLevel(row)));
+    return std::make_shared<User>(std::string(field(row, COL_ID)), std::string(field(row, COL_NAME)),
+                                  std::string(field(row, COL_EMAIL)), std::string(field(row, COL_PHONE)),
+                                  card);
+}
+
+std::shared_ptr<Admin> UserSnapshot::materializeAdmin() const {
+    if (!hasAdmin()) return nullptr;
+
+    size_t row = header->userCount;
+    auto card = std::make_shared<Card>(std::string(field(row, COL_CARD_ID)),
+                                       intToClearanceLevel(clearanceLevel(row)));
+    return std::make_shared<Admin>(std::string(field(row, COL_ID)), std::string(field(row, COL_NAME)),
+                                   std::string(field(row, COL_EMAIL)), std::string(field(row, COL_PHONE)),
+                                   card, std::string(field(row, COL_PASSWORD)));
+}
+
+void UserSnapshot::loadInto(UserStore& store) const {
+    size_t rows = userCount();
+    if (store.handleLimit() != 0) {
+        // Handles wouldn't match rows; index row by row
+        store.reserve(store.size() + rows);
+        for (size_t row = 0; row < rows; ++row) {
+            store.add(field(row, COL_ID), field(row, COL_NAME), field(row, COL_EMAIL),
+                      field(row, COL_PHONE), field(row, COL_CARD_ID),
+                      intToClearanceLevel(clearanceLevel(row)), false);
+        }
+        return;
+    }
+
+    // Into an empty store, row = handle, and the on-disk indexes already have
+    // the store's layout (FNV-1a, linear probing, row + 1, same sizing): copy
+    // them instead of hashing every row again
+    store.records.reserve(rows);
+    for (size_t row = 0; row < rows; ++row) {
+        UserStore::Record record;
+        record.id = store.pool.append(field(row, COL_ID));
+        record.name = store.intern(field(row, COL_NAME));
+        record.email = store.pool.append(field(row, COL_EMAIL));
+        record.phone = store.pool.append(field(row, COL_PHONE));
+        record.cardId = store.pool.append(field(row, COL_CARD_ID));
+        record.clearance = static_cast<uint8_t>(clearanceLevel(row));
+        record.flags = UserStore::RECORD_LIVE;
+        store.records.push_back(record);
+    }
+    store.liveCount = rows;
+    store.idIndex.assign(idIndex, idIndex + header->indexSlots);
+    store.nameIndex.assign(nameIndex, nameIndex + header->indexSlots);
+}
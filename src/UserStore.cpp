@@ -0,0 +1,406 @@
+// ============================================================================
+// FILE: src/UserStore.cpp
+// ============================================================================
+
+#include "UserStore.h"
+
+namespace {
+
+// Ref layout: chunk (24 bits) | offset in chunk (24 bits) | length (16 bits)
+const StringPool::Ref EMPTY_REF = UINT64_MAX;  // Free intern slot, never a real Ref
+
+StringPool::Ref packRef(size_t chunk, size_t offset, size_t length) {
+    return (StringPool::Ref(chunk) << 40) | (StringPool::Ref(offset) << 16) | StringPool::Ref(length);
+}
+
+// FNV-1a, as in the snapshot indexes
+uint64_t hashText(std::string_view text) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char ch : text) {
+        hash ^= ch;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+size_t tableSlotsFor(size_t entries) {
+    size_t slots = 16;
+    while (slots < entries * 2) slots *= 2;
+    return slots;
+}
+
+// Backward-shift delete: later entries of the probe run move up into the
+// hole unless that would put them before their home slot. Keeps runs
+// gap-free and equal keys in their insertion order.
+template <typename HomeFn>
+void eraseSlot(std::vector<uint32_t>& table, size_t hole, HomeFn home) {
+    size_t mask = table.size() - 1;
+    for (size_t next = (hole + 1) & mask; table[next] != 0; next = (next + 1) & mask) {
+        size_t homeSlot = home(table[next] - 1) & mask;
+        if (((next - homeSlot) & mask) >= ((next - hole) & mask)) {
+            table[hole] = table[next];
+            hole = next;
+        }
+    }
+    table[hole] = 0;
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+// StringPool
+// ----------------------------------------------------------------------------
+
+StringPool::Ref StringPool::append(std::string_view text) {
+    size_t length = std::min(text.size(), MAX_LENGTH);
+    if (chunks.empty() || chunks.back().capacity() - chunks.back().size() < length) {
+        chunks.emplace_back();
+        chunks.back().reserve(STRING_POOL_CHUNK_BYTES);
+    }
+
+    std::vector<char>& chunk = chunks.back();
+    size_t offset = chunk.size();
+    chunk.insert(chunk.end(), text.begin(), text.begin() + length);
+    return packRef(chunks.size() - 1, offset, length);
+}
+
+std::string_view StringPool::view(Ref ref) const {
+    const std::vector<char>& chunk = chunks[ref >> 40];
+    return std::string_view(chunk.data() + ((ref >> 16) & 0xFFFFFF), ref & 0xFFFF);
+}
+
+size_t StringPool::memoryBytes() const {
+    size_t bytes = chunks.capacity() * sizeof(std::vector<char>);
+    for (const auto& chunk : chunks) bytes += chunk.capacity();
+    return bytes;
+}
+
+void StringPool::clear() {
+    chunks.clear();
+}
+
+// ----------------------------------------------------------------------------
+// UserStore
+// ----------------------------------------------------------------------------
+
+UserStore::UserStore()
+    : liveCount(0), garbageBytes(0), internTable(16, EMPTY_REF), internCount(0),
+      idIndex(16, 0), nameIndex(16, 0) {}
+
+StringPool::Ref UserStore::findInterned(std::string_view text, uint64_t hash) const {
+    size_t mask = internTable.size() - 1;
+    for (size_t slot = hash & mask; internTable[slot] != EMPTY_REF; slot = (slot + 1) & mask) {
+        if (pool.view(internTable[slot]) == text) return internTable[slot];
+    }
+    return EMPTY_REF;
+}
+
+StringPool::Ref UserStore::intern(std::string_view text) {
+    uint64_t hash = hashText(text);
+    StringPool::Ref ref = findInterned(text, hash);
+    if (ref != EMPTY_REF) return ref;
+
+    growInternTable(internCount + 1);
+    ref = pool.append(text);
+    size_t mask = internTable.size() - 1;
+    size_t slot = hash & mask;
+    while (internTable[slot] != EMPTY_REF) slot = (slot + 1) & mask;
+    internTable[slot] = ref;
+    ++internCount;
+    return ref;
+}
+
+void UserStore::growInternTable(size_t entries) {
+    if (entries * 2 <= internTable.size()) return;
+
+    std::vector<StringPool::Ref> old(tableSlotsFor(entries), EMPTY_REF);
+    old.swap(internTable);
+    size_t mask = internTable.size() - 1;
+    for (StringPool::Ref entry : old) {
+        if (entry == EMPTY_REF) continue;
+        size_t slot = hashText(pool.view(entry)) & mask;
+        while (internTable[slot] != EMPTY_REF) slot = (slot + 1) & mask;
+        internTable[slot] = entry;
+    }
+}
+
+void UserStore::growIndexes(size_t users) {
+    // Both indexes are sized for every live user; rebuilt in handle order
+    if (users * 2 <= idIndex.size()) return;
+
+    size_t slots = tableSlotsFor(users);
+    idIndex.assign(slots, 0);
+    nameIndex.assign(slots, 0);
+    forEach([this](UserHandle handle) {
+        indexId(handle);
+        indexName(handle);
+    });
+}
+
+void UserStore::indexId(UserHandle handle) {
+    std::string_view id = pool.view(records[handle].id);
+    size_t mask = idIndex.size() - 1;
+    size_t slot = hashText(id) & mask;
+    for (; idIndex[slot] != 0; slot = (slot + 1) & mask) {
+        if (pool.view(records[idIndex[slot] - 1].id) == id) return;  // Taken by an earlier user
+    }
+    idIndex[slot] = handle + 1;
+}
+
+void UserStore::indexName(UserHandle handle) {
+    size_t mask = nameIndex.size() - 1;
+    size_t slot = hashText(pool.view(records[handle].name)) & mask;
+    while (nameIndex[slot] != 0) slot = (slot + 1) & mask;
+    nameIndex[slot] = handle + 1;
+}
+
+void UserStore::unindexId(UserHandle handle) {
+    size_t mask = idIndex.size() - 1;
+    for (size_t slot = hashText(pool.view(records[handle].id)) & mask; idIndex[slot] != 0;
+         slot = (slot + 1) & mask) {
+        if (idIndex[slot] == handle + 1) {
+            eraseSlot(idIndex, slot, [this](uint32_t other) {
+                return hashText(pool.view(records[other].id));
+            });
+            return;
+        }
+    }
+}
+
+void UserStore::unindexName(UserHandle handle) {
+    size_t mask = nameIndex.size() - 1;
+    for (size_t slot = hashText(pool.view(records[handle].name)) & mask; nameIndex[slot] != 0;
+         slot = (slot + 1) & mask) {
+        if (nameIndex[slot] == handle + 1) {
+            eraseSlot(nameIndex, slot, [this](uint32_t other) {
+                return hashText(pool.view(records[other].name));
+            });
+            return;
+        }
+    }
+}
+
+UserHandle UserStore::add(std::string_view id, std::string_view name, std::string_view email,
+                          std::string_view phone, std::string_view cardId, ClearanceLevel level,
+                          bool dirty) {
+    if (!fits(id) || !fits(name) || !fits(email) || !fits(phone) || !fits(cardId)) return NO_USER;
+
+    Record record;
+    record.id = pool.append(id);
+    record.name = intern(name);
+    record.email = pool.append(email);
+    record.phone = pool.append(phone);
+    record.cardId = pool.append(cardId);
+    record.clearance = static_cast<uint8_t>(clearanceLevelToInt(level));
+    record.flags = RECORD_LIVE;
+
+    growIndexes(liveCount + 1);
+    UserHandle handle = static_cast<UserHandle>(records.size());
+    records.push_back(record);
+    ++liveCount;
+    if (dirty) touch(handle);
+
+    indexId(handle);
+    indexName(handle);
+    return handle;
+}
+
+void UserStore::prefetch(std::string_view id, std::string_view name) const {
+    uint64_t nameHash = hashText(name);
+    __builtin_prefetch(&idIndex[hashText(id) & (idIndex.size() - 1)]);
+    __builtin_prefetch(&nameIndex[nameHash & (nameIndex.size() - 1)]);
+    __builtin_prefetch(&internTable[nameHash & (internTable.size() - 1)]);
+}
+
+bool UserStore::remove(UserHandle handle) {
+    if (!contains(handle)) return false;
+
+    unindexId(handle);
+    unindexName(handle);
+    touch(handle);  // Journaled as a delete
+    records[handle].flags &= ~RECORD_LIVE;
+    --liveCount;
+    const Record& record = records[handle];
+    garbageBytes += sizeof(Record) + pool.view(record.id).size() + pool.view(record.email).size() +
+                    pool.view(record.phone).size() + pool.view(record.cardId).size();
+
+    // A duplicate of the removed ID becomes findable again only on the next
+    // compaction or load
+    return true;
+}
+
+bool UserStore::contains(UserHandle handle) const {
+    return handle < records.size() && (records[handle].flags & RECORD_LIVE);
+}
+
+std::string_view UserStore::getId(UserHandle handle) const { return pool.view(records[handle].id); }
+std::string_view UserStore::getName(UserHandle handle) const { return pool.view(records[handle].name); }
+std::string_view UserStore::getEmail(UserHandle handle) const { return pool.view(records[handle].email); }
+std::string_view UserStore::getPhone(UserHandle handle) const { return pool.view(records[handle].phone); }
+std::string_view UserStore::getCardId(UserHandle handle) const { return pool.view(records[handle].cardId); }
+
+ClearanceLevel UserStore::getClearanceLevel(UserHandle handle) const {
+    return intToClearanceLevel(records[handle].clearance);
+}
+
+bool UserStore::setName(UserHandle handle, std::string_view newName) {
+    if (!fits(newName)) return false;
+    // Renamed users go to the end of their new name's run
+    unindexName(handle);
+    records[handle].name = intern(newName);
+    indexName(handle);
+    touch(handle);
+    return true;
+}
+
+bool UserStore::setEmail(UserHandle handle, std::string_view newEmail) {
+    if (!fits(newEmail)) return false;
+    garbageBytes += getEmail(handle).size();
+    records[handle].email = pool.append(newEmail);
+    touch(handle);
+    return true;
+}
+
+bool UserStore::setPhone(UserHandle handle, std::string_view newPhone) {
+    if (!fits(newPhone)) return false;
+    garbageBytes += getPhone(handle).size();
+    records[handle].phone = pool.append(newPhone);
+    touch(handle);
+    return true;
+}
+
+void UserStore::setClearanceLevel(UserHandle handle, ClearanceLevel level) {
+    records[handle].clearance = static_cast<uint8_t>(clearanceLevelToInt(level));
+    touch(handle);
+}
+
+bool UserStore::setCardId(UserHandle handle, std::string_view newCardId) {
+    if (!fits(newCardId)) return false;
+    garbageBytes += getCardId(handle).size();
+    records[handle].cardId = pool.append(newCardId);
+    touch(handle);
+    return true;
+}
+
+void UserStore::touch(UserHandle handle) {
+    if (records[handle].flags & RECORD_DIRTY) return;  // Already queued
+    records[handle].flags |= RECORD_DIRTY;
+    changed.push_back(handle);
+}
+
+bool UserStore::isDirty(UserHandle handle) const { return records[handle].flags & RECORD_DIRTY; }
+void UserStore::markDirty(UserHandle handle) { touch(handle); }
+void UserStore::clearDirty(UserHandle handle) { records[handle].flags &= ~RECORD_DIRTY; }
+
+UserHandle UserStore::findById(std::string_view id) const {
+    size_t mask = idIndex.size() - 1;
+    for (size_t slot = hashText(id) & mask; idIndex[slot] != 0; slot = (slot + 1) & mask) {
+        UserHandle handle = idIndex[slot] - 1;
+        if (pool.view(records[handle].id) == id) return handle;
+    }
+    return NO_USER;
+}
+
+UserHandle UserStore::findByName(std::string_view name) const {
+    // Unknown text can't be anyone's name; known text compares by Ref
+    uint64_t hash = hashText(name);
+    StringPool::Ref ref = findInterned(name, hash);
+    if (ref == EMPTY_REF) return NO_USER;
+
+    size_t mask = nameIndex.size() - 1;
+    for (size_t slot = hash & mask; nameIndex[slot] != 0; slot = (slot + 1) & mask) {
+        UserHandle handle = nameIndex[slot] - 1;
+        if (records[handle].name == ref) return handle;
+    }
+    return NO_USER;
+}
+
+size_t UserStore::size() const {
+    return liveCount;
+}
+
+size_t UserStore::handleLimit() const {
+    return records.size();
+}
+
+void UserStore::reserve(size_t users) {
+    records.reserve(users);
+    growIndexes(users);
+    growInternTable(users);
+}
+
+void UserStore::clear() {
+    *this = UserStore();
+}
+
+bool UserStore::needsCompaction() const {
+    return garbageBytes >= std::max(USER_STORE_COMPACT_MIN_BYTES, memoryBytes() / 4);
+}
+
+std::vector<UserHandle> UserStore::compact() {
+    std::vector<UserHandle> remap(records.size(), NO_USER);
+    size_t kept = 0;
+    for (const Record& record : records) kept += record.flags != 0;
+
+    UserStore next;
+    next.records.reserve(kept);
+    next.growIndexes(liveCount);
+    next.growInternTable(liveCount);
+    for (UserHandle handle = 0; handle < records.size(); ++handle) {
+        const Record& old = records[handle];
+        if (old.flags == 0) continue;  // Removed, and the removal is journaled
+
+        // A removed user still waiting to be journaled keeps its record
+        Record record;
+        record.id = next.pool.append(pool.view(old.id));
+        record.name = next.intern(pool.view(old.name));
+        record.email = next.pool.append(pool.view(old.email));
+        record.phone = next.pool.append(pool.view(old.phone));
+        record.cardId = next.pool.append(pool.view(old.cardId));
+        record.clearance = old.clearance;
+        record.flags = old.flags;
+
+        UserHandle moved = static_cast<UserHandle>(next.records.size());
+        remap[handle] = moved;
+        next.records.push_back(record);
+        if (record.flags & RECORD_LIVE) {
+            next.indexId(moved);
+            next.indexName(moved);
+            ++next.liveCount;
+        }
+    }
+    for (UserHandle handle : changed) {
+        if (remap[handle] != NO_USER) next.changed.push_back(remap[handle]);
+    }
+
+    *this = std::move(next);
+    return remap;
+}
+
+void UserStore::writeCSV(std::ostream& out, UserHandle handle) const {
+    const Record& record = records[handle];
+    out << pool.view(record.id) << ',' << pool.view(record.name) << ','
+        << pool.view(record.email) << ',' << pool.view(record.phone) << ','
+        << pool.view(record.cardId) << ',' << static_cast<int>(record.clearance) << ",USER";
+}
+
+std::string UserStore::toCSV(UserHandle handle) const {
+    std::ostringstream out;
+    writeCSV(out, handle);
+    return out.str();
+}
+
+std::shared_ptr<User> UserStore::toUser(UserHandle handle) const {
+    auto card = std::make_shared<Card>(std::string(getCardId(handle)), getClearanceLevel(handle));
+    auto user = std::make_shared<User>(std::string(getId(handle)), std::string(getName(handle)),
+                                       std::string(getEmail(handle)), std::string(getPhone(handle)),
+                                       card);
+    if (isDirty(handle)) user->markDirty();
+    return user;
+}
+
+size_t UserStore::memoryBytes() const {
+    return records.capacity() * sizeof(Record) + pool.memoryBytes() +
+           internTable.capacity() * sizeof(StringPool::Ref) +
+           (idIndex.capacity() + nameIndex.capacity()) * sizeof(uint32_t);
+}
@@ -2,6 +2,134 @@
 // FILE: src/Validator.cpp
 // ============================================================================
 #include "Validator.h"
+#include <array>
+#include <cstring>
+
+namespace {
+
+// Character classes used by the email/phone validators
+enum : unsigned char {
+    CC_LOCAL  = 1,  // [a-zA-Z0-9._%+-]
+    CC_DOMAIN = 2,  // [a-zA-Z0-9.-]
+    CC_ALPHA  = 4,  // [a-zA-Z]
+};
+
+constexpr std::array<unsigned char, 256> makeCharClasses() {
+    std::array<unsigned char, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        bool digit = c >= '0' && c <= '9';
+        unsigned char cls = 0;
+        if (alpha) cls |= CC_ALPHA;
+        if (alpha || digit || c == '.' || c == '-') cls |= CC_DOMAIN | CC_LOCAL;
+        if (c == '_' || c == '%' || c == '+') cls |= CC_LOCAL;
+        table[c] = cls;
+    }
+    return table;
+}
+
+constexpr std::array<unsigned char, 256> CHAR_CLASSES = makeCharClasses();
+
+inline unsigned char charClass(char ch) {
+    return CHAR_CLASSES[static_cast<unsigned char>(ch)];
+}
+
+// True if all 8 bytes at p are ASCII digits, checked as one 64-bit word:
+// after XOR with '0' each byte must be 0..9, i.e. have no high nibble
+// either as-is or after adding 6
+inline bool eightDigits(const char* p) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    const uint64_t highNibbles = 0xF0F0F0F0F0F0F0F0ULL;
+    uint64_t x = word ^ 0x3030303030303030ULL;
+    return ((x | (x + 0x0606060606060606ULL)) & highNibbles) == 0;
+}
+
+// SWAR character classes: eight bytes per step, one 64-bit word each. The
+// masks have the high bit of each matching byte set and assume ASCII input
+// (callers reject bytes >= 0x80 first, as no class contains them)
+const uint64_t ONES = 0x0101010101010101ULL;
+const uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+// Up to 8 bytes at p, zero padded, first byte in the lowest 8 bits
+inline uint64_t loadWord(const char* p, size_t length) {
+    uint64_t word = 0;
+    std::memcpy(&word, p, length);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+// High bits of the first 'length' bytes
+inline uint64_t leadingBytes(size_t length) {
+    return length >= 8 ? HIGH_BITS : HIGH_BITS & ((uint64_t(1) << (8 * length)) - 1);
+}
+
+// Bytes in [lo, hi]: with ASCII bytes neither sum carries into the next byte
+inline uint64_t bytesInRange(uint64_t word, unsigned char lo, unsigned char hi) {
+    uint64_t atLeastLo = word + ONES * (0x80 - lo);
+    uint64_t aboveHi = word + ONES * (0x7F - hi);
+    return atLeastLo & ~aboveHi & HIGH_BITS;
+}
+
+inline uint64_t alphaBytes(uint64_t word) {
+    return bytesInRange(word, 'a', 'z') | bytesInRange(word, 'A', 'Z');
+}
+
+inline uint64_t domainBytes(uint64_t word) {  // [a-zA-Z0-9.-]
+    return alphaBytes(word) | bytesInRange(word, '0', '9') | bytesInRange(word, '-', '.');
+}
+
+inline uint64_t localBytes(uint64_t word) {  // [a-zA-Z0-9._%+-]
+    return domainBytes(word) | bytesInRange(word, '_', '_') | bytesInRange(word, '%', '%') |
+           bytesInRange(word, '+', '+');
+}
+
+// validateEmail, eight bytes per step
+bool emailWords(const std::string& email) {
+    const char* p = email.data();
+    const size_t n = email.size();
+
+    // Local part: the first byte that isn't a local char must be the '@'
+    size_t at = n;
+    for (size_t i = 0; i < n; i += 8) {
+        size_t length = std::min<size_t>(8, n - i);
+        uint64_t word = loadWord(p + i, length);
+        uint64_t valid = leadingBytes(length);
+        if (word & HIGH_BITS & valid) return false;
+        uint64_t other = ~localBytes(word) & valid;
+        if (other) {
+            at = i + __builtin_ctzll(other) / 8;
+            break;
+        }
+    }
+    if (at == 0 || at == n || p[at] != '@') return false;
+
+    // Domain: only domain chars; remember the last dot
+    const size_t domainStart = at + 1;
+    size_t lastDot = n;
+    for (size_t i = domainStart; i < n; i += 8) {
+        size_t length = std::min<size_t>(8, n - i);
+        uint64_t word = loadWord(p + i, length);
+        uint64_t valid = leadingBytes(length);
+        if (word & HIGH_BITS & valid) return false;
+        if (~domainBytes(word) & valid) return false;
+        uint64_t dots = bytesInRange(word, '.', '.') & valid;
+        if (dots) lastDot = i + (63 - __builtin_clzll(dots)) / 8;
+    }
+
+    // Non-empty label before the last dot, 2+ letters after it
+    if (lastDot == n || lastDot == domainStart || n - lastDot - 1 < 2) return false;
+    for (size_t i = lastDot + 1; i < n; i += 8) {
+        size_t length = std::min<size_t>(8, n - i);
+        uint64_t valid = leadingBytes(length);
+        if (~alphaBytes(loadWord(p + i, length)) & valid) return false;
+    }
+    return true;
+}
+
+} // namespace
 
 bool Validator::validatePassword(const std::string& password) {
     if (password.length() < 8) return false;
@@ -19,15 +147,64 @@ bool Validator::validatePassword(const std::string& password) {
 }
 
 bool Validator::validateEmail(const std::string& email) {
-    // Regex for local@domain.tld (at least one dot in domain)
-    std::regex emailPattern(R"(^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}$)");
-    return std::regex_match(email, emailPattern);
+    // Single pass equivalent of ^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}$
+    size_t n = email.size();
+    size_t i = 0;
+
+    // Local part: at least one local char, up to the '@'
+    while (i < n && (charClass(email[i]) & CC_LOCAL)) ++i;
+    if (i == 0 || i == n || email[i] != '@') return false;
+    size_t domainStart = ++i;
+
+    // Domain: only domain chars; the TLD is whatever follows the last dot
+    size_t lastDot = std::string::npos;
+    bool tldAlpha = false;
+    for (; i < n; ++i) {
+        unsigned char cls = charClass(email[i]);
+        if (!(cls & CC_DOMAIN)) return false;
+        if (email[i] == '.') {
+            lastDot = i;
+            tldAlpha = true;
+        } else if (!(cls & CC_ALPHA)) {
+            tldAlpha = false;
+        }
+    }
+
+    // Non-empty label before the last dot, 2+ letters after it
+    return lastDot != std::string::npos && lastDot > domainStart &&
+           tldAlpha && n - lastDot - 1 >= 2;
 }
 
 bool Validator::validatePhone(const std::string& phone) {
     // 07XXXXXXXX or +467XXXXXXXX
-    std::regex phonePattern(R"(^(07\d{8}|\+467\d{8})$)");
-    return std::regex_match(phone, phonePattern);
+    const char* p = phone.data();
+    if (phone.size() == 10) {
+        return p[0] == '0' && p[1] == '7' && eightDigits(p + 2);
+    }
+    if (phone.size() == 12) {
+        return p[0] == '+' && p[1] == '4' && p[2] == '6' && p[3] == '7' && eightDigits(p + 4);
+    }
+    return false;
+}
+
+std::vector<uint64_t> Validator::validateEmails(const std::vector<std::string>& emails) {
+    std::vector<uint64_t> mask((emails.size() + 63) / 64, 0);
+    for (size_t i = 0; i < emails.size(); ++i) {
+        if (emailWords(emails[i])) {
+            mask[i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
+    return mask;
+}
+
+std::vector<uint64_t> Validator::validatePhones(const std::vector<std::string>& phones) {
+    std::vector<uint64_t> mask((phones.size() + 63) / 64, 0);
+    for (size_t i = 0; i < phones.size(); ++i) {
+        if (validatePhone(phones[i])) {
+            mask[i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
+    return mask;
 }
 
 std::string Validator::generateEmail(const std::string& name) {
@@ -38,8 +215,8 @@ std::string Validator::generateEmail(const std::string& name) {
 }
 
 std::string Validator::generatePhone() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    // Seeded once per thread, not once per number
+    thread_local std::mt19937 gen(std::random_device{}());
     std::uniform_int_distribution<> dis(10000000, 99999999);
     return "07" + std::to_string(dis(gen));
 }